@@ -0,0 +1,388 @@
+#!/usr/bin/perl
+
+use strict;
+use warnings;
+use Getopt::Long qw(:config no_ignore_case);
+use Time::HiRes qw(time);
+use Cwd qw(getcwd);
+use lib ".";
+use Ci;
+
+my ($workdir,$golddir,$ranges,$backends,$update,$postprocess,$list,$help);
+my ($tolerance,$floor,$repeat,$sOptions);
+GetOptions(
+'n=s' => \$ranges,
+'b=s' => \$backends,
+'w=s' => \$workdir,
+'g=s' => \$golddir,
+'u' => \$update,
+'P' => \$postprocess,
+'t=f' => \$tolerance,
+'floor=f' => \$floor,
+'r=i' => \$repeat,
+'o=s' => \$sOptions,
+'l' => \$list,
+'h' => \$help) or die "$0: Error in command line args, run with -h to display help\n";
+
+if (defined($help)) {
+	print "USAGE: $0 [options]\n";
+	print "\tRuns the benchmarks listed in inputs/benchmarks.txt serially, ";
+	print "collects wall time and peak RSS,\n";
+	print "\tand compares them against the performance oracles\n";
+	print "\tA value Gap Class is the time between a line Class [t]: of the output\n";
+	print "\tand the timestamped line before it, that is, the time spent before\n";
+	print "\tClass printed, not necessarily the time spent in Class;\n";
+	print "\tGap values are recorded but not checked for regressions\n";
+	print "\tA benchmark without a result, for example because dmrg failed,\n";
+	print "\tcounts as a failure\n";
+	print "\t-n n\n";
+	print "\t\tRun only benchmarks for these tests. Same syntax as ci.pl -n\n";
+	print "\t-b backends\n";
+	print "\t\tRun only these backends, comma-separated, ";
+	print "out of OnTheFly,Stored,Kron,BatchedGemm\n";
+	print "\t-w workdir\n";
+	print "\t\tUse workdir as working directory not the default of benchmarks/\n";
+	print "\t-g golddir\n";
+	print "\t\tUse golddir for performance oracles instead of the ";
+	print "default of perfOracles/\n";
+	print "\t-u\n";
+	print "\t\tWrite (or overwrite) the performance oracles from this run\n";
+	print "\t-P\n";
+	print "\t\tDo not run; compare the results already in workdir\n";
+	print "\t-t tolerance\n";
+	print "\t\tRelative slowdown or memory growth reported as regression; ";
+	print "default is 0.1\n";
+	print "\t--floor seconds\n";
+	print "\t\tIgnore time differences smaller than seconds; default is 0.5\n";
+	print "\t-r repeat\n";
+	print "\t\tRun each benchmark repeat times and keep the fastest; default is 1\n";
+	print "\t-o options\n";
+	print "\t\tExtra SolverOptions passed to dmrg for all benchmarks\n";
+	print "\t-l\n";
+	print "\t\tList benchmarks and exit\n";
+	print Ci::helpFor("-h");
+	exit(0);
+}
+
+defined($workdir) or $workdir = "benchmarks";
+defined($golddir) or $golddir = "perfOracles";
+defined($update) or $update = 0;
+defined($postprocess) or $postprocess = 0;
+defined($tolerance) or $tolerance = 0.1;
+defined($floor) or $floor = 0.5;
+defined($repeat) or $repeat = 1;
+defined($sOptions) or $sOptions = "";
+
+# relative to where this script runs, not to workdir
+$golddir = getcwd()."/$golddir" unless ($golddir =~ /^\//);
+
+($tolerance >= 0) or die "$0: tolerance must be non-negative\n";
+($repeat > 0) or die "$0: repeat must be positive\n";
+
+my %backendOptions = (OnTheFly => "",
+                      Stored => "MatrixVectorStored",
+                      Kron => "MatrixVectorKron",
+                      BatchedGemm => "MatrixVectorKron,BatchedGemm");
+
+my @benchmarks = getBenchmarks("inputs/benchmarks.txt");
+my $total = 0;
+foreach my $b (@benchmarks) {
+	$total = $b->{"number"} if ($b->{"number"} > $total);
+}
+
+my %inRange = map { $_ => 1 } Ci::procRanges($ranges, $total);
+my %allowedBackends;
+if (defined($backends)) {
+	foreach my $backend (split(/,/, $backends)) {
+		exists($backendOptions{$backend}) or die "$0: Unknown backend $backend\n";
+		$allowedBackends{$backend} = 1;
+	}
+}
+
+@benchmarks = grep { !defined($ranges) or exists($inRange{$_->{"number"}}) } @benchmarks;
+@benchmarks = grep { !defined($backends) or exists($allowedBackends{$_->{"backend"}}) } @benchmarks;
+die "$0: No benchmarks selected\n" if (scalar(@benchmarks) == 0);
+
+if (defined($list)) {
+	foreach my $b (@benchmarks) {
+		print "|".$b->{"number"}."| ".$b->{"backend"}."\n";
+	}
+
+	exit(0);
+}
+
+if ($postprocess) {
+	chdir("$workdir/") or die "$0: Cannot change to $workdir: $!\n";
+} else {
+	prepareDir();
+}
+
+if ($update) {
+	if (!(-d "$golddir")) {
+		mkdir($golddir) or die "$0: Cannot create $golddir: $!\n";
+	}
+}
+
+my $regressions = 0;
+my $failures = 0;
+foreach my $b (@benchmarks) {
+	my $n = $b->{"number"};
+	my $backend = $b->{"backend"};
+	my $label = "|$n| $backend";
+	runBenchmark($n, $backend) unless ($postprocess);
+
+	my %newValues = readResult("bench${n}_$backend.txt");
+	if (!exists($newValues{"WallTime"})) {
+		print "$label: FAILED: No result found\n";
+		++$failures;
+		next;
+	}
+
+	my $oracle = "$golddir/bench${n}_$backend.txt";
+	if ($update) {
+		system("cp bench${n}_$backend.txt $oracle");
+		print "$label: $oracle written\n";
+		next;
+	}
+
+	my %oldValues = readResult($oracle);
+	if (!exists($oldValues{"WallTime"})) {
+		print "$label: No oracle found; run with -u to create it\n";
+		next;
+	}
+
+	$regressions += compareValues(\%newValues, \%oldValues, $label);
+}
+
+print "$0: $regressions regression(s) found\n" unless ($update);
+print "$0: $failures benchmark(s) without a result\n" if ($failures > 0);
+exit(($regressions > 0 or $failures > 0) ? 1 : 0);
+
+sub getBenchmarks
+{
+	my ($file) = @_;
+	my @a;
+	open(FILE, "<", "$file") or die "$0: Cannot open $file : $!\n";
+	while (<FILE>) {
+		next if (/^\#/ or /^[ \t]*$/);
+		chomp;
+		my @temp = split;
+		my $n = shift(@temp);
+		($n =~ /^[0-9]+$/ and scalar(@temp) > 0) or die "$0: $file: Line $_ not understood\n";
+		foreach my $backend (@temp) {
+			exists($backendOptions{$backend}) or die "$0: $file: Unknown backend $backend\n";
+			my %h = (number => $n, backend => $backend);
+			push @a, \%h;
+		}
+	}
+
+	close(FILE);
+	return @a;
+}
+
+sub runBenchmark
+{
+	my ($n, $backend) = @_;
+	my $input = "../inputs/input$n.inp";
+	(-r "$input") or die "$0: Cannot read $input\n";
+	my $options = backendOptionsFor($input, $backend);
+	$options .= ",$sOptions" if ($sOptions ne "");
+	$options = "-o $options" if ($options ne "");
+	my $timer = (-x "/usr/bin/time") ? "/usr/bin/time -o time$n.txt -f PeakRssKb=%M " : "";
+	my $cmd = "$timer./dmrg -f $input $options &> output$n.txt";
+	my $result = "bench${n}_$backend.txt";
+
+	# a failed run must not leave the result of an earlier one behind
+	unlink($result);
+
+	my %best;
+	for (my $i = 0; $i < $repeat; ++$i) {
+		print STDERR "$0: |$n| $backend: $cmd\n";
+		unlink("runForinput$n.cout");
+		my $start = time();
+		my $ret = system("bash", "-c", $cmd);
+		my $wallTime = time() - $start;
+		if ($ret != 0) {
+			print STDERR "$0: |$n| $backend: dmrg failed, see output$n.txt\n";
+			return;
+		}
+
+		my %values = procCout($n);
+		$values{"WallTime"} = sprintf("%.3f", $wallTime);
+		my $peak = peakRssFromTime("time$n.txt");
+		$values{"PeakRssKb"} = $peak if (defined($peak));
+		keepFastest(\%best, \%values);
+	}
+
+	writeResult($result, \%best, $n, $backend);
+}
+
+sub backendOptionsFor
+{
+	my ($input, $backend) = @_;
+	my $so = "";
+	open(FILE, "<", "$input") or die "$0: Cannot open $input : $!\n";
+	while (<FILE>) {
+		chomp;
+		if (/^SolverOptions=(.*$)/) {
+			$so = $1;
+			last;
+		}
+	}
+
+	close(FILE);
+	my $options = "";
+	foreach my $opt (split(/,/, $backendOptions{$backend})) {
+		next if ($so =~ /$opt/);
+		$options .= ",$opt";
+	}
+
+	return $options;
+}
+
+sub procCout
+{
+	my ($n) = @_;
+	my %values;
+	my $file = "runForinput$n.cout";
+	open(FILE, "<", "$file") or return %values;
+	my $prevTime = 0;
+	while (<FILE>) {
+		chomp;
+		if (/maximum was ([0-9\.]+) *([kKmMgG]?)/) {
+			$values{"PeakRssKb"} = toKb($1, $2);
+		}
+
+		if (/^([a-zA-Z0-9_:]+) \[([0-9\.]+)\]:/) {
+			my $class = $1;
+			my $t = $2;
+			$values{"Gap $class"} += $t - $prevTime;
+			$prevTime = $t;
+			next;
+		}
+
+		if (/DMRG\+\+ version (.*$)/) {
+			$values{"version"} = $1;
+			next;
+		}
+	}
+
+	close(FILE);
+	return %values;
+}
+
+sub toKb
+{
+	my ($value, $unit) = @_;
+	$unit = lc($unit);
+	return int($value/1024) if ($unit eq "");
+	return int($value*1024) if ($unit eq "m");
+	return int($value*1024*1024) if ($unit eq "g");
+	return int($value);
+}
+
+sub peakRssFromTime
+{
+	my ($file) = @_;
+	my $peak;
+	open(FILE, "<", "$file") or return $peak;
+	while (<FILE>) {
+		if (/^PeakRssKb=([0-9]+)/) {
+			$peak = $1;
+			last;
+		}
+	}
+
+	close(FILE);
+	unlink($file);
+	return $peak;
+}
+
+sub keepFastest
+{
+	my ($best, $values) = @_;
+	foreach my $key (keys %$values) {
+		if (!exists($best->{$key}) or $key eq "version") {
+			$best->{$key} = $values->{$key};
+			next;
+		}
+
+		$best->{$key} = $values->{$key} if ($values->{$key} < $best->{$key});
+	}
+}
+
+sub writeResult
+{
+	my ($file, $values, $n, $backend) = @_;
+	open(FOUT, ">", "$file") or die "$0: Cannot write to $file: $!\n";
+	print FOUT "#Benchmark test=$n backend=$backend\n";
+	foreach my $key (sort keys %$values) {
+		my $val = $values->{$key};
+		$val = sprintf("%.3f", $val) if ($key =~ /^Gap /);
+		print FOUT "$key=$val\n";
+	}
+
+	close(FOUT);
+}
+
+sub readResult
+{
+	my ($file) = @_;
+	my %values;
+	open(FILE, "<", "$file") or return %values;
+	while (<FILE>) {
+		next if (/^\#/);
+		chomp;
+		if (/^([^=]+)=(.*$)/) {
+			$values{$1} = $2;
+		}
+	}
+
+	close(FILE);
+	return %values;
+}
+
+sub compareValues
+{
+	my ($newValues, $oldValues, $label) = @_;
+	my $v1 = $newValues->{"version"};
+	my $v2 = $oldValues->{"version"};
+	defined($v1) or $v1 = "UNDEFINED";
+	defined($v2) or $v2 = "UNDEFINED";
+	print "$label: New Version $v1, Old Version $v2\n";
+
+	my $regressions = 0;
+	foreach my $key (sort keys %$oldValues) {
+		# a Gap includes whatever ran before its class printed
+		next if ($key eq "version" or $key =~ /^Gap /);
+		my $old = $oldValues->{$key};
+		my $new = $newValues->{$key};
+		if (!defined($new)) {
+			print "$label: $key missing in new run\n" if ($key !~ /^Phase /);
+			next;
+		}
+
+		my $isTime = ($key ne "PeakRssKb");
+		next if ($isTime and abs($new - $old) < $floor);
+		next if ($old <= 0);
+		my $ratio = ($new - $old)/$old;
+		my $percent = sprintf("%+.1f%%", 100*$ratio);
+		if ($ratio > $tolerance) {
+			print "$label: REGRESSION $key $old -> $new ($percent)\n";
+			++$regressions;
+		} elsif ($ratio < -$tolerance) {
+			print "$label: IMPROVEMENT $key $old -> $new ($percent)\n";
+		}
+	}
+
+	print "$label: OK\n" if ($regressions == 0);
+	return $regressions;
+}
+
+sub prepareDir
+{
+	my $b = (-r "$workdir");
+	system("mkdir $workdir") if (!$b);
+	system("cp -av ../src/dmrg $workdir/");
+	chdir("$workdir/");
+}
@@ -143,7 +143,18 @@ for (my $j = 0; $j < $rangesTotal; ++$j) {
 
 	my $whatDmrg = $ciAnnotations{"dmrg"};
 	my $extraCmdArgs = $sOptions."  ".findArguments($whatDmrg);
-	procTest($n,$valgrind,\%submit,$extraCmdArgs);
+	my $ranks = findMpiRanks($ciAnnotations{"mpi"}, $n);
+	procTest($n,$valgrind,\%submit,$extraCmdArgs,$ranks);
+}
+
+# #ci mpi ranks runs the test with mpirun on ranks processes of this host
+sub findMpiRanks
+{
+	my ($a, $n) = @_;
+	return 0 unless defined($a);
+	(scalar(@$a) == 1 and $a->[0] =~ /^([0-9]+)/ and $1 > 0) or
+		die "$0: #ci mpi annotation for test $n not understood\n";
+	return $1;
 }
 
 sub findArguments
@@ -347,10 +358,11 @@ sub isRestart
 
 sub procTest
 {
-	my ($n,$tool,$submit,$extraCmdArgs) = @_;
+	my ($n,$tool,$submit,$extraCmdArgs,$ranks) = @_;
 	my $valgrind = ($tool eq "") ? "" : "valgrind --tool=$tool ";
 	$valgrind .= " --callgrind-out-file=callgrind$n.out " if ($tool eq "callgrind");
-	my $cmd = "$valgrind./dmrg -f ../inputs/input$n.inp $extraCmdArgs &> output$n.txt";
+	my $mpirun = ($ranks > 0) ? "mpirun -np $ranks " : "";
+	my $cmd = "$mpirun$valgrind./dmrg -f ../inputs/input$n.inp $extraCmdArgs &> output$n.txt";
 	my $batch = createBatch($n, $cmd, $submit->{"PBS_O_WORKDIR"});
 	submitBatch($submit, $batch) if ($submit->{"command"} ne "");
 }
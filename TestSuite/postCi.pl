@@ -45,6 +45,13 @@ defined($noSu2) or $noSu2 = 0;
 defined($workdir) or $workdir = "tests";
 defined($golddir) or $golddir = "oldTests";
 
+# Largest difference allowed between an energy and its oracle
+my $energyTolerance = 1e-6;
+# Largest difference allowed between a time observable and its oracle
+my $timeObsTolerance = 1e-4;
+# Comparisons that went beyond their tolerance; if any, the exit status is 1
+my $failures = 0;
+
 my @tests = Ci::getTests("inputs/descriptions.txt");
 my %allowedTests = Ci::getAllowedTests(\@tests);
 my $total = $tests[$#tests]->{"number"};
@@ -75,10 +82,11 @@ for (my $j = 0; $j < $rangesTotal; ++$j) {
 		next;
         }
 
-	procTest($n,$workdir,$golddir);
-
 	my %ciAnnotations = Ci::getCiAnnotations("inputs/input$n.inp",$n);
 
+	my $m = oracleFor($n, \%ciAnnotations);
+	procTest($n,$workdir,$golddir,$m);
+
 	my @postProcessLabels = qw(getTimeObservablesInSitu getEnergyAncilla CollectBrakets metts observe);
 	my %actions = (getTimeObservablesInSitu => \&checkTimeInSituObs,
 	               getEnergyAncilla => \&checkEnergyAncillaInSitu,
@@ -90,19 +98,38 @@ for (my $j = 0; $j < $rangesTotal; ++$j) {
 		my $x = defined($w) ? scalar(@$w) : 0;
 		next if ($x == 0);
 		print "|$n| has $x $ppLabel lines\n";
-		$actions{$ppLabel}->($n, $w, $workdir, $golddir);
+		$actions{$ppLabel}->($n, $w, $workdir, $golddir, $m);
 	}
 
 	print "-----------------------------------------------\n";
 }
 
+if ($failures > 0) {
+	print "$0: $failures comparisons FAILED\n";
+	exit(1);
+}
+
+# Test whose oracle is used for test n;
+# #ci oracle m compares test n against the oracle of test m,
+# the cout and the files of all its postprocessing
+sub oracleFor
+{
+	my ($n, $ciAnnotations) = @_;
+	my $a = $ciAnnotations->{"oracle"};
+	return $n unless defined($a);
+	(scalar(@$a) == 1 and $a->[0] =~ /^([0-9]+)/) or
+		die "$0: #ci oracle annotation for test $n not understood\n";
+	print "|$n|: Oracle is that of test $1\n";
+	return $1;
+}
+
 sub procTest
 {
-	my ($n,$workdir,$golddir) = @_;
+	my ($n,$workdir,$golddir,$m) = @_;
 	my %newValues;
 	my %oldValues;
 	procCout(\%newValues, $n,$workdir);
-	procCout(\%oldValues, $n, $golddir);
+	procCout(\%oldValues, $m, $golddir);
 	compareValues(\%newValues, \%oldValues, $n);
 	procMemcheck($n);
 }
@@ -146,25 +173,30 @@ sub compareValues
 	defined($v1) or $v1 = "UNDEFINED";
 	defined($v2) or $v2 = "UNDEFINED";
 	print "|$n|: New Version $v1, Old Version $v2\n";
-	my $maxEdiff = maxEnergyDiff($newValues->{"energies"}, $oldValues->{"energies"});
+	my ($maxEdiff, $ok) = maxEnergyDiff($newValues->{"energies"}, $oldValues->{"energies"});
 	print "|$n|: MaxEnergyDiff = $maxEdiff\n";
+	return if ($ok);
+	print "|$n|: FAILED energies, tolerance $energyTolerance\n";
+	++$failures;
 }
 
+# Returns the maximum difference, or what prevented computing it,
+# and whether it is within the tolerance
 sub maxEnergyDiff
 {
 	my ($eNew, $eOld) = @_;
-	return "NEW ENERGIES UNDEFINED" if (!defined($eNew));
-	return "OLD ENERGIES UNDEFINED" if (!defined($eOld));
+	return ("NEW ENERGIES UNDEFINED", 0) if (!defined($eNew));
+	return ("OLD ENERGIES UNDEFINED", 0) if (!defined($eOld));
 	my $n = scalar(@$eNew);
-	return "ENERGY SIZES DIFFERENT" if (scalar(@$eOld) != $n);
-	return "NO ENERGIES!" if ($n == 0);
+	return ("ENERGY SIZES DIFFERENT", 0) if (scalar(@$eOld) != $n);
+	return ("NO ENERGIES!", 0) if ($n == 0);
 	my $maxEdiff = 0;
 	for (my $i = 0; $i < $n; ++$i) {
 		my $tmp = abs($eNew->[$i] - $eOld->[$i]);
 		$maxEdiff = $tmp if ($tmp > $maxEdiff);
  	}
 
-	return "$maxEdiff [out of $n]";
+	return ("$maxEdiff [out of $n]", ($maxEdiff <= $energyTolerance));
 }
 
 
@@ -220,6 +252,7 @@ sub procMemcheck
 
 	if ($mode eq "FATAL" || $mode eq "throw") {
 		print "$0: ATTENTION TEST $n couldn't run because of $extra\n";
+		++$failures;
 		return;
 	}
 	
@@ -245,7 +278,7 @@ sub fileSize
 
 sub checkEnergyAncillaInSitu
 {
-	my ($n, $what, $workdir, $golddir) = @_;
+	my ($n, $what, $workdir, $golddir, $m) = @_;
 	my $whatN = scalar(@$what);
 	for (my $i = 0; $i < $whatN; ++$i) {
 		my $file = "runForinput$n.cout";
@@ -254,7 +287,7 @@ sub checkEnergyAncillaInSitu
 		}
 
 		my $file1 = "$workdir/energyAncillaInSitu${n}_$i.txt";
-		my $file2 = "$golddir/energyAncillaInSitu${n}_$i.txt";
+		my $file2 = "$golddir/energyAncillaInSitu${m}_$i.txt";
 		print "Comparing $file1 $file2\n";
 		my %vals1 = Metts::load($file1);
 		my %vals2 = Metts::load($file2);
@@ -264,7 +297,7 @@ sub checkEnergyAncillaInSitu
 
 sub checkTimeInSituObs
 {
-	my ($n, $what, $workdir, $golddir) = @_;
+	my ($n, $what, $workdir, $golddir, $m) = @_;
 	my $whatN = scalar(@$what);
 	for (my $i = 0; $i < $whatN; ++$i) {
 		my $file = "runForinput$n.cout";
@@ -273,7 +306,7 @@ sub checkTimeInSituObs
 		}
 
 		my $file1 = "$workdir/timeObservablesInSitu${n}_$i.txt";
-		my $file2 = "$golddir/timeObservablesInSitu${n}_$i.txt";
+		my $file2 = "$golddir/timeObservablesInSitu${m}_$i.txt";
 		print "Comparing $file1 $file2\n";
 		my %m1 = timeObservablesInSitu::load($file1);
 		my %m2 = timeObservablesInSitu::load($file2);
@@ -294,16 +327,57 @@ sub checkTimeInSituObs
 			next;
 		}
 
-		print "\tChecking times...\n";
-		checkVectorsEqual($m1{"times"}, $m2{"times"});
+		compareAtCommonTimes(\%m1, \%m2, $n);
+	}
+}
 
-		compareMatrices($m1{"data"}, $m2{"data"});
+# Compares two time observables at the times they share, which are all
+# of them unless one run took other time steps, as an adaptive one does.
+# A time measured more than once is compared by its last measurement
+sub compareAtCommonTimes
+{
+	my ($m1, $m2, $n) = @_;
+	my %rows1 = rowOfTime($m1->{"times"});
+	my %rows2 = rowOfTime($m2->{"times"});
+	my $d1 = $m1->{"data"};
+	my $d2 = $m2->{"data"};
+	my $cols = $d1->[1];
+	my $common = 0;
+	my $max = 0;
+	foreach my $t (keys %rows1) {
+		my $j = $rows2{"$t"};
+		next unless (defined($j));
+		my $i = $rows1{"$t"};
+		++$common;
+		for (my $c = 0; $c < $cols; ++$c) {
+			my $val = abs($d1->[2 + $i + $c*$d1->[0]] - $d2->[2 + $j + $c*$d2->[0]]);
+			$max = $val if ($max < $val);
+		}
 	}
+
+	print "\t$common common times, maximum difference= $max\n";
+	return if ($common > 0 and $max <= $timeObsTolerance);
+	print "|$n|: FAILED time observables, tolerance $timeObsTolerance\n";
+	++$failures;
+}
+
+# Last row of each time, with times rounded so that equal times match
+sub rowOfTime
+{
+	my ($times) = @_;
+	my %h;
+	my $n = scalar(@$times);
+	for (my $i = 0; $i < $n; ++$i) {
+		my $t = sprintf("%.6f", $times->[$i]);
+		$h{"$t"} = $i;
+	}
+
+	return %h;
 }
 
 sub checkCollectBrakets
 {
-	my ($n, $what, $workdir, $golddir) = @_;
+	my ($n, $what, $workdir, $golddir, $m) = @_;
 	my $whatN = scalar(@$what);
 	for (my $i = 0; $i < $whatN; ++$i) {
 		my $file = "runForinput$n.cout";
@@ -312,36 +386,18 @@ sub checkCollectBrakets
 		}
 
 		my $file1 = "$workdir/CollectBrakets${n}_$i.txt";
-		my $file2 = "$golddir/CollectBrakets${n}_$i.txt";
+		my $file2 = "$golddir/CollectBrakets${m}_$i.txt";
 		print "WARNING unimplemented: Comparing $file1 against $file2\n";
 	}
 }
 
-sub checkVectorsEqual
-{
-	my ($a, $b) = @_;
-	my $n = scalar(@$a);
-	if ($n != scalar(@$b)) {
-		print "\t\tSIZES NOT EQUAL\n";
-		return 0;
-	}
-
-	my $max = 0;
-	for (my $i = 0; $i < $n; ++$i) {
-		$_ = abs($a->[$i] - $b->[$i]);
-		$max = $_ if ($max < $_);
-	}
-
-	print "\t\tMax diff=$max\n";
-}
-
 sub checkMetts
 {
-	my ($n,$what,$workdir, $golddir) = @_;
+	my ($n,$what,$workdir, $golddir, $m) = @_;
 	my $whatN = scalar(@$what);
 	for (my $i = 0; $i < $whatN; ++$i) {
 		my $file1 = "$workdir/metts${n}_$i.txt";
-		my $file2 = "$golddir/metts${n}_$i.txt";
+		my $file2 = "$golddir/metts${m}_$i.txt";
 		my %vals1 = Metts::load($file1);
 		my %vals2 = Metts::load($file2);
 		compareHashes(\%vals1, \%vals2);
@@ -350,9 +406,9 @@ sub checkMetts
 
 sub checkObserve
 {
-	my ($n, $ignored, $workdir, $golddir) = @_;
+	my ($n, $ignored, $workdir, $golddir, $m) = @_;
 	my $file1 = "$workdir/observe$n.txt";
-	my $file2 = "$golddir/observe$n.txt";
+	my $file2 = "$golddir/observe$m.txt";
 	print "$0: Checking $file1 against $file2\n";
 	my @m1 = loadObserveData($file1);
 	my @m2 = loadObserveData($file2);
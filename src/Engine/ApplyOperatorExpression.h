@@ -76,6 +76,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "TimeVectorsKrylov.h"
 #include "TimeVectorsRungeKutta.h"
 #include "TimeVectorsSuzukiTrotter.h"
+#include "TimeVectorsTdvp.h"
 
 namespace Dmrg {
 
@@ -100,6 +101,8 @@ class ApplyOperatorExpression {
 	LanczosSolverType,VectorWithOffsetType> TimeVectorsRungeKuttaType;
 	typedef TimeVectorsSuzukiTrotter<TargetParamsType,ModelType,WaveFunctionTransfType,
 	LanczosSolverType,VectorWithOffsetType> TimeVectorsSuzukiTrotterType;
+	typedef TimeVectorsTdvp<TargetParamsType,ModelType,WaveFunctionTransfType,
+	LanczosSolverType,VectorWithOffsetType> TimeVectorsTdvpType;
 	typedef typename ModelType::InputValidatorType InputValidatorType;
 
 	static SizeType const PRODUCT = TargetParamsType::PRODUCT;
@@ -123,6 +126,8 @@ public:
 	      E0_(0.0),
 	      currentTime_(0.0),
 	      indexNoAdvance_(indexNoAdvance),
+	      timesWithoutAdvancement_(0),
+	      firstSeeLeftCorner_(false),
 	      applyOpLocal_(targetHelper.lrs()),
 	      targetVectors_(0),
 	      timeVectorsBase_(0)
@@ -310,6 +315,18 @@ public:
 			                                                    lrs,
 			                                                    E0_);
 			break;
+		case TargetParamsType::TDVP:
+			timeVectorsBase_ = new TimeVectorsTdvpType(currentTime_,
+			                                           tstStruct,
+			                                           times,
+			                                           targetVectors_,
+			                                           model,
+			                                           wft,
+			                                           lrs,
+			                                           E0_,
+			                                           ioIn,
+			                                           firstSeeLeftCorner_);
+			break;
 		default:
 			throw PsimagLite::RuntimeError(s.c_str());
 		}
@@ -322,6 +339,11 @@ public:
 
 	void timeHasAdvanced() { timeVectorsBase_->timeHasAdvanced(); }
 
+	RealType timeVectorsErrorEstimate() const
+	{
+		return timeVectorsBase_->errorEstimate();
+	}
+
 	template<typename SomeSerializerType>
 	void loadTargetVectors(SomeSerializerType& serializer)
 	{
@@ -470,8 +492,6 @@ private:
 	                SizeType loopNumber,
 	                SizeType lastI)
 	{
-		static SizeType timesWithoutAdvancement = 0;
-		static bool firstSeeLeftCorner = false;
 		SizeType advanceEach = targetHelper_.tstStruct().advanceEach();
 
 		if (direction == ProgramGlobals::INFINITE) {
@@ -503,24 +523,24 @@ private:
 		bool weAreAtBorder = (site < 2 || site >= sites-2);
 		bool dontAdvance = (advanceOnlyAtBorder & !weAreAtBorder);
 
-		if (advanceEach > 0 && timesWithoutAdvancement >= advanceEach && !dontAdvance) {
+		if (advanceEach > 0 && timesWithoutAdvancement_ >= advanceEach && !dontAdvance) {
 			stage_[i] = WFT_ADVANCE;
 			if (i==lastI) {
 				currentTime_ += targetHelper_.tstStruct().tau();
-				timesWithoutAdvancement=1;
+				timesWithoutAdvancement_=1;
 			}
 		} else {
-			if (i==lastI && stage_[i]==WFT_NOADVANCE && firstSeeLeftCorner)
-				timesWithoutAdvancement++;
+			if (i==lastI && stage_[i]==WFT_NOADVANCE && firstSeeLeftCorner_)
+				timesWithoutAdvancement_++;
 		}
 
-		if (!firstSeeLeftCorner && i==lastI && stage_[i]==WFT_NOADVANCE && site==1)
-			firstSeeLeftCorner=true;
+		if (!firstSeeLeftCorner_ && i==lastI && stage_[i]==WFT_NOADVANCE && site==1)
+			firstSeeLeftCorner_=true;
 
 		PsimagLite::OstringStream msg2;
-		msg2<<"Steps without advance: "<<timesWithoutAdvancement;
+		msg2<<"Steps without advance: "<<timesWithoutAdvancement_;
 		msg2<<" site="<<site<<" currenTime="<<currentTime_;
-		if (timesWithoutAdvancement>0) progress_.printline(msg2,std::cout);
+		if (timesWithoutAdvancement_>0) progress_.printline(msg2,std::cout);
 
 		PsimagLite::OstringStream msg;
 		msg<<"Evolving, stage="<<getStage(i);
@@ -612,6 +632,8 @@ private:
 	RealType E0_;
 	RealType currentTime_;
 	SizeType indexNoAdvance_;
+	SizeType timesWithoutAdvancement_;
+	bool firstSeeLeftCorner_;
 	ApplyOperatorType applyOpLocal_;
 	VectorWithOffsetType psi_;
 	typename PsimagLite::Vector<VectorWithOffsetType>::Type targetVectors_;
@@ -85,6 +85,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "ProgressIndicator.h"
 #include "TarPack.h"
 #include "IoSimple.h"
+#include "BinaryStore.h"
 
 namespace Dmrg {
 
@@ -104,6 +105,8 @@ public:
 		files_.push_back(filename);
 		PsimagLite::String rootname = parameters.filename;
 		appendToList(files_,rootname);
+		if (parameters.options.find("binaryData") != PsimagLite::String::npos)
+			files_.push_back(BinaryStore::filename(rootname));
 		if (!addExtra && extra != "" && extra != "-")
 			files_.push_back(extra);
 	}
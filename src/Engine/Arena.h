@@ -0,0 +1,297 @@
+/*
+Copyright (c) 2009-2018, UT-Battelle, LLC
+All rights reserved
+
+[DMRG++, Version 3.0]
+[by G.A., Oak Ridge National Laboratory]
+
+UT Battelle Open Source Software License 11242008
+
+OPEN SOURCE LICENSE
+
+Subject to the conditions of this License, each
+contributor to this software hereby grants, free of
+charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), a
+perpetual, worldwide, non-exclusive, no-charge,
+royalty-free, irrevocable copyright license to use, copy,
+modify, merge, publish, distribute, and/or sublicense
+copies of the Software.
+
+1. Redistributions of Software must retain the above
+copyright and license notices, this list of conditions,
+and the following disclaimer.  Changes or modifications
+to, or derivative works of, the Software should be noted
+with comments and the contributor and organization's
+name.
+
+2. Neither the names of UT-Battelle, LLC or the
+Department of Energy nor the names of the Software
+contributors may be used to endorse or promote products
+derived from this software without specific prior written
+permission of UT-Battelle.
+
+3. The software and the end-user documentation included
+with the redistribution, with or without modification,
+must include the following acknowledgment:
+
+"This product includes software produced by UT-Battelle,
+LLC under Contract No. DE-AC05-00OR22725  with the
+Department of Energy."
+
+*********************************************************
+DISCLAIMER
+
+THE SOFTWARE IS SUPPLIED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER, CONTRIBUTORS, UNITED STATES GOVERNMENT,
+OR THE UNITED STATES DEPARTMENT OF ENERGY BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+NEITHER THE UNITED STATES GOVERNMENT, NOR THE UNITED
+STATES DEPARTMENT OF ENERGY, NOR THE COPYRIGHT OWNER, NOR
+ANY OF THEIR EMPLOYEES, REPRESENTS THAT THE USE OF ANY
+INFORMATION, DATA, APPARATUS, PRODUCT, OR PROCESS
+DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
+
+*********************************************************
+*/
+/** \ingroup DMRG */
+/*@{*/
+
+/*! \file Arena.h
+ *
+ *  Per-thread pools of vectors for the temporaries of matrix-vector
+ *  products
+ *
+ *  An Arena<T>::Buffer takes a vector from the free list of its thread,
+ *  or allocates one if the list is empty, and returns it on destruction,
+ *  which must happen on the same thread.
+ *  Temporaries of one Lanczos iteration are thus reused in the next one
+ *  without going back to malloc. The contents of a buffer are whatever
+ *  its previous user left there, callers that accumulate must zero it.
+ *
+ *  The free lists are kept per OS thread, not per threadNum of the
+ *  parallel loop, because a loop that falls back to serial runs with
+ *  threadNum 0 on whichever thread submitted it.
+ *
+ *  The pools live for one DMRG step: ArenaStep::next() is called at the
+ *  end of each step, and each thread frees its stale buffers the next
+ *  time it takes one.
+ *
+ */
+#ifndef DMRG_ARENA_H
+#define DMRG_ARENA_H
+
+#include "Vector.h"
+#include "Concurrency.h"
+#ifdef USE_PTHREADS
+#include <pthread.h>
+#endif
+
+namespace Dmrg {
+
+class ArenaStep {
+
+public:
+
+	static SizeType current() { return counter(); }
+
+	// must be called outside of threaded regions
+	static void next() { ++counter(); }
+
+private:
+
+	static SizeType& counter()
+	{
+		static SizeType counter = 0;
+		return counter;
+	}
+}; // class ArenaStep
+
+template<typename T>
+class Arena {
+
+public:
+
+	typedef typename PsimagLite::Vector<T>::Type VectorType;
+
+	class Buffer {
+
+	public:
+
+		explicit Buffer(SizeType n)
+		    : v_(Arena::acquire())
+		{
+			v_->resize(n);
+		}
+
+		~Buffer()
+		{
+			Arena::giveBack(v_);
+		}
+
+		VectorType& operator()() { return *v_; }
+
+		const VectorType& operator()() const { return *v_; }
+
+	private:
+
+		Buffer(const Buffer&);
+
+		Buffer& operator=(const Buffer&);
+
+		VectorType* v_;
+	}; // class Buffer
+
+private:
+
+	typedef typename PsimagLite::Vector<VectorType*>::Type VectorVectorPtrType;
+
+	struct FreeList {
+
+		FreeList() : step(0) {}
+
+		void release()
+		{
+			for (SizeType i = 0; i < free.size(); ++i)
+				delete free[i];
+			free.clear();
+		}
+
+		VectorVectorPtrType free;
+		SizeType step;
+	};
+
+#ifdef USE_PTHREADS
+	// The free list of each thread is created by the thread on its first
+	// buffer, and freed when the thread exits; those of the threads still
+	// running at program exit are freed then
+	class FreeLists {
+
+		struct Mine {
+			FreeLists* owner;
+			FreeList list;
+		};
+
+		static void destroy(void* p)
+		{
+			Mine* mine = static_cast<Mine*>(p);
+			mine->owner->forget(mine);
+		}
+
+	public:
+
+		FreeLists()
+		{
+			pthread_mutex_init(&mutex_, 0);
+			pthread_key_create(&key_, destroy);
+		}
+
+		~FreeLists()
+		{
+			pthread_key_delete(key_);
+			for (SizeType i = 0; i < all_.size(); ++i) {
+				all_[i]->list.release();
+				delete all_[i];
+			}
+
+			pthread_mutex_destroy(&mutex_);
+		}
+
+		FreeList& mine()
+		{
+			Mine* mine = static_cast<Mine*>(pthread_getspecific(key_));
+			if (mine) return mine->list;
+
+			mine = new Mine();
+			mine->owner = this;
+			pthread_mutex_lock(&mutex_);
+			all_.push_back(mine);
+			pthread_mutex_unlock(&mutex_);
+			pthread_setspecific(key_, mine);
+			return mine->list;
+		}
+
+	private:
+
+		void forget(Mine* mine)
+		{
+			pthread_mutex_lock(&mutex_);
+			for (SizeType i = 0; i < all_.size(); ++i) {
+				if (all_[i] != mine) continue;
+				all_[i] = all_.back();
+				all_.pop_back();
+				break;
+			}
+
+			pthread_mutex_unlock(&mutex_);
+			mine->list.release();
+			delete mine;
+		}
+
+		pthread_key_t key_;
+		pthread_mutex_t mutex_;
+		typename PsimagLite::Vector<Mine*>::Type all_;
+	};
+#else
+	class FreeLists {
+
+	public:
+
+		~FreeLists() { list_.release(); }
+
+		FreeList& mine() { return list_; }
+
+	private:
+
+		FreeList list_;
+	};
+#endif
+
+	static FreeList& myFreeList()
+	{
+		static FreeLists freeLists;
+		return freeLists.mine();
+	}
+
+	static VectorType* acquire()
+	{
+		FreeList& list = myFreeList();
+		if (list.step != ArenaStep::current()) {
+			list.release();
+			list.step = ArenaStep::current();
+		}
+
+		if (list.free.size() == 0) return new VectorType();
+
+		VectorType* v = list.free.back();
+		list.free.pop_back();
+		return v;
+	}
+
+	static void giveBack(VectorType* v)
+	{
+		FreeList& list = myFreeList();
+		if (list.step != ArenaStep::current()) {
+			delete v;
+			return;
+		}
+
+		list.free.push_back(v);
+	}
+}; // class Arena
+} // namespace Dmrg
+/*@}*/
+#endif // DMRG_ARENA_H
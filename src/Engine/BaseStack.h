@@ -1,7 +1,11 @@
 #ifndef BASESTACK_H
 #define BASESTACK_H
 #include "DiskStack.h"
+#include "LazyDiskStack.h"
 #include <errno.h>
+#ifdef USE_PTHREADS
+#include <pthread.h>
+#endif
 
 namespace Dmrg {
 
@@ -9,10 +13,135 @@ template<typename DataType>
 class BaseStack {
 
 	typedef DiskStack<DataType> DiskStackType;
+	typedef LazyDiskStack<DataType> LazyDiskStackType;
 	typedef PsimagLite::Vector<PsimagLite::String>::Type VectorStringType;
 
+	// An entry of a stack in memory. Copies of the stack share it, and
+	// fromTop() gives the stack a copy of its own before it is changed;
+	// the count is changed under a lock, since a Recovery snapshot drops
+	// its copies from another thread
+	class Entry {
+
+		struct Node {
+
+			Node(const DataType& d) : data(d), count(1) {}
+
+			DataType data;
+			SizeType count;
+		};
+
+	public:
+
+		explicit Entry(const DataType& d) : node_(new Node(d)) {}
+
+		Entry(const Entry& other) : node_(other.node_) { share(node_); }
+
+		Entry& operator=(const Entry& other)
+		{
+			share(other.node_);
+			drop(node_);
+			node_ = other.node_;
+			return *this;
+		}
+
+		~Entry() { drop(node_); }
+
+		const DataType& operator*() const { return node_->data; }
+
+		DataType& unshared()
+		{
+			lock(true);
+			bool shared = (node_->count > 1);
+			lock(false);
+			if (shared) {
+				Node* mine = new Node(node_->data);
+				drop(node_);
+				node_ = mine;
+			}
+
+			return node_->data;
+		}
+
+		friend std::ostream& operator<<(std::ostream& os, const Entry& e)
+		{
+			return os<<(*e);
+		}
+
+	private:
+
+		static void share(Node* node)
+		{
+			lock(true);
+			++node->count;
+			lock(false);
+		}
+
+		static void drop(Node* node)
+		{
+			lock(true);
+			bool last = (--node->count == 0);
+			lock(false);
+			if (last) delete node;
+		}
+
+		static void lock(bool flag)
+		{
+#ifdef USE_PTHREADS
+			static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+			if (flag) pthread_mutex_lock(&mutex);
+			else pthread_mutex_unlock(&mutex);
+#endif
+		}
+
+		Node* node_;
+	};
+
+	typedef typename PsimagLite::Stack<Entry>::Type StackType;
+	typedef typename PsimagLite::Vector<Entry>::Type VectorEntryType;
+
 public:
 
+	// The n entries at the top of a stack as they were when taken, the
+	// bottom one first. Those in memory are shared with the stack, those
+	// still on disk are read one at a time when asked for
+	class View {
+
+	public:
+
+		View() : lazyCount_(0), lazy_(0) {}
+
+		~View() { clear(); }
+
+		SizeType size() const { return lazyCount_ + entries_.size(); }
+
+		const DataType& operator[](SizeType i) const
+		{
+			assert(i < size());
+			if (i >= lazyCount_) return *entries_[i - lazyCount_];
+			return lazy_->fromTop(lazyCount_ - 1 - i);
+		}
+
+		void clear()
+		{
+			VectorEntryType().swap(entries_);
+			delete lazy_;
+			lazy_ = 0;
+			lazyCount_ = 0;
+		}
+
+	private:
+
+		View(const View&);
+
+		View& operator=(const View&);
+
+		SizeType lazyCount_;
+		LazyDiskStackType* lazy_;
+		VectorEntryType entries_;
+
+		friend class BaseStack;
+	};
+
 	BaseStack(bool disk)
 	    : m_(!disk), diskStack_(0)
 	{
@@ -23,7 +152,7 @@ public:
 	}
 
 	BaseStack(const BaseStack& other)
-	    : m_(other.m_), diskStack_(0)
+	    : m_(other.m_), diskStack_(0), lazy_(other.lazy_)
 	{
 		if (m_) {
 			stack_ = other.stack_;
@@ -50,31 +179,72 @@ public:
 	void push(const DataType& d)
 	{
 		check();
-		return (m_) ? stack_.push(d) : diskStack_->push(d);
+		return (m_) ? stack_.push(Entry(d)) : diskStack_->push(d);
 	}
 
 	void pop()
 	{
 		check();
-		return (m_) ? stack_.pop() : diskStack_->pop();
+		if (!m_) return diskStack_->pop();
+		return (stack_.size() > 0) ? stack_.pop() : lazy_.pop();
 	}
 
 	const DataType& top() const
 	{
 		check();
-		return (m_) ? stack_.top() : diskStack_->top();
+		if (!m_) return diskStack_->top();
+		return (stack_.size() > 0) ? *stack_.top() : lazy_.top();
 	}
 
 	SizeType size() const
 	{
 		check();
-		return (m_) ? stack_.size() : diskStack_->size();
+		return (m_) ? stack_.size() + lazy_.size() : diskStack_->size();
+	}
+
+	// The entry depth entries below the top, or 0 if it is not held
+	// in memory by this stack; it is no longer shared with any copy
+	DataType* fromTop(SizeType depth)
+	{
+		if (!m_ || depth >= stack_.size()) return 0;
+		typename StackType::container_type& c = ContainerOf::get(stack_);
+		return &c[c.size() - 1 - depth].unshared();
+	}
+
+	// The stack is left as it was, see View
+	void topView(View& view, SizeType n) const
+	{
+		check();
+		if (!m_ || n > size())
+			err("BaseStack::topView(): only for stacks in memory and n <= size\n");
+
+		view.clear();
+		const typename StackType::container_type& c =
+		        ContainerOf::get(const_cast<StackType&>(stack_));
+		SizeType fromMemory = (n < c.size()) ? n : c.size();
+		view.entries_.assign(c.end() - fromMemory, c.end());
+		view.lazyCount_ = n - fromMemory;
+		if (view.lazyCount_ > 0) view.lazy_ = new LazyDiskStackType(lazy_);
+	}
+
+	// Puts the entries of disk below those in memory, each is read
+	// from disk only when it reaches the top; disk is left empty
+	void loadLazily(DiskStackType& disk)
+	{
+		if (!m_ || stack_.size() > 0 || lazy_.size() > 0)
+			err("BaseStack::loadLazily(): only into an empty stack in memory\n");
+
+		lazy_.load(disk);
+		while (disk.size() > 0) disk.pop();
 	}
 
 	bool inDisk() const { return !m_; }
 
 	void save(PsimagLite::IoSimple::Out& io, PsimagLite::String label) const
 	{
+		if (lazy_.size() > 0)
+			err("BaseStack::save(): entries still on disk\n");
+
 		if (m_) {
 			io.print(label, stack_);
 			return;
@@ -86,7 +256,15 @@ public:
 	void load(PsimagLite::IoSimple::In& io, PsimagLite::String label)
 	{
 		if (m_) {
-			io.read(stack_, label);
+			typename PsimagLite::Stack<DataType>::Type st;
+			io.read(st, label);
+			VectorEntryType entries;
+			for (; !st.empty(); st.pop())
+				entries.push_back(Entry(st.top()));
+
+			while (!stack_.empty()) stack_.pop();
+			for (SizeType i = entries.size(); i > 0; --i)
+				stack_.push(entries[i - 1]);
 			return;
 		}
 
@@ -95,6 +273,15 @@ public:
 
 private:
 
+	// std::stack keeps its container protected
+	struct ContainerOf : public StackType {
+
+		static typename StackType::container_type& get(StackType& st)
+		{
+			return st.*(&ContainerOf::c);
+		}
+	};
+
 	void check() const
 	{
 		if (m_) return;
@@ -127,8 +314,9 @@ private:
 	BaseStack& operator=(const BaseStack&);
 
 	bool m_;
-	typename PsimagLite::Stack<DataType>::Type stack_;
+	StackType stack_;
 	DiskStackType* diskStack_;
+	LazyDiskStackType lazy_;
 	VectorStringType files_;
 };
 }
@@ -179,54 +179,25 @@ public:
 		// reorder the basis
 		parent.setToProduct(basis2,basis3);
 
-		typename PsimagLite::Vector<RealType>::Type fermionicSigns;
 		SizeType x = basis2.numberOfOperators()+basis3.numberOfOperators();
 
 		if (this->useSu2Symmetry()) setMomentumOfOperators(basis2);
 		operators_.setToProduct(basis2,basis3,x,this);
 		ApplyFactors<FactorsType> apply(this->getFactors(),this->useSu2Symmetry());
-		int savedSign = 0;
-
-		for (SizeType i=0;i<this->numberOfOperators();i++) {
-			if (i<basis2.numberOfOperators()) {
-				if (!this->useSu2Symmetry()) {
-					const OperatorType& myOp =  basis2.getOperatorByIndex(i);
-					if (savedSign != myOp.fermionSign) {
-						utils::fillFermionicSigns(fermionicSigns,
-						                          basis2.electronsVector(BaseType::AFTER_TRANSFORM),
-						                          myOp.fermionSign);
-						savedSign = myOp.fermionSign;
-					}
-					operators_.externalProduct(i,
-					                           myOp,
-					                           basis3.size(),
-					                           fermionicSigns,
-					                           true,
-					                           apply);
-				} else {
+
+		if (!this->useSu2Symmetry()) {
+			operators_.externalProduct(basis2,
+			                           basis3,
+			                           basis2.electronsVector(BaseType::AFTER_TRANSFORM),
+			                           apply);
+		} else {
+			for (SizeType i=0;i<this->numberOfOperators();i++) {
+				if (i<basis2.numberOfOperators()) {
 					operators_.externalProductReduced(i,
 					                                  basis2,
 					                                  basis3,
 					                                  true,
 					                                  basis2.getReducedOperatorByIndex(i));
-				}
-			} else {
-				if (!this->useSu2Symmetry()) {
-					const OperatorType& myOp = basis3.
-					        getOperatorByIndex(i - basis2.numberOfOperators());
-
-					if (savedSign != myOp.fermionSign) {
-						utils::fillFermionicSigns(fermionicSigns,
-						                          basis2.electronsVector(BaseType::AFTER_TRANSFORM),
-						                          myOp.fermionSign);
-						savedSign = myOp.fermionSign;
-					}
-					operators_.externalProduct(i,
-					                           myOp,
-					                           basis2.size(),
-					                           fermionicSigns,
-					                           false,
-					                           apply);
 				} else {
 					operators_.externalProductReduced(i,
 					                                  basis2,
@@ -333,6 +304,34 @@ public:
 
 	SizeType numberOfOperators() const { return operators_.numberOfOperators(); }
 
+	// Operators are owned by the rank of their site, block()[i] % ranks.
+	// Clears the operators of this block that this rank does not own
+	void keepOwnedOperators()
+	{
+		VectorIntegerType owner;
+		operatorOwners(owner);
+		SizeType rank = PsimagLite::MPI::commRank(PsimagLite::MPI::COMM_WORLD);
+		operators_.keepOwned(owner,rank);
+	}
+
+	// Collective: restores on every rank all operators of this block
+	void fetchOperators()
+	{
+		VectorIntegerType owner;
+		operatorOwners(owner);
+		operators_.fetchOwned(owner);
+	}
+
+	// For blocks kept in a stack far from the top, see Operators::compress
+	void compressOperators(bool valuesAsFloat)
+	{
+		operators_.compress(valuesAsFloat);
+	}
+
+	void decompressOperators() { operators_.decompress(); }
+
+	bool operatorsCompressed() const { return operators_.isCompressed(); }
+
 	SizeType operatorsPerSite(SizeType i) const
 	{
 		assert(i < operatorsPerSite_.size());
@@ -390,6 +389,19 @@ private:
 		}
 		operators_.setMomentumOfOperators(momentum);
 	}
+
+	void operatorOwners(VectorIntegerType& owner) const
+	{
+		SizeType nranks = PsimagLite::MPI::commSize(PsimagLite::MPI::COMM_WORLD);
+		const BlockType& block = this->block();
+		assert(block.size() == operatorsPerSite_.size());
+		owner.clear();
+		for (SizeType i = 0; i < operatorsPerSite_.size(); ++i)
+			for (SizeType sigma = 0; sigma < operatorsPerSite_[i]; ++sigma)
+				owner.push_back(block[i] % nranks);
+
+		assert(owner.size() == numberOfOperators());
+	}
 }; // class BasisWithOperators
 
 template<typename OperatorsType>
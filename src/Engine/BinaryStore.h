@@ -0,0 +1,717 @@
+/*
+Copyright (c) 2009-2018, UT-Battelle, LLC
+All rights reserved
+
+[DMRG++, Version 3.0]
+[by G.A., Oak Ridge National Laboratory]
+
+UT Battelle Open Source Software License 11242008
+
+OPEN SOURCE LICENSE
+
+Subject to the conditions of this License, each
+contributor to this software hereby grants, free of
+charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), a
+perpetual, worldwide, non-exclusive, no-charge,
+royalty-free, irrevocable copyright license to use, copy,
+modify, merge, publish, distribute, and/or sublicense
+copies of the Software.
+
+1. Redistributions of Software must retain the above
+copyright and license notices, this list of conditions,
+and the following disclaimer.  Changes or modifications
+to, or derivative works of, the Software should be noted
+with comments and the contributor and organization's
+name.
+
+2. Neither the names of UT-Battelle, LLC or the
+Department of Energy nor the names of the Software
+contributors may be used to endorse or promote products
+derived from this software without specific prior written
+permission of UT-Battelle.
+
+3. The software and the end-user documentation included
+with the redistribution, with or without modification,
+must include the following acknowledgment:
+
+"This product includes software produced by UT-Battelle,
+LLC under Contract No. DE-AC05-00OR22725  with the
+Department of Energy."
+
+*********************************************************
+DISCLAIMER
+
+THE SOFTWARE IS SUPPLIED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER, CONTRIBUTORS, UNITED STATES GOVERNMENT,
+OR THE UNITED STATES DEPARTMENT OF ENERGY BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+NEITHER THE UNITED STATES GOVERNMENT, NOR THE UNITED
+STATES DEPARTMENT OF ENERGY, NOR THE COPYRIGHT OWNER, NOR
+ANY OF THEIR EMPLOYEES, REPRESENTS THAT THE USE OF ANY
+INFORMATION, DATA, APPARATUS, PRODUCT, OR PROCESS
+DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
+
+*********************************************************
+*/
+/** \ingroup DMRG */
+/*@{*/
+
+/*! \file BinaryStore.h
+ *
+ *  Binary companion of a data file
+ *
+ *  With SolverOptions containing binaryData, the large arrays of a run
+ *  (VectorWithOffsets sectors and the DmrgSerializer transform) go to
+ *  datafile.bin as typed, length-prefixed blocks, and the text data file
+ *  only keeps the offset of each block.
+ *
+ *  File layout: magic, version, flags, then blocks; each block is
+ *  type, compression, number of elements, number of bytes, bytes.
+ *  With binaryDataCompress, blocks are stored as runs of zeros and
+ *  literals, when that is smaller. Blocks start at multiples of
+ *  8 bytes, so that uncompressed ones can be used in place from In.
+ */
+#ifndef DMRG_BINARY_STORE_H
+#define DMRG_BINARY_STORE_H
+
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <iostream>
+#include "Vector.h"
+#include "Complex.h"
+#include "Map.h"
+#include "TypeToString.h"
+#include "Concurrency.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace Dmrg {
+
+template<typename T>
+struct BinaryStoreTraits {
+	enum {KIND = 0};
+};
+
+template<>
+struct BinaryStoreTraits<int> {
+	enum {KIND = 1};
+};
+
+template<>
+struct BinaryStoreTraits<long int> {
+	enum {KIND = 1};
+};
+
+template<>
+struct BinaryStoreTraits<unsigned int> {
+	enum {KIND = 2};
+};
+
+template<>
+struct BinaryStoreTraits<unsigned long int> {
+	enum {KIND = 2};
+};
+
+template<>
+struct BinaryStoreTraits<float> {
+	enum {KIND = 3};
+};
+
+template<>
+struct BinaryStoreTraits<double> {
+	enum {KIND = 3};
+};
+
+template<typename T>
+struct BinaryStoreTraits<std::complex<T> > {
+	enum {KIND = 4};
+};
+
+class BinaryStore {
+
+	typedef unsigned long int WordType;
+	typedef PsimagLite::Concurrency ConcurrencyType;
+
+	static const WordType VERSION = 1;
+
+	static const char* magic() { return "DMRGBIN"; } // 8 bytes with the \0
+
+public:
+
+	typedef long int OffsetType;
+
+	enum CompressionEnum {COMPRESSION_NONE, COMPRESSION_ZERO_RUNS};
+
+	class Out {
+
+	public:
+
+		// The companion is written in place and only appended to, each
+		// block reaching the file before its offset goes to the text
+		// file, so that a run killed at any point leaves both usable.
+		// An old companion is unlinked first, not truncated, so that
+		// processes that have it mapped keep a valid mapping
+		Out(const PsimagLite::String& datafile, bool compress)
+		    : filename_(BinaryStore::filename(datafile)),
+		      fout_(),
+		      compress_(compress)
+		{
+			std::remove(filename_.c_str());
+			fout_.open(filename_.c_str(), std::ios::binary | std::ios::trunc);
+			if (!fout_ || !fout_.good())
+				throw PsimagLite::RuntimeError("BinaryStore: cannot write " +
+				                               filename_ + "\n");
+			fout_.write(magic(), 8);
+			writeWord(VERSION);
+			writeWord(0); // flags
+			fout_.flush();
+		}
+
+		// Returns the offset to give to In::read
+		template<typename T>
+		OffsetType write(const typename PsimagLite::Vector<T>::Type& v)
+		{
+			OffsetType offset = fout_.tellp();
+
+			WordType n = v.size();
+			WordType compression = COMPRESSION_NONE;
+			WordType bytes = n*sizeof(T);
+			typename PsimagLite::Vector<WordType>::Type runs;
+			if (compress_) {
+				WordType nonzeros = zeroRuns<T>(runs,v);
+				WordType cbytes = runs.size()*sizeof(WordType) + nonzeros*sizeof(T);
+				if (cbytes < bytes) {
+					compression = COMPRESSION_ZERO_RUNS;
+					bytes = cbytes;
+				}
+			}
+
+			writeWord(typeCode<T>());
+			writeWord(compression);
+			writeWord(n);
+			writeWord(bytes);
+
+			if (compression == COMPRESSION_NONE) {
+				if (n > 0) fout_.write(reinterpret_cast<const char*>(&v[0]), n*sizeof(T));
+			} else {
+				WordType index = 0;
+				for (SizeType i = 0; i < runs.size(); i += 2) {
+					writeWord(runs[i]);
+					writeWord(runs[i + 1]);
+					index += runs[i];
+					fout_.write(reinterpret_cast<const char*>(&v[index]),
+					            runs[i + 1]*sizeof(T));
+					index += runs[i + 1];
+				}
+			}
+
+			// the next block starts aligned, so that In::view can be used
+			static const char zeros[sizeof(WordType)] = {0};
+			OffsetType end = fout_.tellp();
+			OffsetType pad = end % sizeof(WordType);
+			if (pad > 0) fout_.write(zeros, sizeof(WordType) - pad);
+
+			// before the caller prints offset to the text file
+			fout_.flush();
+			if (!fout_.good())
+				throw PsimagLite::RuntimeError("BinaryStore: write failed for " +
+				                               filename_ + "\n");
+
+			return offset;
+		}
+
+	private:
+
+		Out(const Out&);
+
+		Out& operator=(const Out&);
+
+		void writeWord(WordType x)
+		{
+			fout_.write(reinterpret_cast<const char*>(&x), sizeof(WordType));
+		}
+
+		// runs is zeros, literals, zeros, literals, ...
+		template<typename T>
+		static WordType zeroRuns(typename PsimagLite::Vector<WordType>::Type& runs,
+		                         const typename PsimagLite::Vector<T>::Type& v)
+		{
+			const T zero = 0;
+			WordType nonzeros = 0;
+			SizeType i = 0;
+			while (i < v.size()) {
+				WordType zeros = 0;
+				while (i < v.size() && v[i] == zero) { ++zeros; ++i; }
+				WordType literals = 0;
+				while (i < v.size() && v[i] != zero) { ++literals; ++i; }
+				runs.push_back(zeros);
+				runs.push_back(literals);
+				nonzeros += literals;
+			}
+
+			return nonzeros;
+		}
+
+		PsimagLite::String filename_;
+		std::ofstream fout_;
+		bool compress_;
+	}; // class Out
+
+	// The companion file is mapped read only: pages are read when
+	// first touched, and are shared by all processes reading the file
+	class In {
+
+	public:
+
+		In(const PsimagLite::String& datafile)
+		    : filename_(BinaryStore::filename(datafile)),
+		      data_(0),
+		      bytes_(0)
+		{
+			memset(&info_, 0, sizeof(info_));
+			int fd = open(filename_.c_str(), O_RDONLY);
+			if (fd < 0) return;
+
+			struct stat& info = info_;
+			if (fstat(fd, &info) != 0 || info.st_size < 3*OffsetType(sizeof(WordType))) {
+				close(fd);
+				return;
+			}
+
+			void* ptr = mmap(0, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+			close(fd); // the mapping stays
+			if (ptr == MAP_FAILED)
+				throw PsimagLite::RuntimeError("BinaryStore: cannot map " +
+				                               filename_ + "\n");
+
+			data_ = static_cast<const char*>(ptr);
+			bytes_ = info.st_size;
+			if (memcmp(data_, magic(), 8) != 0) {
+				unmap();
+				return;
+			}
+
+			WordType version = word(8);
+			if (version > VERSION) {
+				unmap();
+				throw PsimagLite::RuntimeError("BinaryStore: " + filename_ +
+				                               " has version " + ttos(version) +
+				                               ", newer than this code\n");
+			}
+		}
+
+		~In()
+		{
+			unmap();
+		}
+
+		bool valid() const { return (data_ != 0); }
+
+		// True if info is the file that was mapped, unchanged since
+		bool sameFile(const struct stat& info) const
+		{
+			return (info.st_dev == info_.st_dev &&
+			        info.st_ino == info_.st_ino &&
+			        info.st_size == info_.st_size &&
+			        info.st_mtime == info_.st_mtime);
+		}
+
+		// Copies the block at offset into v; thread safe
+		template<typename T>
+		void read(typename PsimagLite::Vector<T>::Type& v, OffsetType offset) const
+		{
+			SizeType n = 0;
+			const T* ptr = view<T>(n, offset);
+			if (ptr) {
+				v.resize(n);
+				if (n > 0) memcpy(&v[0], ptr, n*sizeof(T));
+				return;
+			}
+
+			// compressed
+			OffsetType payload = offset + 4*sizeof(WordType);
+			v.resize(n);
+			const T zero = 0;
+			WordType index = 0;
+			while (index < n) {
+				WordType zeros = word(payload);
+				WordType literals = word(payload + sizeof(WordType));
+				payload += 2*sizeof(WordType);
+				if (index + zeros + literals > n)
+					throw PsimagLite::RuntimeError("BinaryStore: corrupted block at offset " +
+					                               ttos(offset) + " of " + filename_ + "\n");
+				for (WordType i = 0; i < zeros; ++i) v[index++] = zero;
+				checkRange(payload, literals*sizeof(T));
+				if (literals > 0)
+					memcpy(&v[index], data_ + payload, literals*sizeof(T));
+				index += literals;
+				payload += literals*sizeof(T);
+			}
+		}
+
+		// The block at offset in place, without copying, and its size in n;
+		// zero if the block is compressed. Valid for as long as this object
+		template<typename T>
+		const T* view(SizeType& n, OffsetType offset) const
+		{
+			checkRange(offset, 4*sizeof(WordType));
+			WordType code = word(offset);
+			WordType compression = word(offset + sizeof(WordType));
+			n = word(offset + 2*sizeof(WordType));
+			WordType bytes = word(offset + 3*sizeof(WordType));
+			if (code != typeCode<T>())
+				throw PsimagLite::RuntimeError("BinaryStore: type mismatch at offset " +
+				                               ttos(offset) + " of " + filename_ + "\n");
+
+			OffsetType payload = offset + 4*sizeof(WordType);
+			checkRange(payload, bytes);
+			if (compression != COMPRESSION_NONE) return 0;
+			return reinterpret_cast<const T*>(data_ + payload);
+		}
+
+	private:
+
+		In(const In&);
+
+		In& operator=(const In&);
+
+		WordType word(OffsetType offset) const
+		{
+			checkRange(offset, sizeof(WordType));
+			WordType x = 0;
+			memcpy(&x, data_ + offset, sizeof(WordType));
+			return x;
+		}
+
+		void checkRange(OffsetType offset, OffsetType len) const
+		{
+			if (offset >= 0 && len >= 0 && offset + len <= bytes_) return;
+			throw PsimagLite::RuntimeError("BinaryStore: offset " + ttos(offset) +
+			                               " past the end of " + filename_ + "\n");
+		}
+
+		void unmap()
+		{
+			if (data_) munmap(const_cast<char*>(data_), bytes_);
+			data_ = 0;
+			bytes_ = 0;
+		}
+
+		PsimagLite::String filename_;
+		const char* data_;
+		OffsetType bytes_;
+		struct stat info_;
+	}; // class In
+
+	typedef PsimagLite::Map<PsimagLite::String, Out*>::Type MapOutType;
+	typedef PsimagLite::Map<PsimagLite::String, In*>::Type MapInType;
+
+
+	static PsimagLite::String filename(const PsimagLite::String& datafile)
+	{
+		return datafile + ".bin";
+	}
+
+	// Label of the line that gives the offset of a block in the text file
+	static PsimagLite::String label() { return "#BINARYAT="; }
+
+	// Called by the code that creates datafile, before anything is saved to it
+	static void openWriter(const PsimagLite::String& datafile, bool binary, bool compress)
+	{
+		closeWriter(datafile);
+		Registry& r = registry();
+		Lock lock(r);
+		r.retire(datafile);
+		if (!binary) {
+			// a stale companion would make readers expect binary blocks
+			std::remove(filename(datafile).c_str());
+			return;
+		}
+
+		r.writers[datafile] = new Out(datafile, compress);
+	}
+
+	static void closeWriter(const PsimagLite::String& datafile)
+	{
+		Registry& r = registry();
+		Lock lock(r);
+		MapOutType::iterator it = r.writers.find(datafile);
+		if (it == r.writers.end()) return;
+		delete it->second;
+		r.writers.erase(it);
+		r.retire(datafile);
+	}
+
+	// Zero if datafile is written as text only
+	static Out* writer(const PsimagLite::String& datafile)
+	{
+		Registry& r = registry();
+		Lock lock(r);
+		MapOutType::iterator it = r.writers.find(datafile);
+		return (it == r.writers.end()) ? 0 : it->second;
+	}
+
+	// Zero if datafile has no binary companion. Thread safe.
+	// A reader is kept while its file is unchanged; if the file is
+	// replaced or rewritten, the next call maps the new one. Readers
+	// already handed out stay valid until the program ends
+	static const In* reader(const PsimagLite::String& datafile)
+	{
+		Registry& r = registry();
+		Lock lock(r);
+		struct stat info;
+		if (stat(filename(datafile).c_str(), &info) != 0) {
+			r.retire(datafile);
+			return 0;
+		}
+
+		MapInType::iterator it = r.readers.find(datafile);
+		if (it != r.readers.end() && it->second->sameFile(info))
+			return it->second;
+
+		r.retire(datafile);
+		In* in = new In(datafile);
+		if (!in->valid()) {
+			delete in;
+			return 0;
+		}
+
+		r.readers[datafile] = in;
+		return in;
+	}
+
+	// Prints v to io, or to the binary companion of io if there is one,
+	// in which case only name and the offset go to io
+	template<typename IoOutputter, typename VectorType>
+	static void printVector(IoOutputter& io,
+	                        const VectorType& v,
+	                        const PsimagLite::String& name)
+	{
+		Out* out = writer(io.filename());
+		if (!out) {
+			io.printVector(v, name);
+			return;
+		}
+
+		OffsetType offset = out->write<typename VectorType::value_type>(v);
+		io.printline(name + label() + ttos(offset));
+	}
+
+	// Reads what printVector printed
+	template<typename IoInputter, typename VectorType>
+	static void read(IoInputter& io,
+	                 VectorType& v,
+	                 const PsimagLite::String& name)
+	{
+		const In* in = reader(io.filename());
+		if (!in) {
+			io.read(v, name);
+			return;
+		}
+
+		OffsetType offset = 0;
+		io.readline(offset, name + label());
+		in->read<typename VectorType::value_type>(v, offset);
+	}
+
+	// Reads what printVector printed, but without copying if the block is
+	// in the binary companion and not compressed: then v is left empty and
+	// the block is returned in place, with its size in n; it stays valid
+	// until the program ends (see reader). Otherwise v gets the block,
+	// n its size, and zero is returned
+	template<typename IoInputter, typename VectorType>
+	static const typename VectorType::value_type* view(IoInputter& io,
+	                                                   VectorType& v,
+	                                                   SizeType& n,
+	                                                   const PsimagLite::String& name)
+	{
+		typedef typename VectorType::value_type ValueType;
+		const In* in = reader(io.filename());
+		if (!in) {
+			io.read(v, name);
+			n = v.size();
+			return 0;
+		}
+
+		OffsetType offset = 0;
+		io.readline(offset, name + label());
+		const ValueType* ptr = in->view<ValueType>(n, offset);
+		if (ptr) {
+			v.clear();
+			return ptr;
+		}
+
+		in->read<ValueType>(v, offset);
+		n = v.size();
+		return 0;
+	}
+
+	// Sparse matrices are stored as row pointers, columns and values,
+	// followed by a header with rows, cols and the offsets of the three;
+	// the offset of the header is returned
+	template<typename SparseMatrixType>
+	static OffsetType writeCrs(Out& out, const SparseMatrixType& m)
+	{
+		typedef typename SparseMatrixType::value_type ValueType;
+		SizeType rows = m.rows();
+		SizeType nonzeros = m.nonZero();
+		typename PsimagLite::Vector<SizeType>::Type rowptr(rows + 1);
+		typename PsimagLite::Vector<SizeType>::Type cols(nonzeros);
+		typename PsimagLite::Vector<ValueType>::Type values(nonzeros);
+		for (SizeType i = 0; i < rows; ++i) {
+			rowptr[i] = m.getRowPtr(i);
+			for (int k = m.getRowPtr(i); k < m.getRowPtr(i + 1); ++k) {
+				cols[k] = m.getCol(k);
+				values[k] = m.getValue(k);
+			}
+		}
+
+		rowptr[rows] = nonzeros;
+
+		typename PsimagLite::Vector<OffsetType>::Type header(5);
+		header[0] = rows;
+		header[1] = m.cols();
+		header[2] = out.write<SizeType>(rowptr);
+		header[3] = out.write<SizeType>(cols);
+		header[4] = out.write<ValueType>(values);
+		return out.write<OffsetType>(header);
+	}
+
+	template<typename SparseMatrixType>
+	static void readCrs(SparseMatrixType& m, const In& in, OffsetType offset)
+	{
+		typedef typename SparseMatrixType::value_type ValueType;
+		typename PsimagLite::Vector<OffsetType>::Type header;
+		in.read<OffsetType>(header, offset);
+		if (header.size() != 5)
+			throw PsimagLite::RuntimeError("BinaryStore: not a sparse matrix\n");
+
+		// copied from the mapping straight into m, unless compressed
+		typename PsimagLite::Vector<SizeType>::Type rowptrBuffer;
+		typename PsimagLite::Vector<SizeType>::Type colsBuffer;
+		typename PsimagLite::Vector<ValueType>::Type valuesBuffer;
+		SizeType nrowptr = 0;
+		SizeType ncols = 0;
+		SizeType nvalues = 0;
+		const SizeType* rowptr = viewOrRead<SizeType>(rowptrBuffer, nrowptr, in, header[2]);
+		const SizeType* cols = viewOrRead<SizeType>(colsBuffer, ncols, in, header[3]);
+		const ValueType* values = viewOrRead<ValueType>(valuesBuffer, nvalues, in, header[4]);
+
+		SizeType rows = header[0];
+		if (nrowptr != rows + 1 || ncols != nvalues || rowptr[rows] != nvalues)
+			throw PsimagLite::RuntimeError("BinaryStore: corrupted sparse matrix\n");
+
+		m.resize(rows, header[1]);
+		for (SizeType i = 0; i < rows; ++i) {
+			m.setRow(i, rowptr[i]);
+			for (SizeType k = rowptr[i]; k < rowptr[i + 1]; ++k) {
+				m.pushCol(cols[k]);
+				m.pushValue(values[k]);
+			}
+		}
+
+		m.setRow(rows, rowptr[rows]);
+		m.checkValidity();
+	}
+
+private:
+
+	template<typename T>
+	static const T* viewOrRead(typename PsimagLite::Vector<T>::Type& buffer,
+	                           SizeType& n,
+	                           const In& in,
+	                           OffsetType offset)
+	{
+		const T* ptr = in.view<T>(n, offset);
+		if (ptr) return ptr;
+		in.read<T>(buffer, offset);
+		n = buffer.size();
+		return (n > 0) ? &buffer[0] : 0;
+	}
+
+	template<typename T>
+	static WordType typeCode()
+	{
+		// kind and size, so that, for example, float and double differ
+		return BinaryStoreTraits<T>::KIND*256 + sizeof(T);
+	}
+
+	// Open writers and readers, by data file
+	struct Registry {
+
+		Registry()
+		{
+			ConcurrencyType::mutexInit(&mutex);
+		}
+
+		~Registry()
+		{
+			for (MapOutType::iterator it = writers.begin(); it != writers.end(); ++it)
+				delete it->second;
+			for (MapInType::iterator it = readers.begin(); it != readers.end(); ++it)
+				delete it->second;
+			for (SizeType i = 0; i < retired.size(); ++i)
+				delete retired[i];
+			ConcurrencyType::mutexDestroy(&mutex);
+		}
+
+		// The reader of datafile is no longer handed out, but
+		// its mapping stays for those that have it
+		void retire(const PsimagLite::String& datafile)
+		{
+			MapInType::iterator it = readers.find(datafile);
+			if (it == readers.end()) return;
+			retired.push_back(it->second);
+			readers.erase(it);
+		}
+
+		MapOutType writers;
+		MapInType readers;
+		PsimagLite::Vector<In*>::Type retired;
+		ConcurrencyType::MutexType mutex;
+	}; // struct Registry
+
+	class Lock {
+
+	public:
+
+		Lock(Registry& r) : r_(r) { ConcurrencyType::mutexLock(&r_.mutex); }
+
+		~Lock() { ConcurrencyType::mutexUnlock(&r_.mutex); }
+
+	private:
+
+		Lock(const Lock&);
+
+		Lock& operator=(const Lock&);
+
+		Registry& r_;
+	}; // class Lock
+
+	static Registry& registry()
+	{
+		static Registry r;
+		return r;
+	}
+}; // class BinaryStore
+} // namespace Dmrg
+
+/*@}*/
+#endif // DMRG_BINARY_STORE_H
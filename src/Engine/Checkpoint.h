@@ -107,6 +107,7 @@ public:
 	typedef DiskStack<BasisWithOperatorsType>  DiskStackType;
 	typedef PsimagLite::Vector<PsimagLite::String>::Type VectorStringType;
 	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef typename MemoryStackType::View MemoryStackViewType;
 
 	const PsimagLite::String SYSTEM_STACK_STRING;
 	const PsimagLite::String ENVIRON_STACK_STRING;
@@ -120,6 +121,13 @@ public:
 	    parameters_(parameters),
 	    enabled_(parameters_.options.find("checkpoint")!=PsimagLite::String::npos ||
 	        parameters_.options.find("restart")!=PsimagLite::String::npos),
+	    operatorsDistributed_(parameters_.options.find("operatorsDistributed") !=
+	        PsimagLite::String::npos),
+	    lazyRestart_(parameters_.options.find("lazyRestart") != PsimagLite::String::npos),
+	    compressedDistance_((parameters_.options.find("compressedStacks") !=
+	        PsimagLite::String::npos) ? parameters_.compressedStacksDistance : 0),
+	    compressedFloat_(parameters_.options.find("compressedStacksFloat") !=
+	        PsimagLite::String::npos),
 	    systemStack_(parameters_.options.find("diskstacks")!=PsimagLite::String::npos),
 	    envStack_(parameters_.options.find("diskstacks")!=PsimagLite::String::npos),
 	    systemDisk_(utils::pathPrepend(SYSTEM_STACK_STRING,parameters_.checkpoint.filename),
@@ -131,7 +139,9 @@ public:
 	             enabled_,
 	             isObserveCode),
 	    progress_("Checkpoint"),
-	    energyFromFile_(0.0)
+	    energyFromFile_(0.0),
+	    lowWaterSystem_(0),
+	    lowWaterEnv_(0)
 	{
 		SizeType site = 0; // FIXME for Immm model, find max of hilbert(site) over site
 		SizeType hilbertOneSite = model.hilbertSize(site);
@@ -142,6 +152,18 @@ public:
 			throw PsimagLite::RuntimeError(str);
 		}
 
+		if (operatorsDistributed_ && BasisWithOperatorsType::useSu2Symmetry()) {
+			PsimagLite::String str("Checkpoint: operatorsDistributed ");
+			str += "cannot be used with SU(2) symmetry\n";
+			throw PsimagLite::RuntimeError(str);
+		}
+
+		if (compressedDistance_ > 0 && BasisWithOperatorsType::useSu2Symmetry()) {
+			PsimagLite::String str("Checkpoint: compressedStacks ");
+			str += "cannot be used with SU(2) symmetry\n";
+			throw PsimagLite::RuntimeError(str);
+		}
+
 		checkFiniteLoops(model.geometry().numberOfSites(), hilbertOneSite, ioIn);
 
 		if (!enabled_) return;
@@ -222,22 +244,45 @@ public:
 
 	void push(const BasisWithOperatorsType &pS,const BasisWithOperatorsType &pE)
 	{
-		systemStack_.push(pS);
-		envStack_.push(pE);
+		push(systemStack_,pS);
+		push(envStack_,pE);
 	}
 
 	void push(const BasisWithOperatorsType &pSorE,SizeType what)
 	{
-		if (what==ProgramGlobals::ENVIRON) envStack_.push(pSorE);
-		else systemStack_.push(pSorE);
+		if (what==ProgramGlobals::ENVIRON) push(envStack_,pSorE);
+		else push(systemStack_,pSorE);
 	}
 
 	BasisWithOperatorsType shrink(SizeType what,const TargettingType& target)
 	{
-		if (what==ProgramGlobals::ENVIRON) return shrink(envStack_,target);
-		else return shrink(systemStack_,target);
+		MemoryStackType& thisStack = (what==ProgramGlobals::ENVIRON) ? envStack_
+		                                                             : systemStack_;
+		BasisWithOperatorsType basisWithOps = shrink(thisStack,target);
+		SizeType& lowWater = lowWaterOf(what);
+		if (thisStack.size() < lowWater) lowWater = thisStack.size();
+		return basisWithOps;
+	}
+
+	// The smallest size that stack what has had since the previous call;
+	// the entries below it have not changed since then
+	SizeType takeLowWater(SizeType what) const
+	{
+		SizeType& lowWater = lowWaterOf(what);
+		SizeType ret = lowWater;
+		lowWater = memoryStack(what).size();
+		return ret;
+	}
+
+	// The n entries at the top of stack what, bottom one first, shared
+	// with the stack; with operatorsDistributed they lack operators
+	void topOfStack(MemoryStackViewType& view, SizeType what, SizeType n) const
+	{
+		memoryStack(what).topView(view, n);
 	}
 
+	bool operatorsDistributed() const { return operatorsDistributed_; }
+
 	bool operator()() const { return enabled_; }
 
 	SizeType stackSize(SizeType what) const
@@ -266,6 +311,23 @@ public:
 		copyDiskToDisk(stackInMemory, stackInDisk);
 	}
 
+	// Like loadStack, but with operatorsDistributed or compressedStacks
+	// each block gets all its operators back before it is written
+	void loadStackFetching(DiskStackType& stackInDisk, MemoryStackType& stackInMemory) const
+	{
+		if (!operatorsDistributed_ && compressedDistance_ == 0) {
+			loadStack(stackInDisk,stackInMemory);
+			return;
+		}
+
+		while (stackInMemory.size()>0) {
+			BasisWithOperatorsType b = stackInMemory.top();
+			complete(b);
+			stackInDisk.push(b);
+			stackInMemory.pop();
+		}
+	}
+
 	const ParametersType& parameters() const { return parameters_; }
 
 	const RealType& energy() const { return energyFromFile_; }
@@ -376,20 +438,79 @@ private:
 	{
 		thisStack.pop();
 		assert(thisStack.size() > 0);
+
+		// the block that is now compressedDistance_ - 1 below the top is
+		// decompressed one step ahead of being needed
+		if (compressedDistance_ > 0) {
+			BasisWithOperatorsType* next = thisStack.fromTop(compressedDistance_ - 1);
+			if (next) next->decompressOperators();
+		}
+
 		BasisWithOperatorsType basisWithOps =  thisStack.top();
+		complete(basisWithOps);
 		// only updates the extreme sites:
 		target.updateOnSiteForCorners(basisWithOps);
 		return basisWithOps;
 	}
 
+	// With operatorsDistributed the stacks keep on each rank
+	// only the operators of the sites that this rank owns.
+	// With compressedStacks the blocks compressedDistance_ or more
+	// below the top keep their operators compressed
+	void push(MemoryStackType& thisStack, const BasisWithOperatorsType& basis)
+	{
+		if (!operatorsDistributed_) {
+			thisStack.push(basis);
+		} else {
+			BasisWithOperatorsType b = basis;
+			b.keepOwnedOperators();
+			thisStack.push(b);
+		}
+
+		if (compressedDistance_ == 0) return;
+
+		BasisWithOperatorsType* far = thisStack.fromTop(compressedDistance_);
+		if (far) far->compressOperators(compressedFloat_);
+	}
+
+	// Gives back to a copy of a block from the stacks all its operators
+	void complete(BasisWithOperatorsType& b) const
+	{
+		b.decompressOperators();
+		if (operatorsDistributed_) b.fetchOperators();
+	}
+
 	void loadStacksDiskToMemory()
 	{
+		if (lazyRestart_) {
+			PsimagLite::OstringStream msg;
+			msg<<"Sys. and env. stacks will be read from disk when popped";
+			progress_.printline(msg,std::cout);
+			systemStack_.loadLazily(systemDisk_);
+			envStack_.loadLazily(envDisk_);
+			return;
+		}
+
 		PsimagLite::OstringStream msg;
 		msg<<"Loading sys. and env. stacks from disk...";
 		progress_.printline(msg,std::cout);
 
-		loadStack(systemStack_,systemDisk_);
-		loadStack(envStack_,envDisk_);
+		if (!operatorsDistributed_ && compressedDistance_ == 0) {
+			loadStack(systemStack_,systemDisk_);
+			loadStack(envStack_,envDisk_);
+			return;
+		}
+
+		loadStackPushing(systemStack_,systemDisk_);
+		loadStackPushing(envStack_,envDisk_);
+	}
+
+	void loadStackPushing(MemoryStackType& stackInMemory, DiskStackType& stackInDisk)
+	{
+		while (stackInDisk.size()>0) {
+			push(stackInMemory, stackInDisk.top());
+			stackInDisk.pop();
+		}
 	}
 
 	void loadStacksMemoryToDisk()
@@ -397,8 +518,13 @@ private:
 		PsimagLite::OstringStream msg;
 		msg<<"Writing sys. and env. stacks to disk...";
 		progress_.printline(msg,std::cout);
-		loadStack(systemDisk_,systemStack_);
-		loadStack(envDisk_,envStack_);
+		loadStackFetching(systemDisk_,systemStack_);
+		loadStackFetching(envDisk_,envStack_);
+	}
+
+	SizeType& lowWaterOf(SizeType what) const
+	{
+		return (what == ProgramGlobals::ENVIRON) ? lowWaterEnv_ : lowWaterSystem_;
 	}
 
 	//! Move elsewhere
@@ -416,12 +542,18 @@ private:
 
 	const ParametersType& parameters_;
 	bool enabled_;
+	bool operatorsDistributed_;
+	bool lazyRestart_;
+	SizeType compressedDistance_;
+	bool compressedFloat_;
 	MemoryStackType systemStack_;
 	MemoryStackType envStack_;
 	DiskStackType systemDisk_;
 	DiskStackType envDisk_;
 	PsimagLite::ProgressIndicator progress_;
 	RealType energyFromFile_;
+	mutable SizeType lowWaterSystem_;
+	mutable SizeType lowWaterEnv_;
 }; // class Checkpoint
 } // namespace Dmrg
 
@@ -74,7 +74,10 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 
 /*! \file ClebschGordanCached.h
  *
- *
+ *  Clebsch-Gordan coefficients tabulated per (j1, j2, j), for
+ *  all (m1, m2). The tables are only built for the j values the
+ *  run reaches, see grow(); after that lookups are O(1) and
+ *  read-only, so the object can be shared by threads.
  *
  */
 #ifndef CLEBSCH_GORDANCACHED_H
@@ -89,14 +92,15 @@ template<typename FieldType>
 class ClebschGordanCached {
 	typedef ClebschGordan<FieldType> ClebschGordanType;
 	typedef typename ClebschGordanType::PairType PairType;
+	typedef typename PsimagLite::Vector<FieldType>::Type VectorType;
+	typedef PsimagLite::Vector<int>::Type VectorIntType;
 
 public:
 
 	ClebschGordanCached(SizeType jmax)
-	    :  UNDEFINED_VALUE(-1000),
-	      jmax_(jmax),
-	      max2_(((jmax_-1)*(jmax_+2))/2+1),max22_(max2_*max2_),
-	      data_(max22_*jmax_*2,UNDEFINED_VALUE),cgObject_(2)
+	    : jmax_(jmax),
+	      jBuilt_(0),
+	      cgObject_(2)
 	{
 		init(jmax,2);
 	}
@@ -104,9 +108,10 @@ public:
 	void init(SizeType jmax,SizeType nfactorials)
 	{
 		jmax_=jmax;
-		max2_=((jmax_-1)*(jmax_+2))/2+1;
-		max22_=max2_*max2_;
-		data_.resize(max22_*jmax_*2,UNDEFINED_VALUE);
+		jBuilt_ = 0;
+		data_.clear();
+		offsets_.clear();
+		offsets_.resize(jmax_*jmax_*jmax_,-1);
 		cgObject_.init(nfactorials);
 
 		copies_++;
@@ -116,39 +121,61 @@ public:
 		}
 	}
 
-	FieldType operator()(const PairType& jm,const PairType& jm1,const PairType& jm2)
+	// Tabulates all coefficients with j values (in 2j format) up to jReached
+	// Not thread safe: call it before threads look up coefficients
+	void grow(SizeType jReached)
+	{
+		SizeType jnew = jReached + 1;
+		if (jnew > jmax_) jnew = jmax_;
+		if (jnew <= jBuilt_) return;
+
+		for (SizeType j=0;j<jnew;j++) {
+			for (SizeType j2=0;j2<jnew;j2++) {
+				for (SizeType j1=0;j1<jnew;j1++) {
+					if (j<jBuilt_ && j1<jBuilt_ && j2<jBuilt_) continue;
+					if (!checkCg1(j,j1,j2) || (j1+j2+j)%2!=0) continue;
+					addTable(j,j1,j2);
+				}
+			}
+		}
+
+		jBuilt_ = jnew;
+	}
+
+	FieldType operator()(const PairType& jm,const PairType& jm1,const PairType& jm2) const
 	{
 		if (!checkCg(jm,jm1,jm2)) return 0;
 
-		SizeType index1 = calcSubIndex(jm1);
-		SizeType index2 = calcSubIndex(jm2);
-		SizeType jmin=0;
-		if (jm1.first>jm2.first) jmin = jm1.first-jm2.first;
-		else jmin = jm2.first-jm1.first;
-		SizeType x = calcIndex(index1,index2)+(jm.first-jmin)*max22_;
-		if (data_[x]== UNDEFINED_VALUE) {
-			data_[x]=cgObject_(jm,jm1,jm2);
-		}
-		return data_[x];
+		if (jm.first>=jBuilt_ || jm1.first>=jBuilt_ || jm2.first>=jBuilt_)
+			return cgObject_(jm,jm1,jm2);
+
+		int offset = offsets_[tripleIndex(jm.first,jm1.first,jm2.first)];
+		assert(offset>=0);
+		return data_[offset + jm1.second + jm2.second*(jm1.first+1)];
 	}
 
 private:
-	SizeType calcSubIndex(const PairType& jm) const
+
+	SizeType tripleIndex(SizeType j,SizeType j1,SizeType j2) const
 	{
-		if (jm.second==0) return jm.first;
-		SizeType x = 2*jmax_-1-jm.second;
-		x *= jm.second;
-		x /= 2;
-		x += jm.first;
-		if (x>=max2_)
-			throw PsimagLite::RuntimeError("problem calcSubIndex\n");
-		return x;
+		assert(j<jmax_ && j1<jmax_ && j2<jmax_);
+		return j1 + j2*jmax_ + j*jmax_*jmax_;
 	}
 
-	SizeType calcIndex(SizeType i1,SizeType i2) const
+	// one entry per (m1, m2); m is fixed by m1 and m2
+	void addTable(SizeType j,SizeType j1,SizeType j2)
 	{
-		if (i1>=max2_ || i2>=max2_) throw PsimagLite::RuntimeError("problem\n");
-		return i1+i2*max2_;
+		offsets_[tripleIndex(j,j1,j2)] = data_.size();
+		int x = (j1+j2-j)/2;
+		for (SizeType m2=0;m2<=j2;m2++) {
+			for (SizeType m1=0;m1<=j1;m1++) {
+				int m = m1 + m2 - x;
+				FieldType value = 0;
+				if (m>=0 && SizeType(m)<=j)
+					value = cgObject_(PairType(j,m),PairType(j1,m1),PairType(j2,m2));
+				data_.push_back(value);
+			}
+		}
 	}
 
 	bool checkCg(const PairType& jm,const PairType& jm1,const PairType& jm2) const
@@ -182,10 +209,10 @@ private:
 	}
 
 	static SizeType copies_;
-	int UNDEFINED_VALUE;
 	SizeType jmax_;
-	SizeType max2_,max22_;
-	typename PsimagLite::Vector<FieldType>::Type data_;
+	SizeType jBuilt_;
+	VectorIntType offsets_;
+	VectorType data_;
 	ClebschGordanType cgObject_;
 }; // class ClebschGordanCached
 
@@ -85,7 +85,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "String.h"
 #include <fstream>
 #include <iostream>
-#include <vector>
+#include "Vector.h"
 #include "TypeToString.h"
 
 namespace Dmrg {
@@ -93,31 +93,41 @@ namespace Dmrg {
 	class	Cloner {
 		static const SizeType  LINE_LENGTH = 1024;
 	public:
+		// infile is read once, here; each createInputFile works from memory
 		Cloner(const PsimagLite::String& infile,
 		       const PsimagLite::String& outRoot,
 		       const PsimagLite::String& ext)
-		: infile_(infile),outRoot_(outRoot),ext_(ext)
-		{}
+		: outRoot_(outRoot),ext_(ext)
+		{
+			std::ifstream fin(infile.c_str());
+			if (!fin || !fin.good() || fin.bad())
+				throw PsimagLite::RuntimeError("Cloner: cannot open " + infile + "\n");
+
+			char line[LINE_LENGTH];
+			while(!fin.eof()) {
+				fin.getline(line,LINE_LENGTH);
+				lines_.push_back(line);
+			}
+
+			fin.close();
+		}
 
 		void push(const LineChangerType& lineChanger) 
 		{
 			lineChanger_.push_back(lineChanger);
 		}
 
-		void createInputFile(SizeType ind) const
+		PsimagLite::String createInputFile(SizeType ind) const
 		{
-			std::ifstream fin(infile_.c_str());
 			PsimagLite::String outfile = outRoot_ + ttos(ind) + ext_;
 			std::ofstream fout(outfile.c_str());
-			char line[LINE_LENGTH];
-			while(!fin.eof()) {
-				fin.getline(line,LINE_LENGTH);
-				PsimagLite::String s(line);
+			for (SizeType i = 0; i < lines_.size(); ++i) {
+				PsimagLite::String s(lines_[i]);
 				if (!procLine(s,ind)) continue;
 				fout<<s<<"\n";
 			}
 			fout.close();
-			fin.close();
+			return outfile;
 		}
 
 	private:
@@ -132,7 +142,8 @@ namespace Dmrg {
 			return true;
 		}
 
-		PsimagLite::String infile_,outRoot_,ext_;
+		PsimagLite::String outRoot_,ext_;
+		PsimagLite::Vector<PsimagLite::String>::Type lines_;
 		typename PsimagLite::Vector<LineChangerType>::Type lineChanger_;
 	}; // class Cloner
 
@@ -0,0 +1,229 @@
+/*
+Copyright (c) 2009-2018, UT-Battelle, LLC
+All rights reserved
+
+[DMRG++, Version 3.0]
+[by G.A., Oak Ridge National Laboratory]
+
+UT Battelle Open Source Software License 11242008
+
+OPEN SOURCE LICENSE
+
+Subject to the conditions of this License, each
+contributor to this software hereby grants, free of
+charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), a
+perpetual, worldwide, non-exclusive, no-charge,
+royalty-free, irrevocable copyright license to use, copy,
+modify, merge, publish, distribute, and/or sublicense
+copies of the Software.
+
+1. Redistributions of Software must retain the above
+copyright and license notices, this list of conditions,
+and the following disclaimer.  Changes or modifications
+to, or derivative works of, the Software should be noted
+with comments and the contributor and organization's
+name.
+
+2. Neither the names of UT-Battelle, LLC or the
+Department of Energy nor the names of the Software
+contributors may be used to endorse or promote products
+derived from this software without specific prior written
+permission of UT-Battelle.
+
+3. The software and the end-user documentation included
+with the redistribution, with or without modification,
+must include the following acknowledgment:
+
+"This product includes software produced by UT-Battelle,
+LLC under Contract No. DE-AC05-00OR22725  with the
+Department of Energy."
+
+*********************************************************
+DISCLAIMER
+
+THE SOFTWARE IS SUPPLIED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER, CONTRIBUTORS, UNITED STATES GOVERNMENT,
+OR THE UNITED STATES DEPARTMENT OF ENERGY BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+NEITHER THE UNITED STATES GOVERNMENT, NOR THE UNITED
+STATES DEPARTMENT OF ENERGY, NOR THE COPYRIGHT OWNER, NOR
+ANY OF THEIR EMPLOYEES, REPRESENTS THAT THE USE OF ANY
+INFORMATION, DATA, APPARATUS, PRODUCT, OR PROCESS
+DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
+
+*********************************************************
+*/
+/** \ingroup DMRG */
+/*@{*/
+
+/*! \file ComplementaryOperators.h
+ *
+ *  Pre-summed (complementary) operators for one superblock sector
+ *
+ *  All connections that share the same operator on one side,
+ *  A_i x sum_j value_ij B_j, are folded into a single term
+ *  A_i x Btilde_i. Btilde_i is formed once per sector and reused by every
+ *  matrix vector product, so that the number of terms grows with the
+ *  number of sites of one block instead of with the number of
+ *  connections. This helps models with long range couplings.
+ *
+ */
+#ifndef COMPLEMENTARY_OPERATORS_H
+#define COMPLEMENTARY_OPERATORS_H
+
+#include "Link.h"
+#include "ProgramGlobals.h"
+#include "Vector.h"
+#include "Map.h"
+#include <cassert>
+
+namespace Dmrg {
+
+template<typename SparseMatrixType>
+class ComplementaryOperators {
+
+	typedef typename SparseMatrixType::value_type SparseElementType;
+	typedef typename PsimagLite::Vector<const SparseMatrixType*>::Type VectorPointerType;
+	typedef typename PsimagLite::Vector<SparseMatrixType>::Type VectorSparseMatrixType;
+	typedef typename PsimagLite::Vector<SparseElementType>::Type VectorSparseElementType;
+	typedef typename PsimagLite::Vector<ProgramGlobals::FermionOrBosonEnum>::Type
+	VectorFermionOrBosonType;
+	typedef std::pair<const SparseMatrixType*, SizeType> KeyType;
+	typedef typename PsimagLite::Map<KeyType, SizeType>::Type MapType;
+
+public:
+
+	typedef Link<SparseElementType> LinkType;
+
+	ComplementaryOperators()
+	    : sealed_(false), connections_(0)
+	{}
+
+	bool sealed() const { return sealed_; }
+
+	// A belongs to the system and B to the environ, and
+	// the connection is value * A x B
+	void push(const SparseMatrixType& A,
+	          const SparseMatrixType& B,
+	          const SparseElementType& value,
+	          ProgramGlobals::FermionOrBosonEnum fermionOrBoson)
+	{
+		assert(!sealed_);
+		rawA_.push_back(&A);
+		rawB_.push_back(&B);
+		rawValue_.push_back(value);
+		rawFermionOrBoson_.push_back(fermionOrBoson);
+	}
+
+	// Folds the pushed connections over the block with fewer
+	// distinct operators
+	void seal()
+	{
+		assert(!sealed_);
+		connections_ = rawA_.size();
+		MapType groupsA;
+		MapType groupsB;
+		for (SizeType ix = 0; ix < connections_; ++ix) {
+			addToGroup(groupsA, KeyType(rawA_[ix], rawFermionOrBoson_[ix]));
+			addToGroup(groupsB, KeyType(rawB_[ix], rawFermionOrBoson_[ix]));
+		}
+
+		fixedIsSystem_ = (groupsA.size() <= groupsB.size());
+		const MapType& groups = (fixedIsSystem_) ? groupsA : groupsB;
+		const VectorPointerType& fixed = (fixedIsSystem_) ? rawA_ : rawB_;
+		const VectorPointerType& other = (fixedIsSystem_) ? rawB_ : rawA_;
+
+		SizeType n = groups.size();
+		fixed_.resize(n, 0);
+		summed_.resize(n);
+		fermionOrBoson_.resize(n);
+		typename PsimagLite::Vector<bool>::Type started(n, false);
+
+		for (SizeType ix = 0; ix < connections_; ++ix) {
+			KeyType key(fixed[ix], rawFermionOrBoson_[ix]);
+			typename MapType::const_iterator it = groups.find(key);
+			assert(it != groups.end());
+			SizeType g = it->second;
+			if (!started[g]) {
+				fixed_[g] = fixed[ix];
+				fermionOrBoson_[g] = rawFermionOrBoson_[ix];
+				summed_[g] = rawValue_[ix]*(*other[ix]);
+				started[g] = true;
+				continue;
+			}
+
+			summed_[g] += rawValue_[ix]*(*other[ix]);
+		}
+
+		rawA_.clear();
+		rawB_.clear();
+		rawValue_.clear();
+		rawFermionOrBoson_.clear();
+		sealed_ = true;
+	}
+
+	SizeType size() const { return fixed_.size(); }
+
+	SizeType connections() const { return connections_; }
+
+	LinkType operator()(const SparseMatrixType** A,
+	                    const SparseMatrixType** B,
+	                    SizeType ix) const
+	{
+		assert(sealed_ && ix < fixed_.size());
+		*A = (fixedIsSystem_) ? fixed_[ix] : &summed_[ix];
+		*B = (fixedIsSystem_) ? &summed_[ix] : fixed_[ix];
+
+		typename LinkType::PairSizeType ops(0, 0);
+		typename LinkType::PairCharType mods('N', 'N');
+		return LinkType(0,
+		                0,
+		                ProgramGlobals::SYSTEM_ENVIRON,
+		                1.0,
+		                0,
+		                fermionOrBoson_[ix],
+		                ops,
+		                mods,
+		                1,
+		                1.0,
+		                0);
+	}
+
+private:
+
+	static void addToGroup(MapType& groups, const KeyType& key)
+	{
+		if (groups.find(key) != groups.end()) return;
+		SizeType n = groups.size();
+		groups[key] = n;
+	}
+
+	bool sealed_;
+	SizeType connections_;
+	bool fixedIsSystem_;
+	VectorPointerType rawA_;
+	VectorPointerType rawB_;
+	VectorSparseElementType rawValue_;
+	VectorFermionOrBosonType rawFermionOrBoson_;
+	VectorPointerType fixed_;
+	VectorSparseMatrixType summed_;
+	VectorFermionOrBosonType fermionOrBoson_;
+}; // class ComplementaryOperators
+} // namespace Dmrg
+/*@}*/
+#endif // COMPLEMENTARY_OPERATORS_H
+
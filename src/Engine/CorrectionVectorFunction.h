@@ -80,6 +80,8 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #ifndef CORRECTION_V_FUNCTION_H
 #define CORRECTION_V_FUNCTION_H
 #include "ConjugateGradient.h"
+#include "Arena.h"
+#include <algorithm>
 
 namespace Dmrg {
 template<typename MatrixType,typename InfoType>
@@ -87,6 +89,7 @@ class	CorrectionVectorFunction {
 
 	typedef typename MatrixType::value_type FieldType;
 	typedef typename PsimagLite::Vector<FieldType>::Type VectorType;
+	typedef Arena<FieldType> ArenaType;
 	typedef typename PsimagLite::Real<FieldType>::Type RealType;
 
 	class InternalMatrix {
@@ -107,9 +110,14 @@ class	CorrectionVectorFunction {
 		{
 			RealType eta = info_.eta();
 			RealType omegaMinusE0 = info_.omega().second + E0_;
-			VectorType xTmp(x.size(),0);
+			// Lanczos calls this outside of parallel loops, thus thread 0
+			typename ArenaType::Buffer xTmpBuffer(x.size());
+			VectorType& xTmp = xTmpBuffer();
+			std::fill(xTmp.begin(), xTmp.end(), 0.0);
 			m_.matrixVectorProduct(xTmp,y); // xTmp = Hy
-			VectorType x2(x.size(),0);
+			typename ArenaType::Buffer x2Buffer(x.size());
+			VectorType& x2 = x2Buffer();
+			std::fill(x2.begin(), x2.end(), 0.0);
 			m_.matrixVectorProduct(x2,xTmp); // x2 = H^2 y
 			const RealType f1 = (-2.0);
 			// this needs fixing
@@ -166,7 +166,23 @@ public:
 		int nt=i-1;
 		if (nt<0) nt=0;
 
-		for (SizeType s=nt;s<ns;s++) {
+		growDirectlyFrom(Odest,i,fermionicSign,nt,ns,transform,threadId);
+	}
+
+	//! Continues a growDirectly(...) that stopped at sFrom, up to ns
+	//! Odest must have been grown (and transformed) up to sFrom
+	void growDirectlyFrom(SparseMatrixType& Odest,
+	                      SizeType i,
+	                      int fermionicSign,
+	                      SizeType sFrom,
+	                      SizeType ns,
+	                      bool transform,
+	                      SizeType threadId)
+	{
+		int nt=i-1;
+		if (nt<0) nt=0;
+
+		for (SizeType s=sFrom;s<ns;s++) {
 			helper_.setPointer(threadId,s);
 			SizeType growOption = growthDirection(s,nt,i,threadId);
 			SparseMatrixType Onew(helper_.columns(threadId),helper_.columns(threadId));
@@ -0,0 +1,265 @@
+/*
+Copyright (c) 2009-2018, UT-Battelle, LLC
+All rights reserved
+
+[DMRG++, Version 3.0]
+[by G.A., Oak Ridge National Laboratory]
+
+UT Battelle Open Source Software License 11242008
+
+OPEN SOURCE LICENSE
+
+Subject to the conditions of this License, each
+contributor to this software hereby grants, free of
+charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), a
+perpetual, worldwide, non-exclusive, no-charge,
+royalty-free, irrevocable copyright license to use, copy,
+modify, merge, publish, distribute, and/or sublicense
+copies of the Software.
+
+1. Redistributions of Software must retain the above
+copyright and license notices, this list of conditions,
+and the following disclaimer.  Changes or modifications
+to, or derivative works of, the Software should be noted
+with comments and the contributor and organization's
+name.
+
+2. Neither the names of UT-Battelle, LLC or the
+Department of Energy nor the names of the Software
+contributors may be used to endorse or promote products
+derived from this software without specific prior written
+permission of UT-Battelle.
+
+3. The software and the end-user documentation included
+with the redistribution, with or without modification,
+must include the following acknowledgment:
+
+"This product includes software produced by UT-Battelle,
+LLC under Contract No. DE-AC05-00OR22725  with the
+Department of Energy."
+
+*********************************************************
+DISCLAIMER
+
+THE SOFTWARE IS SUPPLIED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER, CONTRIBUTORS, UNITED STATES GOVERNMENT,
+OR THE UNITED STATES DEPARTMENT OF ENERGY BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+NEITHER THE UNITED STATES GOVERNMENT, NOR THE UNITED
+STATES DEPARTMENT OF ENERGY, NOR THE COPYRIGHT OWNER, NOR
+ANY OF THEIR EMPLOYEES, REPRESENTS THAT THE USE OF ANY
+INFORMATION, DATA, APPARATUS, PRODUCT, OR PROCESS
+DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
+
+*********************************************************
+*/
+/** \ingroup DMRG */
+/*@{*/
+
+/*! \file CrsCodec.h
+ *
+ *  Compact in-memory encoding of sparse matrices in CRS format
+ *
+ *  Row lengths and column indices are stored as variable-length
+ *  integers, with columns as zigzag deltas within each row, so that
+ *  an index usually takes one or two bytes instead of eight.
+ *  Values are copied as they are, or rounded to single precision
+ *  if requested. Matrices are appended to a byte buffer, and are
+ *  decoded in the same order.
+ *
+ */
+#ifndef DMRG_CRS_CODEC_H
+#define DMRG_CRS_CODEC_H
+
+#include "Vector.h"
+#include "Complex.h"
+#include <cstring>
+
+namespace Dmrg {
+
+class CrsCodec {
+
+public:
+
+	typedef PsimagLite::Vector<unsigned char>::Type VectorByteType;
+
+	template<typename SparseMatrixType>
+	static void encode(VectorByteType& buffer,
+	                   const SparseMatrixType& m,
+	                   bool valuesAsFloat)
+	{
+		SizeType rows = m.rows();
+		putVarint(buffer, rows);
+		putVarint(buffer, m.cols());
+		putVarint(buffer, (valuesAsFloat) ? 1 : 0);
+
+		for (SizeType i = 0; i < rows; ++i) {
+			SizeType start = m.getRowPtr(i);
+			SizeType end = m.getRowPtr(i + 1);
+			putVarint(buffer, end - start);
+			long int prev = 0;
+			for (SizeType k = start; k < end; ++k) {
+				long int col = m.getCol(k);
+				putVarint(buffer, zigzag(col - prev));
+				prev = col;
+			}
+		}
+
+		SizeType nonzeros = (rows > 0) ? m.getRowPtr(rows) : 0;
+		for (SizeType k = 0; k < nonzeros; ++k)
+			putValue(buffer, m.getValue(k), valuesAsFloat);
+	}
+
+	// Decodes the matrix at pos, and moves pos past it
+	template<typename SparseMatrixType>
+	static void decode(SparseMatrixType& m,
+	                   const VectorByteType& buffer,
+	                   SizeType& pos)
+	{
+		typedef typename SparseMatrixType::value_type ValueType;
+
+		SizeType rows = getVarint(buffer, pos);
+		SizeType cols = getVarint(buffer, pos);
+		bool valuesAsFloat = (getVarint(buffer, pos) == 1);
+
+		m.resize(rows, cols);
+		SizeType nonzeros = 0;
+		for (SizeType i = 0; i < rows; ++i) {
+			m.setRow(i, nonzeros);
+			SizeType n = getVarint(buffer, pos);
+			long int col = 0;
+			for (SizeType k = 0; k < n; ++k) {
+				col += unzigzag(getVarint(buffer, pos));
+				m.pushCol(col);
+			}
+
+			nonzeros += n;
+		}
+
+		m.setRow(rows, nonzeros);
+
+		for (SizeType k = 0; k < nonzeros; ++k) {
+			ValueType value = 0.0;
+			getValue(value, buffer, pos, valuesAsFloat);
+			m.pushValue(value);
+		}
+
+		m.checkValidity();
+	}
+
+private:
+
+	static void putVarint(VectorByteType& buffer, SizeType x)
+	{
+		while (x >= 128) {
+			buffer.push_back(static_cast<unsigned char>(x & 127) | 128);
+			x >>= 7;
+		}
+
+		buffer.push_back(static_cast<unsigned char>(x));
+	}
+
+	static SizeType getVarint(const VectorByteType& buffer, SizeType& pos)
+	{
+		SizeType x = 0;
+		SizeType shift = 0;
+		while (true) {
+			if (pos >= buffer.size())
+				throw PsimagLite::RuntimeError("CrsCodec: truncated buffer\n");
+			unsigned char byte = buffer[pos++];
+			x |= static_cast<SizeType>(byte & 127) << shift;
+			if ((byte & 128) == 0) return x;
+			shift += 7;
+		}
+	}
+
+	static SizeType zigzag(long int x)
+	{
+		return (x < 0) ? 2*static_cast<SizeType>(-x) - 1 : 2*static_cast<SizeType>(x);
+	}
+
+	static long int unzigzag(SizeType x)
+	{
+		return (x & 1) ? -static_cast<long int>((x + 1)/2) : static_cast<long int>(x/2);
+	}
+
+	template<typename T>
+	static void putRaw(VectorByteType& buffer, const T& x)
+	{
+		SizeType pos = buffer.size();
+		buffer.resize(pos + sizeof(T));
+		memcpy(&buffer[pos], &x, sizeof(T));
+	}
+
+	template<typename T>
+	static void getRaw(T& x, const VectorByteType& buffer, SizeType& pos)
+	{
+		if (pos + sizeof(T) > buffer.size())
+			throw PsimagLite::RuntimeError("CrsCodec: truncated buffer\n");
+		memcpy(&x, &buffer[pos], sizeof(T));
+		pos += sizeof(T);
+	}
+
+	template<typename T>
+	static void putValue(VectorByteType& buffer, const T& value, bool valuesAsFloat)
+	{
+		if (!valuesAsFloat) return putRaw(buffer, value);
+		float x = value;
+		putRaw(buffer, x);
+	}
+
+	template<typename T>
+	static void putValue(VectorByteType& buffer,
+	                     const std::complex<T>& value,
+	                     bool valuesAsFloat)
+	{
+		if (!valuesAsFloat) return putRaw(buffer, value);
+		float x = PsimagLite::real(value);
+		float y = PsimagLite::imag(value);
+		putRaw(buffer, x);
+		putRaw(buffer, y);
+	}
+
+	template<typename T>
+	static void getValue(T& value,
+	                     const VectorByteType& buffer,
+	                     SizeType& pos,
+	                     bool valuesAsFloat)
+	{
+		if (!valuesAsFloat) return getRaw(value, buffer, pos);
+		float x = 0;
+		getRaw(x, buffer, pos);
+		value = x;
+	}
+
+	template<typename T>
+	static void getValue(std::complex<T>& value,
+	                     const VectorByteType& buffer,
+	                     SizeType& pos,
+	                     bool valuesAsFloat)
+	{
+		if (!valuesAsFloat) return getRaw(value, buffer, pos);
+		float x = 0;
+		float y = 0;
+		getRaw(x, buffer, pos);
+		getRaw(y, buffer, pos);
+		value = std::complex<T>(x, y);
+	}
+}; // class CrsCodec
+} // namespace Dmrg
+/*@}*/
+#endif // DMRG_CRS_CODEC_H
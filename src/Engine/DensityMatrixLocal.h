@@ -79,6 +79,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "NoPthreads.h"
 #include "Concurrency.h"
 #include "Parallelizer.h"
+#include "ThreadPool.h"
 #include "DiagBlockDiagMatrix.h"
 
 namespace Dmrg {
@@ -108,7 +109,7 @@ public:
 	typedef ParallelDensityMatrix<BlockDiagonalMatrixType,
 	BasisWithOperatorsType,
 	TargetVectorType> ParallelDensityMatrixType;
-	typedef PsimagLite::Parallelizer<ParallelDensityMatrixType> ParallelizerType;
+	typedef ParallelizerPool<ParallelDensityMatrixType> ParallelizerType;
 
 	DensityMatrixLocal(const TargettingType& target,
 	                   const LeftRightSuperType& lrs,
@@ -85,6 +85,9 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "DensityMatrixBase.h"
 #include "ProgramGlobals.h"
 #include "DiagBlockDiagMatrix.h"
+#include "ParallelDensityMatrixSu2.h"
+#include "Concurrency.h"
+#include "ThreadPool.h"
 
 namespace Dmrg {
 template<typename TargettingType>
@@ -100,6 +103,10 @@ class DensityMatrixSu2 : public DensityMatrixBase<TargettingType> {
 	typedef typename BasisType::FactorsType FactorsType;
 	typedef typename PsimagLite::Real<DensityMatrixElementType>::Type RealType;
 	typedef typename DensityMatrixBase<TargettingType>::Params ParamsType;
+	typedef ParallelDensityMatrixSu2<BlockDiagonalMatrixType,
+	BasisWithOperatorsType,
+	TargettingType> ParallelDensityMatrixSu2Type;
+	typedef ParallelizerThreads<ParallelDensityMatrixSu2Type> ParallelizerType;
 
 public:
 
@@ -116,7 +123,6 @@ public:
 	      verbose_(p.verbose)
 	{
 		check(p.direction);
-		BuildingBlockType matrixBlock;
 
 		const BasisWithOperatorsType& pBasisSummed =
 		        (p.direction == ProgramGlobals::EXPAND_SYSTEM) ? lrs.right() :
@@ -125,28 +131,24 @@ public:
 		for (SizeType m = 0; m < pBasis_.partition() - 1; ++m) {
 			// Definition: Given partition p with (j m)
 			// findMaximalPartition(p) returns the partition p' (with j,j)
-
-			if (BasisType::useSu2Symmetry()) {
+			// we'll fill non-maximal partitions later
+			if (BasisType::useSu2Symmetry())
 				mMaximal_[m] = findMaximalPartition(m,pBasis_);
-				//if (enforceSymmetry && SizeType(m)!=mMaximal_[m]) continue;
-				// we'll fill non-maximal partitions later
-			}
-
-			SizeType bs = pBasis_.partition(m+1)-pBasis_.partition(m);
-
-			matrixBlock.reset(bs,bs);
-
-			for (SizeType i=pBasis_.partition(m);i<pBasis_.partition(m+1);i++) {
-				for (SizeType j=pBasis_.partition(m);j<pBasis_.partition(m+1);j++) {
-
-					matrixBlock(i-pBasis_.partition(m),j-pBasis_.partition(m))=
-					        densityMatrixAux(i,j,target,pBasisSummed,lrs.super(),p.direction);
+		}
 
-				}
-			}
+		typename ParallelDensityMatrixSu2Type::VectorBuildingBlockType blocks;
+		ParallelDensityMatrixSu2Type helperDm(target,
+		                                      pBasis_,
+		                                      pBasisSummed,
+		                                      lrs.super(),
+		                                      p.direction,
+		                                      blocks);
+		// every rank needs all blocks, so split them among threads only
+		ParallelizerType threadedDm(PsimagLite::Concurrency::npthreads);
+		threadedDm.loopCreate(helperDm, helperDm.weights());
 
-			data_.setBlock(m,pBasis_.partition(m),matrixBlock);
-		}
+		for (SizeType m = 0; m < blocks.size(); ++m)
+			data_.setBlock(m,pBasis_.partition(m),blocks[m]);
 
 		if (verbose_) {
 			std::cerr<<"DENSITYMATRIXPRINT option="<<p.direction<<"\n";
@@ -255,84 +257,6 @@ private:
 		return true;
 	}
 
-	DensityMatrixElementType densityMatrixAux(SizeType alpha1,
-	                                          SizeType alpha2,
-	                                          const TargettingType& target,
-	                                          const BasisWithOperatorsType& pBasisSummed,
-	                                          const BasisType& pSE,
-	                                          ProgramGlobals::DirectionEnum direction)
-	{
-		DensityMatrixElementType sum=0;
-		// The g.s. has to be treated separately because it's
-		// usually a vector of RealType, whereas
-		// the other targets might be complex,
-		// and C++ generic programming capabilities are weak... we need D!!!
-		if (target.includeGroundStage())
-			sum +=  densityMatrixHasFactors(alpha1,
-			                                alpha2,
-			                                target.gs(),
-			                                pBasisSummed,
-			                                pSE,
-			                                direction)*target.gsWeight();
-
-		for (SizeType i = 0; i < target.size(); ++i)
-			sum += densityMatrixHasFactors(alpha1,
-			                               alpha2,
-			                               target(i),
-			                               pBasisSummed,
-			                               pSE,
-			                               direction)*target.weight(i)/target.normSquared(i);
-
-		return sum;
-	}
-
-	template<typename TargetVectorType>
-	DensityMatrixElementType densityMatrixHasFactors(SizeType alpha1,
-	                                                 SizeType alpha2,
-	                                                 const TargetVectorType& v,
-	                                                 const BasisWithOperatorsType& pBasisSummed,
-	                                                 const BasisType& pSE,
-	                                                 ProgramGlobals::DirectionEnum direction)
-	{
-		int ne = pBasisSummed.size();
-		int ns = pSE.size()/ne;
-		SizeType total=pBasisSummed.size();
-		if (direction != ProgramGlobals::EXPAND_SYSTEM) {
-			ns=pBasisSummed.size();
-			ne=pSE.size()/ns;
-		}
-
-		DensityMatrixElementType sum=0;
-
-		// Make sure we don't copy just get the reference here!!
-		const FactorsType& factors = pSE.getFactors();
-
-		for (SizeType beta=0;beta<total;beta++) {
-			// sum over environ:
-			int i1 = alpha1+beta*ns;
-			int i2 = alpha2+beta*ns;
-			// sum over system:
-			if (direction != ProgramGlobals::EXPAND_SYSTEM) {
-				i1 = beta + alpha1*ns;
-				i2 = beta + alpha2*ns;
-			}
-			for (int k1=factors.getRowPtr(i1);k1<factors.getRowPtr(i1+1);k1++) {
-				int eta1 = factors.getCol(k1);
-				int ii = pSE.permutationInverse(eta1);
-				for (int k2=factors.getRowPtr(i2);k2<factors.getRowPtr(i2+1);k2++) {
-					int eta2 =  factors.getCol(k2);
-					int jj = pSE.permutationInverse(eta2);
-
-					DensityMatrixElementType tmp3= v.slowAccess(ii)*
-					        PsimagLite::conj(v.slowAccess(jj)) *
-					        factors.getValue(k1) * factors.getValue(k2);
-					sum += tmp3;
-				}
-			}
-		}
-		return sum;
-	}
-
 	//! only used for debugging
 	void check(SizeType p1,
 	           const BuildingBlockType& bp1,
@@ -76,17 +76,29 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Stack.h"
 #include "IoSimple.h"
 #include "ProgressIndicator.h"
+#include <sys/stat.h>
+#include <unistd.h>
 
 // A disk stack, similar to std::stack but stores in disk not in memory
+// The trailer lists where in the file each entry ends, so that
+// LazyDiskStack can read the entries in any order
 namespace Dmrg {
+
+template<typename DataType>
+class LazyDiskStack;
+
 template<typename DataType>
 class DiskStack {
 
 	typedef typename PsimagLite::IoSimple::In IoInType;
 	typedef typename PsimagLite::IoSimple::Out IoOutType;
 
+	friend class LazyDiskStack<DataType>;
+
 public:
 
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+
 	DiskStack(const PsimagLite::String &file1,
 	          const PsimagLite::String &file2,
 	          bool hasLoad,
@@ -111,6 +123,12 @@ public:
 		int x = 0;
 		ioIn_.readline(x,"#STACKMETARANK=",IoInType::LAST_INSTANCE);
 		ioIn_.read(stack_, "#STACKMETASTACK");
+		try {
+			ioIn_.read(endsIn_, "#STACKMETAENDS");
+		} catch (std::exception&) {
+			endsIn_.clear(); // written before the trailer had the ends
+		}
+
 		ioIn_.close();
 		PsimagLite::OstringStream msg;
 		msg<<"Attempt to read from file " + fileIn_ + " succeeded";
@@ -139,6 +157,7 @@ public:
 		ioOut_.open(fileOut_,std::ios_base::app);
 		d.save(ioOut_,DataType::SAVE_ALL);
 		ioOut_.close();
+		endsOut_.push_back(fileSize(fileOut_));
 
 		stack_.push(total_);
 		total_++;
@@ -206,11 +225,42 @@ public:
 		ioIn_.close();
 	}
 
+	// The trailer that finalize() writes, for writers of the same format
+	static void printMeta(PsimagLite::IoSimple::Out& io,
+	                      int total,
+	                      const PsimagLite::Stack<int>::Type& st,
+	                      PsimagLite::String label)
+	{
+		int x = 0;
+		io.printline("#STACKMETARANK="+ttos(x));
+		io.printline("#STACKMETATOTAL="+ttos(total));
+		SizeType last = label.length();
+		assert(last > 0);
+		if (last > 0 && label[last - 1] != '\n') label += "\n";
+		io.print(label, st);
+	}
+
+	// Where in the file each entry ends, entries in the order written
+	static void printEnds(PsimagLite::IoSimple::Out& io, const VectorSizeType& ends)
+	{
+		io.printVector(ends, "#STACKMETAENDS");
+	}
+
+	static SizeType fileSize(PsimagLite::String file)
+	{
+		struct stat buf;
+		if (stat(file.c_str(), &buf) != 0)
+			throw PsimagLite::RuntimeError("DiskStack: cannot stat " + file + "\n");
+		return buf.st_size;
+	}
+
 	friend void copyDiskToDisk(DiskStack& dest, const DiskStack& src)
 	{
 		dest.isObserveCode_ = src.isObserveCode_;
 		dest.total_ = src.total_;
 		dest.stack_ = src.stack_;
+		dest.endsIn_ = src.endsIn_;
+		dest.endsOut_ = src.endsOut_;
 		// copy src.fileIn_ --> dest.fileIn_
 		myCopy(src.fileIn_, dest.fileIn_);
 		// copy src.fileOut_ --> dest.fileOut_
@@ -239,13 +289,8 @@ private:
 	void finalizeInternal(PsimagLite::IoSimple::Out& io,
 	                      PsimagLite::String label) const
 	{
-		int x = 0;
-		io.printline("#STACKMETARANK="+ttos(x));
-		io.printline("#STACKMETATOTAL="+ttos(total_));
-		SizeType last = label.length();
-		assert(last > 0);
-		if (last > 0 && label[last - 1] != '\n') label += "\n";
-		io.print(label, stack_);
+		printMeta(io, total_, stack_, label);
+		printEnds(io, endsOut_);
 	}
 
 	void invertStack(PsimagLite::Stack<int>::Type& st)
@@ -268,6 +313,8 @@ private:
 	mutable IoInType ioIn_;
 	IoOutType ioOut_;
 	PsimagLite::Stack<int>::Type stack_;
+	VectorSizeType endsIn_;
+	VectorSizeType endsOut_;
 	mutable DataType* dt_;
 }; // class DiskStack
 
@@ -83,6 +83,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "IoSimple.h"
 #include "FermionSign.h"
 #include "ProgramGlobals.h"
+#include "BinaryStore.h"
 
 namespace Dmrg {
 // Move also checkpointing from DmrgSolver to here (FIXME)
@@ -128,7 +129,15 @@ public:
 		PsimagLite::String s = "#WAVEFUNCTION_sites=";
 		wavefunction_.load(io,s);
 		s = "#TRANSFORM_sites=";
-		io.readMatrix(transform_,s);
+		const BinaryStore::In* bin = BinaryStore::reader(io.filename());
+		if (bin) {
+			BinaryStore::OffsetType offset = 0;
+			io.readline(offset,"#TRANSFORM" + BinaryStore::label());
+			BinaryStore::readCrs(transform_,*bin,offset);
+		} else {
+			io.readMatrix(transform_,s);
+		}
+
 		transposeConjugate(transformC_,transform_);
 		s = "#DIRECTION=";
 		io.readline(direction_,s);
@@ -158,7 +167,15 @@ public:
 		for (SizeType i=0;i<lrs_.left().block().size();i++) {
 			label += ttos(lrs_.left().block()[i])+",";
 		}
-		io.printMatrix(transform_,label);
+		BinaryStore::Out* bin = BinaryStore::writer(io.filename());
+		if (bin) {
+			io.printline(label);
+			BinaryStore::OffsetType offset = BinaryStore::writeCrs(*bin,transform_);
+			io.printline("#TRANSFORM" + BinaryStore::label() + ttos(offset));
+		} else {
+			io.printMatrix(transform_,label);
+		}
+
 		PsimagLite::String s = "#DIRECTION="+ttos(direction_);
 		io.printline(s);
 //		io.print("#DIRECTION=",direction_);
@@ -85,6 +85,8 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Diagonalization.h"
 #include "ProgressIndicator.h"
 #include "DmrgSerializer.h"
+#include "SerializerIndex.h"
+#include "BinaryStore.h"
 #include "Recovery.h"
 #include "Truncation.h"
 #include "ObservablesInSitu.h"
@@ -101,6 +103,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "TargetingRixsDynamic.h"
 #include "PsiBase64.h"
 #include "PrinterInDetail.h"
+#include "Arena.h"
 
 namespace Dmrg {
 
@@ -212,12 +215,18 @@ public:
 	                model.geometry().maxConnections(),
 	                verbose_),
 	      energy_(0.0),
-	      saveData_(parameters_.options.find("noSaveData") == PsimagLite::String::npos)
+	      saveData_(parameters_.options.find("noSaveData") == PsimagLite::String::npos),
+	      serializerStep_(0)
 	{
 		std::cout<<appInfo_;
 		PsimagLite::OstringStream msg;
 		msg<<"Turning the engine on";
 		progress_.printline(msg,std::cout);
+
+		bool binaryData = (parameters_.options.find("binaryData") != PsimagLite::String::npos);
+		bool compress = (parameters_.options.find("binaryDataCompress") != PsimagLite::String::npos);
+		BinaryStore::openWriter(parameters_.filename, binaryData && saveData_, compress);
+
 		ioOut_.print(appInfo_);
 
 		PsimagLite::PsiBase64::Encode base64encode(ioIn.data());
@@ -233,6 +242,7 @@ public:
 	{
 		Finalize finalize(appInfo_);
 		ioOut_.action(finalize);
+		BinaryStore::closeWriter(parameters_.filename);
 
 		PsimagLite::OstringStream msg2;
 		msg2<<"Turning off the engine.";
@@ -419,6 +429,7 @@ private:
 				                 ProgramGlobals::SYSTEM);
 			}
 
+			ArenaStep::next();
 			progress_.printMemoryUsage();
 		}
 		progress_.print("Infinite dmrg loop has been done!\n",std::cout);
@@ -575,6 +586,7 @@ private:
 			printEnergy(energy_);
 
 			changeTruncateAndSerialize(pS,pE,target,keptStates,direction,saveOption);
+			target.truncationError(truncate_.error());
 
 			if (finalStep(stepLength,stepFinal)) break;
 			if (stepCurrent_<0) {
@@ -582,6 +594,7 @@ private:
 				throw PsimagLite::RuntimeError(msg + " currentStep_ is negative\n");
 			}
 
+			ArenaStep::next();
 			progress_.printMemoryUsage();
 
 			if (target.end()) break;
@@ -640,6 +653,10 @@ private:
 		truncate_.transform(direction).toSparse(transform);
 		DmrgSerializerType ds(fsS,fsE,lrs_,target.gs(),transform,direction);
 
+		// lets observe find a step without parsing the ones before it
+		PsimagLite::String marker = SerializerIndex::label() + ttos(serializerStep_++);
+		ioOut_.printline(marker);
+
 		SizeType saveOption2 = (saveOption & 4) ? SAVE_ALL : SAVE_PARTIAL;
 		ds.save(ioOut_,saveOption2,model_.geometry().numberOfSites());
 
@@ -734,6 +751,7 @@ private:
 	ObservablesInSituType inSitu_;
 	RealType energy_;
 	bool saveData_;
+	SizeType serializerStep_;
 }; //class DmrgSolver
 } // namespace Dmrg
 
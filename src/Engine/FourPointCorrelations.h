@@ -107,6 +107,7 @@ public:
 	typedef typename ObserverHelperType::MatrixType MatrixType;
 	typedef PsimagLite::Vector<char>::Type VectorCharType;
 	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef typename PsimagLite::Vector<FieldType>::Type VectorFieldType;
 	typedef typename PsimagLite::Vector<SparseMatrixType>::Type VectorSparseMatrixType;
 	typedef typename CorrelationsSkeletonType::BraketType BraketType;
 
@@ -286,52 +287,18 @@ public:
 			std::cerr<<Otmp;
 		}
 
-		SparseMatrixType O3g,O4g;
-		if (i4==skeleton_.numberOfSites(threadId)-1) {
-			if (i3<i4-1) { // not tested
-				std::cerr<<PsimagLite::AnsiColor::red;
-				std::cerr<<"WARNING: This code path might give WRONG results";
-				std::cerr<<PsimagLite::AnsiColor::reset<<"\n";
-
-				skeleton_.dmrgMultiply(O3g,Otmp,O3m,braket.op(index0).fermionSign,ns,threadId);
-
-				SparseMatrixType O3gt;
-				helper_.transform(O3gt,O3g,threadId);
-
-				ns = i4-2;
-				if (ns<0) ns = 0;
-				helper_.setPointer(threadId,ns);
-				growDirectly4p(Otmp,O3gt,i3+1,braket.op(index0).fermionSign,ns,threadId);
-				helper_.setPointer(threadId,i4-2);
-
-				return skeleton_.bracketRightCorner(Otmp,
-				                                    O4m,
-				                                    braket.op(index1).fermionSign,
-				                                    threadId);
-			}
-
-			helper_.setPointer(threadId,i4-2);
-			return skeleton_.bracketRightCorner(Otmp,
-			                                    O3m,
-			                                    O4m,
-			                                    braket.op(index1).fermionSign,
-			                                    threadId);
-		}
-
-		skeleton_.dmrgMultiply(O3g,Otmp,O3m,braket.op(index0).fermionSign,ns,threadId);
-		if (verbose_) {
-			std::cerr<<"O3g\n";
-			std::cerr<<O3g;
-		}
-
-		helper_.setPointer(threadId,ns);
+		if (i4==skeleton_.numberOfSites(threadId)-1)
+			return secondStageCorner(Otmp,
+			                         i3,
+			                         i4,
+			                         O3m,
+			                         O4m,
+			                         braket.op(index0).fermionSign,
+			                         braket.op(index1).fermionSign,
+			                         threadId);
 
 		SparseMatrixType O3gt;
-		helper_.transform(O3gt,O3g,threadId);
-		if (verbose_) {
-			std::cerr<<"O3gt\n";
-			std::cerr<<O3gt;
-		}
+		multiplyAndTransform(O3gt,Otmp,i3,O3m,braket.op(index0).fermionSign,threadId);
 
 		ns = i4-1;
 		if (ns<0) ns = 0;
@@ -342,8 +309,113 @@ public:
 			std::cerr<<Otmp;
 		}
 
-		skeleton_.dmrgMultiply(O4g,Otmp,O4m,braket.op(index1).fermionSign,ns,threadId);
-		return skeleton_.bracket(O4g,braket.op(index1).fermionSign,threadId);
+		return bracketLast(Otmp,i4,O4m,braket.op(index1).fermionSign,threadId);
+	}
+
+	//! 3-point for fixed i1, and all i2, i3 with i1<i2<i3, i2<rows and i3<cols
+	//! Results are appended to values in that loop order
+	//! O1 is grown once and extended site by site as i2 increases, and
+	//! so is O1*O2 as i3 increases; nothing is regrown from scratch
+	void threePoint(VectorFieldType& values,
+	                SizeType i1,
+	                SizeType rows,
+	                SizeType cols,
+	                const BraketType& braket,
+	                SizeType threadId) const
+	{
+		SparseMatrixType O1g,O2m,O3m;
+		skeleton_.createWithModification(O1g,braket.op(0).data,'N');
+		skeleton_.createWithModification(O2m,braket.op(1).data,'N');
+		skeleton_.createWithModification(O3m,braket.op(2).data,'N');
+
+		int nt = i1-1;
+		if (nt<0) nt = 0;
+		SizeType grown1 = nt;
+		for (SizeType i2 = i1+1; i2 < rows; ++i2) {
+			SizeType ns = i2-1;
+			skeleton_.growDirectlyFrom(O1g,
+			                           i1,
+			                           braket.op(0).fermionSign,
+			                           grown1,
+			                           ns,
+			                           true,
+			                           threadId);
+			grown1 = ns;
+
+			SparseMatrixType Otmp;
+			SparseMatrixType O2g;
+			skeleton_.dmrgMultiply(O2g,O1g,O2m,braket.op(1).fermionSign,ns,threadId);
+			helper_.setPointer(threadId,ns);
+			helper_.transform(Otmp,O2g,threadId);
+
+			SizeType grown2 = i2;
+			for (SizeType i3 = i2+1; i3 < cols; ++i3) {
+				ns = i3-1;
+				growDirectly4pFrom(Otmp,braket.op(1).fermionSign,grown2,ns,threadId);
+				grown2 = ns;
+				values.push_back(bracketLast(Otmp,
+				                             i3,
+				                             O3m,
+				                             braket.op(2).fermionSign,
+				                             threadId));
+			}
+		}
+	}
+
+	//! 4-point for fixed i1<i2, and all i3, i4 with i2<i3<i4, i3<rows and i4<cols
+	//! Results are appended to values in that loop order
+	//! The first stage is done once, and the grown O1*O2 and O1*O2*O3
+	//! are extended site by site as i3 and i4 increase
+	void fourPoint(VectorFieldType& values,
+	               SizeType i1,
+	               SizeType i2,
+	               SizeType rows,
+	               SizeType cols,
+	               const BraketType& braket,
+	               SizeType threadId) const
+	{
+		SparseMatrixType Otmp;
+		firstStage(Otmp,'N',i1,'N',i2,braket,0,1,threadId);
+
+		SparseMatrixType O3m,O4m;
+		skeleton_.createWithModification(O3m,braket.op(2).data,'N');
+		skeleton_.createWithModification(O4m,braket.op(3).data,'N');
+		int fermionS3 = braket.op(2).fermionSign;
+		int fermionS4 = braket.op(3).fermionSign;
+		SizeType last = skeleton_.numberOfSites(threadId)-1;
+
+		SizeType grown2 = i2;
+		for (SizeType i3 = i2+1; i3 < rows; ++i3) {
+			growDirectly4pFrom(Otmp,braket.op(1).fermionSign,grown2,i3-1,threadId);
+			grown2 = i3-1;
+
+			SparseMatrixType Otmp3;
+			SizeType grown3 = 0;
+			bool hasOtmp3 = false;
+			for (SizeType i4 = i3+1; i4 < cols; ++i4) {
+				if (i4 == last) {
+					values.push_back(secondStageCorner(Otmp,
+					                                   i3,
+					                                   i4,
+					                                   O3m,
+					                                   O4m,
+					                                   fermionS3,
+					                                   fermionS4,
+					                                   threadId));
+					continue;
+				}
+
+				if (!hasOtmp3) {
+					multiplyAndTransform(Otmp3,Otmp,i3,O3m,fermionS3,threadId);
+					grown3 = i3;
+					hasOtmp3 = true;
+				}
+
+				growDirectly4pFrom(Otmp3,fermionS3,grown3,i4-1,threadId);
+				grown3 = i4-1;
+				values.push_back(bracketLast(Otmp3,i4,O4m,fermionS4,threadId));
+			}
+		}
 	}
 
 	//! requires i2<i3<i4
@@ -418,24 +490,90 @@ private:
 			std::cerr<<Otmp;
 		}
 
-		if (i3 == skeleton_.numberOfSites(threadId)-1) {
-			helper_.setPointer(threadId,i3-2);
-			return skeleton_.bracketRightCorner(Otmp,
-			                                    O3m,
-			                                    braket.op(index).fermionSign,
-			                                    threadId);
+		return bracketLast(Otmp,i3,O3m,braket.op(index).fermionSign,threadId);
+	}
+
+	//! Otmp must have been grown up to i3-1, and i4 must be the last site
+	FieldType secondStageCorner(const SparseMatrixType& Otmp,
+	                            SizeType i3,
+	                            SizeType i4,
+	                            const SparseMatrixType& O3m,
+	                            const SparseMatrixType& O4m,
+	                            int fermionS3,
+	                            int fermionS4,
+	                            SizeType threadId) const
+	{
+		if (i3<i4-1) { // not tested
+			std::cerr<<PsimagLite::AnsiColor::red;
+			std::cerr<<"WARNING: This code path might give WRONG results";
+			std::cerr<<PsimagLite::AnsiColor::reset<<"\n";
+
+			SparseMatrixType O3gt;
+			multiplyAndTransform(O3gt,Otmp,i3,O3m,fermionS3,threadId);
+
+			int ns = i4-2;
+			if (ns<0) ns = 0;
+			helper_.setPointer(threadId,ns);
+			SparseMatrixType Otmp2;
+			growDirectly4p(Otmp2,O3gt,i3+1,fermionS3,ns,threadId);
+			helper_.setPointer(threadId,i4-2);
+
+			return skeleton_.bracketRightCorner(Otmp2,O4m,fermionS4,threadId);
+		}
+
+		helper_.setPointer(threadId,i4-2);
+		return skeleton_.bracketRightCorner(Otmp,O3m,O4m,fermionS4,threadId);
+	}
+
+	//! Otmp must have been grown up to i-1
+	void multiplyAndTransform(SparseMatrixType& Ogt,
+	                          const SparseMatrixType& Otmp,
+	                          SizeType i,
+	                          const SparseMatrixType& Om,
+	                          int fermionS,
+	                          SizeType threadId) const
+	{
+		int ns = i-1;
+		if (ns<0) ns = 0;
+		SparseMatrixType Og;
+		skeleton_.dmrgMultiply(Og,Otmp,Om,fermionS,ns,threadId);
+		if (verbose_) {
+			std::cerr<<"O3g\n";
+			std::cerr<<Og;
 		}
 
 		helper_.setPointer(threadId,ns);
-		SparseMatrixType O3g;
-		skeleton_.dmrgMultiply(O3g,Otmp,O3m,braket.op(index).fermionSign,ns,threadId);
+		helper_.transform(Ogt,Og,threadId);
+		if (verbose_) {
+			std::cerr<<"O3gt\n";
+			std::cerr<<Ogt;
+		}
+	}
+
+	//! Otmp must have been grown up to i-1
+	FieldType bracketLast(const SparseMatrixType& Otmp,
+	                      SizeType i,
+	                      const SparseMatrixType& Om,
+	                      int fermionS,
+	                      SizeType threadId) const
+	{
+		if (i == skeleton_.numberOfSites(threadId)-1) {
+			helper_.setPointer(threadId,i-2);
+			return skeleton_.bracketRightCorner(Otmp,Om,fermionS,threadId);
+		}
+
+		int ns = i-1;
+		if (ns<0) ns = 0;
+		helper_.setPointer(threadId,ns);
+		SparseMatrixType Og;
+		skeleton_.dmrgMultiply(Og,Otmp,Om,fermionS,ns,threadId);
 		if (verbose_) {
 			std::cerr<<"O3g\n";
-			std::cerr<<O3g;
+			std::cerr<<Og;
 		}
 
 		helper_.setPointer(threadId,ns);
-		return skeleton_.bracket(O3g,braket.op(index).fermionSign,threadId);
+		return skeleton_.bracket(Og,fermionS,threadId);
 	}
 
 	//! i can be zero here!!
@@ -452,7 +590,17 @@ private:
 		int nt=i-1;
 		if (nt<0) nt=0;
 
-		for (SizeType s=nt;s<ns;s++) {
+		growDirectly4pFrom(Odest,fermionicSign,nt,ns,threadId);
+	}
+
+	//! Continues a growDirectly4p(...) that stopped at sFrom, up to ns
+	void growDirectly4pFrom(SparseMatrixType& Odest,
+	                        int fermionicSign,
+	                        SizeType sFrom,
+	                        SizeType ns,
+	                        SizeType threadId) const
+	{
+		for (SizeType s=sFrom;s<ns;s++) {
 			helper_.setPointer(threadId,s);
 			int growOption = GROW_RIGHT;
 
@@ -82,6 +82,8 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Concurrency.h"
 #include <cassert>
 #include "ProgramGlobals.h"
+#include "Arena.h"
+#include <algorithm>
 
 namespace Dmrg {
 
@@ -101,6 +103,22 @@ public:
 	typedef typename PsimagLite::Vector<VectorType>::Type VectorVectorType;
 	typedef typename PsimagLite::Concurrency ConcurrencyType;
 
+	// One term A x B of the connection, with A and B operators of the helper
+	struct ConnectionType {
+
+		ConnectionType(const SparseMatrixType* A1,
+		               const SparseMatrixType* B1,
+		               const LinkType& link1)
+		    : A(A1),B(B1),link(link1)
+		{}
+
+		const SparseMatrixType* A;
+		const SparseMatrixType* B;
+		LinkType link;
+	};
+
+	typedef typename PsimagLite::Vector<ConnectionType>::Type VectorConnectionType;
+
 	HamiltonianConnection(const GeometryType& geometry,
 	                      const ModelHelperType& modelHelper,
 	                      const LinkProductStructType* lps = 0,
@@ -178,6 +196,44 @@ public:
 		return flag;
 	}
 
+	// All the terms of the connection of the superblock; they do not
+	// depend on the partition of the helper
+	void connections(VectorConnectionType& v) const
+	{
+		LinkProductStructType lps;
+		LinkProductStructType lpsOne(ProgramGlobals::MAX_LPS);
+		SizeType n = modelHelper_.leftRightSuper().super().block().size();
+		for (SizeType i = 0; i < n; ++i) {
+			for (SizeType j = 0; j < n; ++j) {
+				SizeType totalOne = 0;
+				compute(i,j,0,&lpsOne,totalOne);
+				lps.push(lpsOne,totalOne);
+			}
+		}
+
+		v.clear();
+		AdditionalDataType additionalData;
+		for (SizeType ix = 0; ix < lps.typesaved.size(); ++ix) {
+			SizeType i = lps.isaved[ix];
+			SizeType j = lps.jsaved[ix];
+			SizeType term = lps.termsaved[ix];
+			SizeType ind = modelHelper_.leftRightSuper().super().block()[i];
+			SizeType jnd = modelHelper_.leftRightSuper().super().block()[j];
+			geometry_.fillAdditionalData(additionalData,term,ind,jnd);
+			const SparseMatrixType* A = 0;
+			const SparseMatrixType* B = 0;
+			LinkType link2 = getKron(&A,&B,
+			                         i,
+			                         j,
+			                         lps.typesaved[ix],
+			                         lps.tmpsaved[ix],
+			                         term,
+			                         lps.dofssaved[ix],
+			                         additionalData);
+			v.push_back(ConnectionType(A,B,link2));
+		}
+	}
+
 	void doTask(SizeType taskNumber ,SizeType threadNum)
 	{
 		if (xtemp_[threadNum].size() != x_.size())
@@ -218,7 +274,10 @@ public:
 		for (SizeType threadNum = 0; threadNum < xtemp_.size(); threadNum++)
 			if (xtemp_[threadNum].size() == x_.size()) total++;
 
-		typename PsimagLite::Vector<SparseElementType>::Type x(x_.size(),0);
+		// after the parallel loop, on its calling thread, thus thread 0
+		typename Arena<SparseElementType>::Buffer xBuffer(x_.size());
+		typename Arena<SparseElementType>::VectorType& x = xBuffer();
+		std::fill(x.begin(), x.end(), 0.0);
 		for (SizeType threadNum = 0; threadNum < total; threadNum++)
 			for (SizeType i=0;i<x_.size();i++)
 				x[i]+=xtemp_[threadNum][i];
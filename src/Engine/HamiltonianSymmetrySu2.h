@@ -87,6 +87,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "JmSubspace.h"
 #include "ProgramGlobals.h"
 #include "CrsMatrix.h"
+#include "Su2SymmetryGlobals.h"
 
 namespace Dmrg {
 
@@ -148,6 +149,10 @@ public:
 		SizeType ns = symm1.jmValues_.size();
 		SizeType ne = symm2.jmValues_.size();
 
+		// the product reaches j1+j2; tabulate the coefficients up to there
+		if (symm1.jMax_>0 && symm2.jMax_>0)
+			Su2SymmetryGlobals<RealType>::clebschGordanObject.grow(symm1.jMax_+symm2.jMax_-2);
+
 		JmSubspaceType::setToProduct(&symm1,&symm2,electrons1,electrons2);
 
 		findAllowedJm(symm1,symm2,electrons1,electrons2,pseudoQn);;
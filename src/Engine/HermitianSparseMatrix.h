@@ -0,0 +1,561 @@
+/*
+Copyright (c) 2009-2018, UT-Battelle, LLC
+All rights reserved
+
+[DMRG++, Version 3.0]
+[by G.A., Oak Ridge National Laboratory]
+
+UT Battelle Open Source Software License 11242008
+
+OPEN SOURCE LICENSE
+
+Subject to the conditions of this License, each
+contributor to this software hereby grants, free of
+charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), a
+perpetual, worldwide, non-exclusive, no-charge,
+royalty-free, irrevocable copyright license to use, copy,
+modify, merge, publish, distribute, and/or sublicense
+copies of the Software.
+
+1. Redistributions of Software must retain the above
+copyright and license notices, this list of conditions,
+and the following disclaimer.  Changes or modifications
+to, or derivative works of, the Software should be noted
+with comments and the contributor and organization's
+name.
+
+2. Neither the names of UT-Battelle, LLC or the
+Department of Energy nor the names of the Software
+contributors may be used to endorse or promote products
+derived from this software without specific prior written
+permission of UT-Battelle.
+
+3. The software and the end-user documentation included
+with the redistribution, with or without modification,
+must include the following acknowledgment:
+
+"This product includes software produced by UT-Battelle,
+LLC under Contract No. DE-AC05-00OR22725  with the
+Department of Energy."
+
+*********************************************************
+DISCLAIMER
+
+THE SOFTWARE IS SUPPLIED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER, CONTRIBUTORS, UNITED STATES GOVERNMENT,
+OR THE UNITED STATES DEPARTMENT OF ENERGY BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+NEITHER THE UNITED STATES GOVERNMENT, NOR THE UNITED
+STATES DEPARTMENT OF ENERGY, NOR THE COPYRIGHT OWNER, NOR
+ANY OF THEIR EMPLOYEES, REPRESENTS THAT THE USE OF ANY
+INFORMATION, DATA, APPARATUS, PRODUCT, OR PROCESS
+DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
+
+*********************************************************
+*/
+/** \ingroup DMRG */
+/*@{*/
+
+/*! \file HermitianSparseMatrix.h
+ *
+ *  A Hermitian sparse matrix that stores only its diagonal and
+ *  its strict upper triangle, in CRS.
+ *  It is built from a source that gives one row at a time, of which
+ *  only the diagonal and the upper triangle are kept, so neither the
+ *  full matrix nor a list of terms is ever stored. The rows are first
+ *  counted, from their columns only, and then filled in place.
+ *  Rows are grouped in blocks of about the same number of nonzeros,
+ *  and both construction and matrixVectorProduct run one task per block.
+ *  matrixVectorProduct accumulates into one buffer per thread, because
+ *  the lower triangle contributes to rows of other blocks; the buffers
+ *  are summed at the end, and then reduced across MPI ranks.
+ */
+#ifndef DMRG_HERMITIAN_SPARSE_MATRIX_H
+#define DMRG_HERMITIAN_SPARSE_MATRIX_H
+
+#include <algorithm>
+#include <cmath>
+#include "Vector.h"
+#include "CrsMatrix.h"
+#include "Complex.h"
+#include "Mpi.h"
+#include "Concurrency.h"
+#include "Parallelizer.h"
+#include "ThreadPool.h"
+
+namespace Dmrg {
+
+template<typename ComplexOrRealType>
+class HermitianSparseMatrix {
+
+	typedef PsimagLite::CrsMatrix<ComplexOrRealType> SparseMatrixType;
+	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
+	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+	typedef typename PsimagLite::Vector<VectorType>::Type VectorVectorType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef typename PsimagLite::Vector<VectorSizeType>::Type VectorVectorSizeType;
+	typedef PsimagLite::Concurrency ConcurrencyType;
+
+	// blocks per thread, so that no thread waits much on the slowest block
+	static const SizeType BLOCKS_PER_THREAD = 4;
+
+	// A CRS matrix as a source of rows
+	class CrsRows {
+
+	public:
+
+		CrsRows(const SparseMatrixType& m) : m_(m) {}
+
+		SizeType rows() const { return m_.rows(); }
+
+		void row(VectorSizeType& cols, VectorType* values, SizeType i) const
+		{
+			for (int k = m_.getRowPtr(i); k < m_.getRowPtr(i + 1); ++k) {
+				cols.push_back(m_.getCol(k));
+				if (values) values->push_back(m_.getValue(k));
+			}
+		}
+
+	private:
+
+		const SparseMatrixType& m_;
+	}; // class CrsRows
+
+	template<typename SourceType>
+	class MyLoopBuild {
+
+	public:
+
+		MyLoopBuild(HermitianSparseMatrix& h, const SourceType& source)
+		    : h_(h),
+		      source_(source),
+		      fill_(false),
+		      where_(ConcurrencyType::storageSize(ConcurrencyType::npthreads)),
+		      cols_(where_.size()),
+		      values_(where_.size()),
+		      rowCols_(where_.size()),
+		      rowValues_(where_.size())
+		{}
+
+		void doTask(SizeType taskNumber, SizeType threadNum)
+		{
+			assert(threadNum < where_.size());
+			VectorSizeType& cols = cols_[threadNum];
+			VectorType& values = values_[threadNum];
+			SizeType start = h_.blockStart_[taskNumber];
+			SizeType end = h_.blockStart_[taskNumber + 1];
+			for (SizeType i = start; i < end; ++i) {
+				sumRow(i, threadNum);
+				if (!fill_) {
+					h_.rowptr_[i + 1] = cols.size();
+					continue;
+				}
+
+				// values stay where they are, so where still finds them
+				const VectorSizeType& where = where_[threadNum];
+				std::sort(cols.begin(), cols.end());
+				SizeType counter = h_.rowptr_[i];
+				for (SizeType k = 0; k < cols.size(); ++k) {
+					h_.colind_[counter] = cols[k];
+					h_.values_[counter++] = values[where[cols[k]]];
+				}
+			}
+		}
+
+		SizeType tasks() const { return h_.blockStart_.size() - 1; }
+
+		void fill() { fill_ = true; }
+
+	private:
+
+		// diagonal and upper triangle of row i, repeated columns summed,
+		// with values only when filling; where[col] is the position of
+		// col in cols, if col is there
+		void sumRow(SizeType i, SizeType threadNum)
+		{
+			VectorSizeType& where = where_[threadNum];
+			VectorSizeType& cols = cols_[threadNum];
+			VectorType& values = values_[threadNum];
+			VectorSizeType& rowCols = rowCols_[threadNum];
+			VectorType& rowValues = rowValues_[threadNum];
+			if (where.size() != h_.rows_) where.resize(h_.rows_, 0);
+			cols.clear();
+			values.clear();
+			rowCols.clear();
+			rowValues.clear();
+			source_.row(rowCols, (fill_) ? &rowValues : 0, i);
+			h_.diag_[i] = 0.0;
+			for (SizeType k = 0; k < rowCols.size(); ++k) {
+				SizeType col = rowCols[k];
+				if (col < i) continue;
+				if (col == i) {
+					if (fill_) h_.diag_[i] += rowValues[k];
+					continue;
+				}
+
+				SizeType w = where[col];
+				if (w < cols.size() && cols[w] == col) {
+					if (fill_) values[w] += rowValues[k];
+					continue;
+				}
+
+				where[col] = cols.size();
+				cols.push_back(col);
+				if (fill_) values.push_back(rowValues[k]);
+			}
+		}
+
+		HermitianSparseMatrix& h_;
+		const SourceType& source_;
+		bool fill_;
+		VectorVectorSizeType where_;
+		VectorVectorSizeType cols_;
+		VectorVectorType values_;
+		VectorVectorSizeType rowCols_;
+		VectorVectorType rowValues_;
+	}; // class MyLoopBuild
+
+	// z += this*y for the rows of each block, z the buffer of the thread
+	template<typename SomeVectorType>
+	class MyLoopProduct {
+
+	public:
+
+		MyLoopProduct(const HermitianSparseMatrix& h, const SomeVectorType& y)
+		    : h_(h), y_(y)
+		{}
+
+		void doTask(SizeType taskNumber, SizeType threadNum)
+		{
+			assert(threadNum < h_.buffers_.size());
+			VectorType& z = h_.buffers_[threadNum];
+			SizeType start = h_.blockStart_[taskNumber];
+			SizeType end = h_.blockStart_[taskNumber + 1];
+			for (SizeType i = start; i < end; ++i) {
+				ComplexOrRealType yi = y_[i];
+				ComplexOrRealType sum = h_.diag_[i]*yi;
+				for (SizeType k = h_.rowptr_[i]; k < h_.rowptr_[i + 1]; ++k) {
+					SizeType col = h_.colind_[k];
+					sum += h_.values_[k]*y_[col];
+					z[col] += PsimagLite::conj(h_.values_[k])*yi;
+				}
+
+				z[i] += sum;
+			}
+		}
+
+		SizeType tasks() const { return h_.blockStart_.size() - 1; }
+
+	private:
+
+		const HermitianSparseMatrix& h_;
+		const SomeVectorType& y_;
+	}; // class MyLoopProduct
+
+	// x += sum of the buffers, which are left zero
+	template<typename SomeVectorType>
+	class MyLoopReduce {
+
+	public:
+
+		MyLoopReduce(const HermitianSparseMatrix& h, SomeVectorType& x)
+		    : h_(h), x_(x)
+		{}
+
+		void doTask(SizeType taskNumber, SizeType)
+		{
+			SizeType start = h_.blockStart_[taskNumber];
+			SizeType end = h_.blockStart_[taskNumber + 1];
+			for (SizeType t = 0; t < h_.buffers_.size(); ++t) {
+				VectorType& z = h_.buffers_[t];
+				for (SizeType i = start; i < end; ++i) {
+					x_[i] += z[i];
+					z[i] = 0.0;
+				}
+			}
+		}
+
+		SizeType tasks() const { return h_.blockStart_.size() - 1; }
+
+	private:
+
+		const HermitianSparseMatrix& h_;
+		SomeVectorType& x_;
+	}; // class MyLoopReduce
+
+public:
+
+	typedef ComplexOrRealType value_type;
+
+	HermitianSparseMatrix() : rows_(0) {}
+
+	// this = the matrix whose rows source gives, which must be Hermitian;
+	// only its diagonal and upper triangle are kept. SourceType has
+	// rows(), and row(cols,values,i), which appends to cols the columns
+	// of the entries of row i, repeated columns allowed, and their values
+	// to values, unless values is zero. row is called from many threads
+	template<typename SourceType>
+	void set(const SourceType& source)
+	{
+		build(source);
+	}
+
+	// full must be Hermitian; only its diagonal and upper triangle are read
+	void set(const SparseMatrixType& full)
+	{
+		if (full.rows() != full.cols())
+			throw PsimagLite::RuntimeError("HermitianSparseMatrix: matrix not square\n");
+
+		CrsRows source(full);
+		build(source);
+	}
+
+	void clear()
+	{
+		rows_ = 0;
+		diag_.clear();
+		rowptr_.clear();
+		colind_.clear();
+		values_.clear();
+		blockStart_.clear();
+		buffers_.clear();
+	}
+
+	SizeType rows() const { return rows_; }
+
+	SizeType cols() const { return rows_; }
+
+	// of the full matrix
+	SizeType nonZero() const { return rows_ + 2*values_.size(); }
+
+	// x += this*y
+	template<typename SomeVectorType>
+	void matrixVectorProduct(SomeVectorType& x, const SomeVectorType& y) const
+	{
+		assert(x.size() == rows_ && y.size() == rows_);
+		typedef PsimagLite::Parallelizer<MyLoopProduct<SomeVectorType> > ParallelizerType;
+		ParallelizerType threadObject(ConcurrencyType::npthreads,
+		                              PsimagLite::MPI::COMM_WORLD);
+
+		MyLoopProduct<SomeVectorType> helper(*this, y);
+		threadObject.loopCreate(helper);
+
+		if (!ConcurrencyType::hasMpi()) {
+			reduce(x);
+			return;
+		}
+
+		// each rank did only some blocks
+		VectorType c(rows_, 0.0);
+		reduce(c);
+		PsimagLite::MPI::allReduce(c);
+		for (SizeType i = 0; i < rows_; ++i)
+			x[i] += c[i];
+	}
+
+	ComplexOrRealType operator()(SizeType i, SizeType j) const
+	{
+		assert(i < rows_ && j < rows_);
+		if (i == j) return diag_[i];
+		if (i > j) return PsimagLite::conj(upper(j, i));
+		return upper(i, j);
+	}
+
+	void toCrs(SparseMatrixType& m) const
+	{
+		VectorSizeType lower(rows_, 0);
+		for (SizeType k = 0; k < colind_.size(); ++k)
+			lower[colind_[k]]++;
+
+		typename PsimagLite::Vector<VectorSizeType>::Type lowerCols(rows_);
+		VectorVectorType lowerValues(rows_);
+		for (SizeType i = 0; i < rows_; ++i) {
+			lowerCols[i].reserve(lower[i]);
+			lowerValues[i].reserve(lower[i]);
+			for (SizeType k = rowptr_[i]; k < rowptr_[i + 1]; ++k) {
+				lowerCols[colind_[k]].push_back(i);
+				lowerValues[colind_[k]].push_back(PsimagLite::conj(values_[k]));
+			}
+		}
+
+		m.resize(rows_, rows_);
+		SizeType counter = 0;
+		for (SizeType i = 0; i < rows_; ++i) {
+			m.setRow(i, counter);
+			for (SizeType k = 0; k < lowerCols[i].size(); ++k) {
+				m.pushCol(lowerCols[i][k]);
+				m.pushValue(lowerValues[i][k]);
+				++counter;
+			}
+
+			m.pushCol(i);
+			m.pushValue(diag_[i]);
+			++counter;
+			for (SizeType k = rowptr_[i]; k < rowptr_[i + 1]; ++k) {
+				m.pushCol(colind_[k]);
+				m.pushValue(values_[k]);
+				++counter;
+			}
+		}
+
+		m.setRow(rows_, counter);
+		m.checkValidity();
+	}
+
+private:
+
+	template<typename SourceType>
+	void build(const SourceType& source)
+	{
+		rows_ = source.rows();
+		diag_.assign(rows_, 0.0);
+		rowptr_.assign(rows_ + 1, 0);
+
+		typedef ParallelizerThreads<MyLoopBuild<SourceType> > ParallelizerType;
+		ParallelizerType threadObject(ConcurrencyType::npthreads);
+
+		// count the upper triangle of each row, from the columns only
+		VectorSizeType perRow(rows_, 1);
+		setBlocks(perRow);
+		MyLoopBuild<SourceType> helper(*this, source);
+		threadObject.loopCreate(helper);
+		for (SizeType i = 0; i < rows_; ++i) {
+			perRow[i] += 2*rowptr_[i + 1];
+			rowptr_[i + 1] += rowptr_[i];
+		}
+
+		// then fill it, with the blocks balanced for matrixVectorProduct
+		colind_.resize(rowptr_[rows_]);
+		values_.resize(rowptr_[rows_]);
+		setBlocks(perRow);
+		helper.fill();
+		threadObject.loopCreate(helper);
+		assert(isHermitian(source));
+
+		SizeType nthreads = ConcurrencyType::storageSize(ConcurrencyType::npthreads);
+		buffers_.resize(nthreads);
+		for (SizeType i = 0; i < nthreads; ++i)
+			buffers_[i].assign(rows_, 0.0);
+	}
+
+	// Blocks of consecutive rows with about the same number of nonzeros,
+	// of which row i has perRow[i]
+	void setBlocks(const VectorSizeType& perRow)
+	{
+		SizeType nthreads = ConcurrencyType::storageSize(ConcurrencyType::npthreads);
+		SizeType nblocks = std::min(rows_, BLOCKS_PER_THREAD*nthreads);
+		if (nblocks == 0) nblocks = 1;
+		SizeType nonZero = 0;
+		for (SizeType i = 0; i < rows_; ++i)
+			nonZero += perRow[i];
+
+		SizeType perBlock = nonZero/nblocks + 1;
+		blockStart_.clear();
+		blockStart_.push_back(0);
+		SizeType sum = 0;
+		for (SizeType i = 0; i < rows_; ++i) {
+			sum += perRow[i];
+			if (sum < perBlock) continue;
+			blockStart_.push_back(i + 1);
+			sum = 0;
+		}
+
+		if (blockStart_.back() != rows_) blockStart_.push_back(rows_);
+	}
+
+	// True if the rows of source are those of this, in full; as this
+	// keeps only the upper triangle, that means that source is Hermitian.
+	// Serial and slow; for debug builds
+	template<typename SourceType>
+	bool isHermitian(const SourceType& source) const
+	{
+		const RealType eps = 1e-6;
+		VectorRealType norm2(rows_, 0.0);
+		for (SizeType i = 0; i < rows_; ++i) {
+			norm2[i] += std::abs(diag_[i])*std::abs(diag_[i]);
+			for (SizeType k = rowptr_[i]; k < rowptr_[i + 1]; ++k) {
+				RealType a = std::abs(values_[k]);
+				norm2[i] += a*a;
+				norm2[colind_[k]] += a*a;
+			}
+		}
+
+		VectorType sum(rows_, 0.0);
+		VectorSizeType mark(rows_, 0);
+		VectorSizeType cols;
+		VectorType values;
+		VectorSizeType touched;
+		for (SizeType i = 0; i < rows_; ++i) {
+			cols.clear();
+			values.clear();
+			touched.clear();
+			source.row(cols, &values, i);
+			for (SizeType k = 0; k < cols.size(); ++k) {
+				SizeType col = cols[k];
+				if (mark[col] != i + 1) {
+					mark[col] = i + 1;
+					sum[col] = 0.0;
+					touched.push_back(col);
+				}
+
+				sum[col] += values[k];
+			}
+
+			// the entries of source are those of this, which has no others
+			RealType rowNorm2 = 0.0;
+			for (SizeType k = 0; k < touched.size(); ++k) {
+				SizeType col = touched[k];
+				if (std::abs(sum[col] - operator()(i, col)) > eps) return false;
+				rowNorm2 += std::abs(sum[col])*std::abs(sum[col]);
+			}
+
+			if (std::abs(rowNorm2 - norm2[i]) > eps*(1.0 + norm2[i])) return false;
+		}
+
+		return true;
+	}
+
+	template<typename SomeVectorType>
+	void reduce(SomeVectorType& x) const
+	{
+		typedef ParallelizerThreads<MyLoopReduce<SomeVectorType> > ParallelizerType;
+		ParallelizerType threadObject(ConcurrencyType::npthreads);
+
+		MyLoopReduce<SomeVectorType> helper(*this, x);
+		threadObject.loopCreate(helper);
+	}
+
+	ComplexOrRealType upper(SizeType i, SizeType j) const
+	{
+		for (SizeType k = rowptr_[i]; k < rowptr_[i + 1]; ++k)
+			if (colind_[k] == j) return values_[k];
+		return 0.0;
+	}
+
+	SizeType rows_;
+	VectorType diag_;
+	VectorSizeType rowptr_;
+	VectorSizeType colind_;
+	VectorType values_;
+	VectorSizeType blockStart_;
+	mutable VectorVectorType buffers_; // one per thread, zero between products
+}; // class HermitianSparseMatrix
+} // namespace Dmrg
+
+/*@}*/
+#endif // DMRG_HERMITIAN_SPARSE_MATRIX_H
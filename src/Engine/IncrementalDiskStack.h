@@ -0,0 +1,165 @@
+/*
+Copyright (c) 2009-2018, UT-Battelle, LLC
+All rights reserved
+
+[DMRG++, Version 3.0]
+[by G.A., Oak Ridge National Laboratory]
+
+UT Battelle Open Source Software License 11242008
+
+OPEN SOURCE LICENSE
+
+Subject to the conditions of this License, each
+contributor to this software hereby grants, free of
+charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), a
+perpetual, worldwide, non-exclusive, no-charge,
+royalty-free, irrevocable copyright license to use, copy,
+modify, merge, publish, distribute, and/or sublicense
+copies of the Software.
+
+1. Redistributions of Software must retain the above
+copyright and license notices, this list of conditions,
+and the following disclaimer.  Changes or modifications
+to, or derivative works of, the Software should be noted
+with comments and the contributor and organization's
+name.
+
+2. Neither the names of UT-Battelle, LLC or the
+Department of Energy nor the names of the Software
+contributors may be used to endorse or promote products
+derived from this software without specific prior written
+permission of UT-Battelle.
+
+3. The software and the end-user documentation included
+with the redistribution, with or without modification,
+must include the following acknowledgment:
+
+"This product includes software produced by UT-Battelle,
+LLC under Contract No. DE-AC05-00OR22725  with the
+Department of Energy."
+
+*********************************************************
+DISCLAIMER
+
+THE SOFTWARE IS SUPPLIED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER, CONTRIBUTORS, UNITED STATES GOVERNMENT,
+OR THE UNITED STATES DEPARTMENT OF ENERGY BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+NEITHER THE UNITED STATES GOVERNMENT, NOR THE UNITED
+STATES DEPARTMENT OF ENERGY, NOR THE COPYRIGHT OWNER, NOR
+ANY OF THEIR EMPLOYEES, REPRESENTS THAT THE USE OF ANY
+INFORMATION, DATA, APPARATUS, PRODUCT, OR PROCESS
+DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
+
+*********************************************************
+*/
+/** \ingroup DMRG */
+/*@{*/
+
+/*! \file IncrementalDiskStack.h
+ *
+ *  Writes a stack to a file in the format of DiskStack, keeping
+ *  the entries at the bottom that were written by the previous call
+ *
+ *  Entries are in the file bottom first, the reverse of the order in
+ *  which DiskStack writes a stack popped from memory; the trailer lists
+ *  where each entry ends so that LazyDiskStack still reads them top
+ *  first without rescanning. The ends are also remembered, so that
+ *  an update truncates the file after the last
+ *  entry that did not change and appends the others and the trailer;
+ *  a file that keeps no entries is unlinked instead of truncated,
+ *  since a lazy restart may still be reading it through a link
+ *
+ */
+#ifndef INCREMENTAL_DISK_STACK_H
+#define INCREMENTAL_DISK_STACK_H
+
+#include "DiskStack.h"
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+
+namespace Dmrg {
+
+template<typename DataType>
+class IncrementalDiskStack {
+
+	typedef typename PsimagLite::IoSimple::Out IoOutType;
+	typedef typename DiskStack<DataType>::VectorSizeType VectorSizeType;
+
+public:
+
+	explicit IncrementalDiskStack(PsimagLite::String file)
+	    : file_(file)
+	{}
+
+	const PsimagLite::String& file() const { return file_; }
+
+	// Number of entries at the bottom that are in the file
+	SizeType size() const { return ends_.size(); }
+
+	// The stack is made of the first keep entries already in the file
+	// followed by entries, the bottom one first; entries needs only
+	// size() and operator[], and is read one entry at a time
+	template<typename SomeEntriesType>
+	void write(SizeType keep, const SomeEntriesType& entries)
+	{
+		if (keep > ends_.size()) keep = ends_.size();
+
+		if (keep == 0) {
+			if (unlink(file_.c_str()) != 0 && errno != ENOENT)
+				fail("unlink");
+		} else if (truncate(file_.c_str(), ends_[keep - 1]) != 0) {
+			fail("truncate");
+		}
+
+		ends_.resize(keep);
+
+		IoOutType io;
+		for (SizeType i = 0; i < entries.size(); ++i) {
+			io.open(file_, std::ios_base::app);
+			entries[i].save(io, DataType::SAVE_ALL);
+			io.close();
+			ends_.push_back(DiskStack<DataType>::fileSize(file_));
+		}
+
+		// DiskStack reads the index of the bottom entry last
+		SizeType total = ends_.size();
+		PsimagLite::Stack<int>::Type st;
+		for (SizeType i = 0; i < total; ++i)
+			st.push(total - 1 - i);
+
+		io.open(file_, std::ios_base::app);
+		DiskStack<DataType>::printMeta(io, total, st, "#STACKMETASTACK\n");
+		DiskStack<DataType>::printEnds(io, ends_);
+		io.close();
+	}
+
+private:
+
+	void fail(PsimagLite::String what) const
+	{
+		PsimagLite::String msg("IncrementalDiskStack: " + what + " " + file_ + ": ");
+		throw PsimagLite::RuntimeError(msg + strerror(errno) + "\n");
+	}
+
+	PsimagLite::String file_;
+	VectorSizeType ends_;
+}; // class IncrementalDiskStack
+} // namespace Dmrg
+/*@}*/
+#endif // INCREMENTAL_DISK_STACK_H
@@ -187,6 +187,7 @@ public:
 		knownLabels_.push_back("DegeneracyMax");
 		knownLabels_.push_back("KroneckerDumperBegin");
 		knownLabels_.push_back("KroneckerDumperEnd");
+		knownLabels_.push_back("CompressedStacksDistance");
 		knownLabels_.push_back("LanczosEps");
 		knownLabels_.push_back("LanczosSteps");
 		knownLabels_.push_back("TridiagEps");
@@ -303,8 +304,12 @@ public:
 			\item[noloadwft] TBW
 			\item[ChebyshevSolver] Use ChebyshevSolver instead of Lanczos
 			\item[MatrixVectorStored] Store superblock sector of Hamiltonian matrix
-			in memory instead of constructing it on the fly.
-			\item[MatrixVectorKron] TBW
+			in memory instead of constructing it on the fly. Only its diagonal
+			and upper triangle are kept.
+			\item[MatrixVectorKron] Compute the superblock matrix vector
+			product with Kronecker products of left and right blocks.
+			With SU(2) symmetry the reduced factors are folded into the
+			Kronecker terms when the sector is set up.
 			\item[TimeStepTargetting] TDMRG algorithm
 			\item[DynamicTargetting] TBW
 			\item[AdaptiveDynamicTargetting] TBW
@@ -337,8 +342,45 @@ public:
 			\item [wftInBlocks] Accelerate the WFT by using dense blocks
 			\item [wftStacksInDisk] Save and load stacks for WFT to and from disk,
 							   instead of to and from memory. Cannot be used with restart yet.
+			\item [complementaryOperators] Fold the connections that share
+			                    an operator on one block into a single term
+			                    with a pre-summed operator on the other block.
+			                    Helps models with long range couplings.
+			                    Cannot be used with SU(2) symmetry
+			\item [KronDistributed] Only meaningful with MatrixVectorKron.
+			                    Each MPI rank owns a contiguous range of output
+			                    patches and builds only the Kronecker blocks
+			                    that feed them, so that the memory for the
+			                    superblock Hamiltonian scales with the number
+			                    of ranks
+			\item [operatorsDistributed] With MPI, the blocks kept in the
+			                    sys. and env. stacks hold on each rank only
+			                    the operators of the sites that rank owns
+			                    (site modulo number of ranks). A block gets
+			                    all its operators back when it is popped or
+			                    written to disk. Cannot be used with
+			                    diskstacks or SU(2) symmetry
+			\item [lazyRestart] Only meaningful with restart. The sys. and
+			                    env. stacks of the previous run are not loaded
+			                    when the run starts; each block is read from
+			                    the stack files when it is popped. Cannot be
+			                    used with diskstacks or operatorsDistributed
+			\item [compressedStacks] Blocks of the sys. and env. stacks that
+			                    are CompressedStacksDistance or more below the
+			                    top keep their operators compressed in memory,
+			                    and are decompressed one step before they reach
+			                    the top. Cannot be used with diskstacks or
+			                    SU(2) symmetry
+			\item [compressedStacksFloat] Implies compressedStacks, and also
+			                    rounds the values of the compressed operators
+			                    to single precision
 			\item [BatchedGemm] Only meaningful with MatrixVectorKron. Enables
 			                    batched gemm and might need plugin sc
+			\item [binaryData] Save vectors and transforms to a binary file
+			                   next to the data file, which then holds only
+			                   their offsets. observe and restart read both.
+			\item [binaryDataCompress] Only meaningful with binaryData. Compress
+			                   runs of zeros in the binary file
 		\end{itemize}
 		*/
 	void check(const PsimagLite::String& label,
@@ -387,6 +429,8 @@ public:
 		registerOpts.push_back("neverNormalizeVectors");
 		registerOpts.push_back("noSaveStacks");
 		registerOpts.push_back("noSaveData");
+		registerOpts.push_back("binaryData");
+		registerOpts.push_back("binaryDataCompress");
 		registerOpts.push_back("noSaveWft");
 		registerOpts.push_back("minimizeDisk");
 		registerOpts.push_back("advanceOnlyAtBorder");
@@ -403,6 +447,12 @@ public:
 		registerOpts.push_back("wftWithTemp");
 		registerOpts.push_back("wftStacksInDisk");
 		registerOpts.push_back("BatchedGemm");
+		registerOpts.push_back("complementaryOperators");
+		registerOpts.push_back("KronDistributed");
+		registerOpts.push_back("operatorsDistributed");
+		registerOpts.push_back("lazyRestart");
+		registerOpts.push_back("compressedStacks");
+		registerOpts.push_back("compressedStacksFloat");
 
 		PsimagLite::Options::Writeable optWriteable(registerOpts,
 		                                            PsimagLite::Options::Writeable::PERMISSIVE);
@@ -411,6 +461,28 @@ public:
 		if (val.find("BatchedGemm") != PsimagLite::String::npos &&
 		        val.find("MatrixVectorKron") == PsimagLite::String::npos)
 			err("FATAL: BatchedGemm only with MatrixVectorKron\n");
+
+		if (val.find("KronDistributed") != PsimagLite::String::npos) {
+			if (val.find("MatrixVectorKron") == PsimagLite::String::npos)
+				err("FATAL: KronDistributed only with MatrixVectorKron\n");
+			if (val.find("BatchedGemm") != PsimagLite::String::npos)
+				err("FATAL: KronDistributed cannot be used with BatchedGemm\n");
+		}
+
+		if (val.find("operatorsDistributed") != PsimagLite::String::npos &&
+		        val.find("diskstacks") != PsimagLite::String::npos)
+			err("FATAL: operatorsDistributed cannot be used with diskstacks\n");
+
+		if (val.find("lazyRestart") != PsimagLite::String::npos) {
+			if (val.find("diskstacks") != PsimagLite::String::npos)
+				err("FATAL: lazyRestart cannot be used with diskstacks\n");
+			if (val.find("operatorsDistributed") != PsimagLite::String::npos)
+				err("FATAL: lazyRestart cannot be used with operatorsDistributed\n");
+		}
+
+		if (val.find("compressedStacks") != PsimagLite::String::npos &&
+		        val.find("diskstacks") != PsimagLite::String::npos)
+			err("FATAL: compressedStacks cannot be used with diskstacks\n");
 	}
 
 	bool isSet(const PsimagLite::String& thisOption) const
@@ -0,0 +1,291 @@
+/*
+Copyright (c) 2009-2018, UT-Battelle, LLC
+All rights reserved
+
+[DMRG++, Version 3.0]
+[by G.A., Oak Ridge National Laboratory]
+
+UT Battelle Open Source Software License 11242008
+
+OPEN SOURCE LICENSE
+
+Subject to the conditions of this License, each
+contributor to this software hereby grants, free of
+charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), a
+perpetual, worldwide, non-exclusive, no-charge,
+royalty-free, irrevocable copyright license to use, copy,
+modify, merge, publish, distribute, and/or sublicense
+copies of the Software.
+
+1. Redistributions of Software must retain the above
+copyright and license notices, this list of conditions,
+and the following disclaimer.  Changes or modifications
+to, or derivative works of, the Software should be noted
+with comments and the contributor and organization's
+name.
+
+2. Neither the names of UT-Battelle, LLC or the
+Department of Energy nor the names of the Software
+contributors may be used to endorse or promote products
+derived from this software without specific prior written
+permission of UT-Battelle.
+
+3. The software and the end-user documentation included
+with the redistribution, with or without modification,
+must include the following acknowledgment:
+
+"This product includes software produced by UT-Battelle,
+LLC under Contract No. DE-AC05-00OR22725  with the
+Department of Energy."
+
+*********************************************************
+DISCLAIMER
+
+THE SOFTWARE IS SUPPLIED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER, CONTRIBUTORS, UNITED STATES GOVERNMENT,
+OR THE UNITED STATES DEPARTMENT OF ENERGY BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+NEITHER THE UNITED STATES GOVERNMENT, NOR THE UNITED
+STATES DEPARTMENT OF ENERGY, NOR THE COPYRIGHT OWNER, NOR
+ANY OF THEIR EMPLOYEES, REPRESENTS THAT THE USE OF ANY
+INFORMATION, DATA, APPARATUS, PRODUCT, OR PROCESS
+DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
+
+*********************************************************
+*/
+/** \ingroup DMRG */
+/*@{*/
+
+/*! \file LazyDiskStack.h
+ *
+ *  A read-only stack over the entries of a DiskStack file, each entry
+ *  is read from disk only when it reaches the top
+ *
+ *  When the top is the entry that was written first, popping this
+ *  stack reads the file forward, and the file is kept open between
+ *  reads. Otherwise, as for the files of IncrementalDiskStack that are
+ *  written bottom first, the entry is found from the ends listed in the
+ *  trailer: its bytes are copied to a scratch file and read from there,
+ *  so that the file is not rescanned from the beginning for each entry
+ *
+ *  The file is read through a hard link private to this process, so
+ *  that this run may replace it, for example with a Recovery snapshot
+ *  of the same name, while entries are still being read; the link is
+ *  removed when the stack that made it is destroyed. A copy reads on
+ *  its own, and so it may be used by another thread
+ *
+ */
+#ifndef LAZY_DISK_STACK_H
+#define LAZY_DISK_STACK_H
+
+#include "DiskStack.h"
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+
+namespace Dmrg {
+
+template<typename DataType>
+class LazyDiskStack {
+
+	typedef typename PsimagLite::IoSimple::In IoInType;
+	typedef PsimagLite::Stack<int>::Type StackIntType;
+	typedef typename DiskStack<DataType>::VectorSizeType VectorSizeType;
+
+public:
+
+	LazyDiskStack()
+	    : ownsLink_(false),
+	      isObserveCode_(false),
+	      isOpen_(false),
+	      next_(0),
+	      dtIndex_(0),
+	      dt_(0)
+	{}
+
+
+	LazyDiskStack(const LazyDiskStack& other)
+	    : fileIn_(other.fileIn_),
+	      ownsLink_(false),
+	      isObserveCode_(other.isObserveCode_),
+	      ends_(other.ends_),
+	      isOpen_(false),
+	      next_(0),
+	      dtIndex_(0),
+	      dt_(0),
+	      indices_(other.indices_)
+	{}
+
+	~LazyDiskStack()
+	{
+		release();
+		if (scratch_ != "") unlink(scratch_.c_str());
+		delete dt_;
+		dt_ = 0;
+	}
+
+	// Takes the entries of disk, the bottom of disk becomes the top here
+	void load(const DiskStack<DataType>& disk)
+	{
+		release();
+		delete dt_;
+		dt_ = 0;
+		fileIn_ = linkTo(disk.fileIn_);
+		ownsLink_ = true;
+		isObserveCode_ = disk.isObserveCode_;
+		ends_ = disk.endsIn_;
+		indices_.clear();
+
+		// the bottom of disk goes last, to the back of indices_, the top here
+		StackIntType tmp = disk.stack_;
+		for (; !tmp.empty(); tmp.pop())
+			indices_.push_back(tmp.top());
+	}
+
+	SizeType size() const { return indices_.size(); }
+
+	void pop()
+	{
+		assert(indices_.size() > 0);
+		indices_.pop_back();
+		if (indices_.size() == 0) close();
+	}
+
+	const DataType& top() const { return fromTop(0); }
+
+	// The entry depth entries below the top; only the entry read last
+	// is kept in memory
+	const DataType& fromTop(SizeType depth) const
+	{
+		assert(depth < indices_.size());
+		SizeType index = indices_[indices_.size() - 1 - depth];
+		if (dt_ && dtIndex_ == index) return *dt_;
+
+		delete dt_;
+		dt_ = 0;
+		dt_ = (index < ends_.size() && index != next_) ? readAt(index)
+		                                               : readForward(index);
+		dtIndex_ = index;
+		return *dt_;
+	}
+
+private:
+
+	LazyDiskStack& operator=(const LazyDiskStack&);
+
+	DataType* readForward(SizeType index) const
+	{
+		if (!isOpen_ || index < next_) {
+			close();
+			ioIn_.open(fileIn_);
+			isOpen_ = true;
+			next_ = 0;
+		}
+
+		DataType* dt = new DataType(ioIn_, "", index - next_, isObserveCode_);
+		next_ = index + 1;
+		return dt;
+	}
+
+	DataType* readAt(SizeType index) const
+	{
+		SizeType begin = (index > 0) ? ends_[index - 1] : 0;
+		assert(begin <= ends_[index]);
+		SizeType bytes = ends_[index] - begin;
+
+		if (scratch_ == "") scratch_ = scratchFor(fileIn_);
+		std::ifstream fin(fileIn_.c_str(), std::ios::binary);
+		std::ofstream fout(scratch_.c_str(), std::ios::binary | std::ios::trunc);
+		fin.seekg(begin);
+		char buffer[65536];
+		while (bytes > 0 && fin && fout) {
+			SizeType n = (bytes < sizeof(buffer)) ? bytes : sizeof(buffer);
+			fin.read(buffer, n);
+			fout.write(buffer, fin.gcount());
+			bytes -= fin.gcount();
+		}
+
+		fout.close();
+		if (bytes > 0 || !fout)
+			throw PsimagLite::RuntimeError("LazyDiskStack: cannot read entry " +
+			                               ttos(index) + " of " + fileIn_ + "\n");
+
+		IoInType io(scratch_);
+		return new DataType(io, "", 0, isObserveCode_);
+	}
+
+	void close() const
+	{
+		if (!isOpen_) return;
+		ioIn_.close();
+		isOpen_ = false;
+	}
+
+	// Closes the file and removes the link if this stack made it
+	void release()
+	{
+		close();
+		if (!ownsLink_) return;
+		unlink(fileIn_.c_str());
+		ownsLink_ = false;
+	}
+
+	static PsimagLite::String linkTo(PsimagLite::String file)
+	{
+		PsimagLite::String name = file + ".lazy" + ttos(getpid());
+		unlink(name.c_str());
+		if (link(file.c_str(), name.c_str()) == 0) return name;
+
+		PsimagLite::String msg("LazyDiskStack: cannot link " + file + " to " + name);
+		msg += ": " + PsimagLite::String(strerror(errno));
+		throw PsimagLite::RuntimeError(msg + "\nRestart without lazyRestart\n");
+	}
+
+	// A new file next to file, for one entry at a time
+	static PsimagLite::String scratchFor(PsimagLite::String file)
+	{
+		PsimagLite::String templ = file + ".entryXXXXXX";
+		PsimagLite::Vector<char>::Type name(templ.begin(), templ.end());
+		name.push_back('\0');
+		int fd = mkstemp(&name[0]);
+		if (fd < 0) {
+			PsimagLite::String msg("LazyDiskStack: cannot create " + templ);
+			throw PsimagLite::RuntimeError(msg + ": " + strerror(errno) + "\n");
+		}
+
+		::close(fd);
+		return PsimagLite::String(&name[0]);
+	}
+
+	PsimagLite::String fileIn_;
+	bool ownsLink_;
+	bool isObserveCode_;
+	VectorSizeType ends_;
+	mutable PsimagLite::String scratch_;
+	mutable bool isOpen_;
+	mutable SizeType next_;
+	mutable SizeType dtIndex_;
+	mutable DataType* dt_;
+	mutable IoInType ioIn_;
+	VectorSizeType indices_;
+}; // class LazyDiskStack
+} // namespace Dmrg
+/*@}*/
+#endif // LAZY_DISK_STACK_H
@@ -99,12 +99,16 @@ public:
 	typedef GenIjPatch<LeftRightSuperType> GenIjPatchType;
 	typedef typename GenIjPatchType::VectorSizeType VectorSizeType;
 	typedef typename GenIjPatchType::BasisType BasisType;
+	typedef typename PsimagLite::Vector<bool>::Type VectorBoolType;
 
+	// If ownedNew is given only the rows of the NEW patches it marks
+	// are built; the others are left null
 	ArrayOfMatStruct(const SparseMatrixType& sparse,
 	                 const GenIjPatchType& patchOld,
 	                 const GenIjPatchType& patchNew,
 	                 typename GenIjPatchType::LeftOrRightEnumType leftOrRight,
-	                 RealType threshold)
+	                 RealType threshold,
+	                 const VectorBoolType* ownedNew = 0)
 	    : data_(patchNew(leftOrRight).size(), patchOld(leftOrRight).size())
 	{
 		const BasisType& basisOld = (leftOrRight == GenIjPatchType::LEFT) ?
@@ -119,6 +123,8 @@ public:
 			SizeType j2 = basisOld.partition(jgroup+1);
 			SizeType cols = j2 - j1;
 			for (SizeType ipatch=0; ipatch < npatchNew; ++ipatch) {
+				if (ownedNew && !(*ownedNew)[ipatch]) continue;
+
 				SizeType igroup = patchNew(leftOrRight)[ipatch];
 				SizeType i1 = basisNew.partition(igroup);
 				SizeType i2 = basisNew.partition(igroup+1);
@@ -81,6 +81,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "ArrayOfMatStruct.h"
 #include "Vector.h"
 #include "Link.h"
+#include "Concurrency.h"
 
 namespace Dmrg {
 
@@ -114,7 +115,8 @@ public:
 	      denseSparseThreshold_(denseSparseThreshold),
 	      ijpatchesOld_(lrs, qn),
 	      ijpatchesNew_(&ijpatchesOld_),
-	      wftMode_(false)
+	      wftMode_(false),
+	      distributed_(false)
 	{
 		cacheSigns(signsNew_, lrs.left().electronsVector(BasisType::AFTER_TRANSFORM));
 	}
@@ -130,7 +132,8 @@ public:
 	      denseSparseThreshold_(denseSparseThreshold),
 	      ijpatchesOld_(lrsOld, qn),
 	      ijpatchesNew_(new GenIjPatchType(lrsNew, qn)),
-	      wftMode_(true)
+	      wftMode_(true),
+	      distributed_(false)
 	{
 		cacheSigns(signsNew_, lrsNew.left().electronsVector(BasisType::AFTER_TRANSFORM));
 	}
@@ -191,6 +194,12 @@ public:
 		return weightsOfPatches_;
 	}
 
+	// true if this MPI rank holds only the blocks of its own output patches
+	bool distributed() const { return distributed_; }
+
+	// output (NEW) patches owned by this MPI rank; empty unless distributed
+	const VectorSizeType& ownedPatches() const { return ownedPatches_; }
+
 
 	void computeOffsets(VectorSizeType& offsetForPatches,
 	                    WhatBasisEnum what)
@@ -248,6 +257,47 @@ public:
 
 protected:
 
+	// Splits the NEW patches among MPI ranks into contiguous ranges of
+	// about equal work. Must be called before the first addOneConnection;
+	// each rank then builds only the blocks that feed its own patches
+	void distribute()
+	{
+		assert(xc_.size() == 0);
+		SizeType nranks = PsimagLite::MPI::commSize(PsimagLite::MPI::COMM_WORLD);
+		SizeType rank = PsimagLite::MPI::commRank(PsimagLite::MPI::COMM_WORLD);
+		SizeType npatches = numberOfPatches(NEW);
+		const BasisType& left = lrs(NEW).left();
+		const BasisType& right = lrs(NEW).right();
+
+		VectorSizeType weights(npatches, 0);
+		long unsigned int totalWeight = 0;
+		for (SizeType ipatch = 0; ipatch < npatches; ++ipatch) {
+			SizeType igroup = patch(NEW, GenIjPatchType::LEFT)[ipatch];
+			SizeType jgroup = patch(NEW, GenIjPatchType::RIGHT)[ipatch];
+			SizeType sizeLeft =  left.partition(igroup+1) - left.partition(igroup);
+			SizeType sizeRight = right.partition(jgroup+1) - right.partition(jgroup);
+			weights[ipatch] = sizeLeft * sizeRight * (sizeLeft + sizeRight);
+			totalWeight += weights[ipatch];
+		}
+
+		ownedNew_.resize(npatches, false);
+		ownedPatches_.clear();
+		long unsigned int sum = 0;
+		for (SizeType ipatch = 0; ipatch < npatches; ++ipatch) {
+			// a patch belongs to the rank that contains its midpoint
+			long unsigned int mid = 2*sum + weights[ipatch];
+			sum += weights[ipatch];
+			SizeType owner = (totalWeight == 0) ? ipatch % nranks :
+			                                      (mid*nranks)/(2*totalWeight);
+			if (owner >= nranks) owner = nranks - 1;
+			if (owner != rank) continue;
+			ownedNew_[ipatch] = true;
+			ownedPatches_.push_back(ipatch);
+		}
+
+		distributed_ = true;
+	}
+
 	void addOneConnection(const SparseMatrixType& A,
 	                      const SparseMatrixType& B,
 	                      const LinkType& link2)
@@ -258,7 +308,8 @@ protected:
 		                                                    ijpatchesOld_,
 		                                                    *ijpatchesNew_,
 		                                                    GenIjPatchType::LEFT,
-		                                                    denseSparseThreshold_);
+		                                                    denseSparseThreshold_,
+		                                                    owned());
 
 		xc_.push_back(x1);
 
@@ -266,7 +317,8 @@ protected:
 		                                                    ijpatchesOld_,
 		                                                    *ijpatchesNew_,
 		                                                    GenIjPatchType::RIGHT,
-		                                                    denseSparseThreshold_);
+		                                                    denseSparseThreshold_,
+		                                                    owned());
 		yc_.push_back(y1);
 	}
 
@@ -362,6 +414,11 @@ protected:
 
 private:
 
+	const VectorBoolType* owned() const
+	{
+		return (distributed_) ? &ownedNew_ : 0;
+	}
+
 	void setAndFixWeights(const VectorSizeType& weights)
 	{
 		long unsigned int max = *(std::max_element(weights.begin(), weights.end()));
@@ -441,6 +498,9 @@ private:
 	VectorArrayOfMatStructType yc_;
 	VectorBoolType signsNew_;
 	bool wftMode_;
+	bool distributed_;
+	VectorBoolType ownedNew_;
+	VectorSizeType ownedPatches_;
 };
 } // namespace Dmrg
 
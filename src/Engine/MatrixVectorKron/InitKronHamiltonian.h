@@ -116,6 +116,9 @@ public:
 	      vstart_(BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT).size() + 1),
 	      offsetForPatches_(BaseType::patch(BaseType::NEW, GenIjPatchType::LEFT).size() + 1)
 	{
+		if (model.params().options.find("KronDistributed") != PsimagLite::String::npos)
+			BaseType::distribute();
+
 		addHlAndHr();
 		convertXcYcArrays();
 		BaseType::setUpVstart(vstart_, BaseType::NEW);
@@ -113,11 +113,16 @@ public:
 
 	SizeType tasks() const
 	{
+		if (initKron_.distributed())
+			return initKron_.ownedPatches().size();
+
 		return initKron_.numberOfPatches(InitKronType::NEW);
 	}
 
-	void doTask(SizeType outPatch, SizeType)
+	void doTask(SizeType taskNumber, SizeType)
 	{
+		SizeType outPatch = (initKron_.distributed()) ?
+		            initKron_.ownedPatches()[taskNumber] : taskNumber;
 		SizeType nC = initKron_.connections();
 		SizeType total = initKron_.numberOfPatches(InitKronType::OLD);
 		SizeType offsetX = initKron_.offsetForPatches(InitKronType::NEW, outPatch);
@@ -83,8 +83,11 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "KronConnections.h"
 #include "Concurrency.h"
 #include "Parallelizer.h"
+#include "ThreadPool.h"
 #include "PsimagLite.h"
 #include "ProgressIndicator.h"
+#include "Arena.h"
+#include <algorithm>
 #ifdef PLUGIN_SC
 #include "BatchedGemmPluginSc.h"
 #else
@@ -120,6 +123,8 @@ public:
 		msg<<"KronMatrix: "<<name<<" sizes="<<initKron.size(InitKronType::NEW);
 		msg<<" "<<initKron.size(InitKronType::OLD);
 		msg<<" loadBalance "<<str;
+		if (initKron.distributed())
+			msg<<" ownedPatches "<<initKron.ownedPatches().size();
 		progress_.printline(msg, std::cout);
 	}
 
@@ -129,7 +134,10 @@ public:
 
 		if (batchedGemm_.enabled()) {
 			VectorType& xout = initKron_.xout();
-			VectorType xoutTmp(xout.size(), 0.0);
+			// outside of parallel loops, thus thread 0
+			typename Arena<typename VectorType::value_type>::Buffer xoutTmpBuffer(xout.size());
+			VectorType& xoutTmp = xoutTmpBuffer();
+			std::fill(xoutTmp.begin(), xoutTmp.end(), 0.0);
 			batchedGemm_.matrixVector(xoutTmp, initKron_.yin());
 			for(SizeType i = 0; i < xoutTmp.size(); ++i)
 				xout[i] += xoutTmp[i];
@@ -138,9 +146,15 @@ public:
 			return;
 		}
 
+		if (initKron_.distributed()) {
+			distributedProduct();
+			initKron_.copyOut(vout);
+			return;
+		}
+
 		KronConnectionsType kc(initKron_);
 
-		typedef PsimagLite::Parallelizer<KronConnectionsType> ParallelizerType;
+		typedef ParallelizerPool<KronConnectionsType> ParallelizerType;
 		ParallelizerType parallelConnections(PsimagLite::Concurrency::npthreads,
 		                                     PsimagLite::MPI::COMM_WORLD);
 
@@ -156,6 +170,39 @@ public:
 
 private:
 
+	// Each rank computes its own output patches only; the patches of
+	// the other ranks are zero here and are filled in by the reduction.
+	// The owned patches are already this rank's share, so they are
+	// split among threads only
+	void distributedProduct() const
+	{
+		VectorType& xout = initKron_.xout();
+		VectorType xoutOld = xout;
+		std::fill(xout.begin(), xout.end(), 0.0);
+
+		KronConnectionsType kc(initKron_);
+
+		typedef ParallelizerThreads<KronConnectionsType> ParallelizerType;
+		ParallelizerType parallelConnections(PsimagLite::Concurrency::npthreads);
+
+		if (initKron_.loadBalance()) {
+			const VectorSizeType& owned = initKron_.ownedPatches();
+			VectorSizeType weights(owned.size(), 0);
+			for (SizeType i = 0; i < owned.size(); ++i)
+				weights[i] = initKron_.weightsOfPatchesNew()[owned[i]];
+			parallelConnections.loopCreate(kc, weights);
+		} else {
+			parallelConnections.loopCreate(kc);
+		}
+
+		kc.sync();
+
+		PsimagLite::MPI::allReduce(xout);
+
+		for (SizeType i = 0; i < xout.size(); ++i)
+			xout[i] += xoutOld[i];
+	}
+
 	KronMatrix(const KronMatrix&);
 
 	const KronMatrix& operator=(const KronMatrix&);
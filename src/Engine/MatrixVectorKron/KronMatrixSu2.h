@@ -0,0 +1,497 @@
+/*
+Copyright (c) 2009-2018, UT-Battelle, LLC
+All rights reserved
+
+[DMRG++, Version 3.0]
+[by G.A., Oak Ridge National Laboratory]
+
+UT Battelle Open Source Software License 11242008
+
+OPEN SOURCE LICENSE
+
+Subject to the conditions of this License, each
+contributor to this software hereby grants, free of
+charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), a
+perpetual, worldwide, non-exclusive, no-charge,
+royalty-free, irrevocable copyright license to use, copy,
+modify, merge, publish, distribute, and/or sublicense
+copies of the Software.
+
+1. Redistributions of Software must retain the above
+copyright and license notices, this list of conditions,
+and the following disclaimer.  Changes or modifications
+to, or derivative works of, the Software should be noted
+with comments and the contributor and organization's
+name.
+
+2. Neither the names of UT-Battelle, LLC or the
+Department of Energy nor the names of the Software
+contributors may be used to endorse or promote products
+derived from this software without specific prior written
+permission of UT-Battelle.
+
+3. The software and the end-user documentation included
+with the redistribution, with or without modification,
+must include the following acknowledgment:
+
+"This product includes software produced by UT-Battelle,
+LLC under Contract No. DE-AC05-00OR22725  with the
+Department of Energy."
+
+*********************************************************
+DISCLAIMER
+
+THE SOFTWARE IS SUPPLIED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER, CONTRIBUTORS, UNITED STATES GOVERNMENT,
+OR THE UNITED STATES DEPARTMENT OF ENERGY BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+NEITHER THE UNITED STATES GOVERNMENT, NOR THE UNITED
+STATES DEPARTMENT OF ENERGY, NOR THE COPYRIGHT OWNER, NOR
+ANY OF THEIR EMPLOYEES, REPRESENTS THAT THE USE OF ANY
+INFORMATION, DATA, APPARATUS, PRODUCT, OR PROCESS
+DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
+
+*********************************************************
+*/
+
+/** \ingroup DMRG */
+/*@{*/
+
+/*! \file KronMatrixSu2.h
+ *
+ *  Kronecker product x+=Hy for the SU(2) reduced basis.
+ *  The states of the sector are grouped in patches of the same
+ *  (left j, left electrons, right j); the reduced factors of
+ *  Wigner-Eckart are constant within a pair of patches, so each
+ *  connection is a scalar times A(patch,patch')\otimes B(patch,patch'),
+ *  and the factors are folded into the terms at construction.
+ *  Under MPI each rank does some of the patches, and the output
+ *  is summed over ranks.
+ */
+
+#ifndef KRON_MATRIX_SU2_H
+#define KRON_MATRIX_SU2_H
+
+#include <algorithm>
+#include "Vector.h"
+#include "Map.h"
+#include "ProgramGlobals.h"
+#include "Su2Reduced.h"
+#include "Mpi.h"
+#include "Concurrency.h"
+#include "Parallelizer.h"
+#include "ProgressIndicator.h"
+
+namespace Dmrg {
+
+template<typename LeftRightSuperType>
+class ModelHelperSu2;
+
+template<typename ModelType>
+class KronMatrixSu2 {
+
+	typedef typename ModelType::ModelHelperType ModelHelperType;
+	typedef typename ModelHelperType::LeftRightSuperType LeftRightSuperType;
+	typedef typename LeftRightSuperType::BasisWithOperatorsType BasisWithOperatorsType;
+	typedef typename ModelHelperType::SparseMatrixType SparseMatrixType;
+	typedef typename ModelHelperType::LinkType LinkType;
+	typedef typename ModelHelperType::RealType RealType;
+	typedef typename SparseMatrixType::value_type ComplexOrRealType;
+	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
+	typedef typename PsimagLite::Vector<VectorType>::Type VectorVectorType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef PsimagLite::Vector<int>::Type VectorIntType;
+	typedef Su2Reduced<LeftRightSuperType> Su2ReducedType;
+	typedef PsimagLite::Concurrency ConcurrencyType;
+	typedef std::pair<SizeType,SizeType> PairType;
+
+	struct Patch {
+		SizeType j1;
+		SizeType j2;
+		SizeType n1;
+		VectorSizeType left; // reduced indices
+		VectorSizeType right;
+		VectorIntType leftLocal; // reduced index --> position in left, or -1
+		VectorIntType rightLocal;
+		VectorIntType index; // left position*right.size() + right position --> sector index, or -1
+	};
+
+	// xout(patch) += factor*a*yin(in)*b^T
+	struct Term {
+		SizeType in;
+		ComplexOrRealType factor;
+		SparseMatrixType a;
+		SparseMatrixType b;
+	};
+
+	typedef typename PsimagLite::Vector<Patch>::Type VectorPatchType;
+	typedef typename PsimagLite::Vector<Term>::Type VectorTermType;
+	typedef typename PsimagLite::Vector<VectorTermType>::Type VectorVectorTermType;
+
+	template<typename SomeVectorType>
+	class MyLoop {
+
+	public:
+
+		MyLoop(const KronMatrixSu2& k,
+		       SomeVectorType& x)
+		    : k_(k), x_(x)
+		{}
+
+		SizeType tasks() const { return k_.patches_.size(); }
+
+		void doTask(SizeType taskNumber, SizeType threadNum)
+		{
+			const Patch& patch = k_.patches_[taskNumber];
+			SizeType nl = patch.left.size();
+			SizeType nr = patch.right.size();
+			assert(threadNum < k_.xbuffers_.size());
+			VectorType& xp = k_.xbuffers_[threadNum];
+			VectorType& tmp = k_.tbuffers_[threadNum];
+			xp.resize(nl*nr);
+			std::fill(xp.begin(), xp.end(), 0.0);
+
+			const VectorTermType& terms = k_.terms_[taskNumber];
+			for (SizeType t = 0; t < terms.size(); ++t) {
+				const Term& term = terms[t];
+				const VectorType& yq = k_.yPatches_[term.in];
+				SizeType ml = k_.patches_[term.in].left.size();
+				SizeType mr = k_.patches_[term.in].right.size();
+				tmp.resize(ml*nr);
+				std::fill(tmp.begin(), tmp.end(), 0.0);
+
+				// tmp = yin(in)*b^T
+				for (SizeType b = 0; b < nr; ++b) {
+					for (int k = term.b.getRowPtr(b); k < term.b.getRowPtr(b + 1); ++k) {
+						SizeType col = term.b.getCol(k);
+						ComplexOrRealType val = term.b.getValue(k);
+						for (SizeType a2 = 0; a2 < ml; ++a2)
+							tmp[a2*nr + b] += val*yq[a2*mr + col];
+					}
+				}
+
+				// xp += factor*a*tmp
+				for (SizeType a = 0; a < nl; ++a) {
+					for (int k = term.a.getRowPtr(a); k < term.a.getRowPtr(a + 1); ++k) {
+						SizeType a2 = term.a.getCol(k);
+						ComplexOrRealType val = term.factor*term.a.getValue(k);
+						for (SizeType b = 0; b < nr; ++b)
+							xp[a*nr + b] += val*tmp[a2*nr + b];
+					}
+				}
+			}
+
+			// each sector index belongs to a single patch
+			for (SizeType i = 0; i < xp.size(); ++i) {
+				int ix = patch.index[i];
+				if (ix < 0) continue;
+				x_[ix] += xp[i];
+			}
+		}
+
+	private:
+
+		const KronMatrixSu2& k_;
+		SomeVectorType& x_;
+	}; // class MyLoop
+
+public:
+
+	KronMatrixSu2(const ModelType& model,
+	              const ModelHelperType& modelHelper)
+	    : modelHelper_(modelHelper),
+	      su2reduced_(modelHelper.su2reduced()),
+	      rows_(modelHelper.size()),
+	      progress_("KronMatrixSu2")
+	{
+		setPatches();
+		terms_.resize(patches_.size());
+		yPatches_.resize(patches_.size());
+		addHamiltonians();
+		addConnections(model);
+
+		SizeType nthreads = ConcurrencyType::storageSize(ConcurrencyType::npthreads);
+		xbuffers_.resize(nthreads);
+		tbuffers_.resize(nthreads);
+
+		SizeType nterms = 0;
+		for (SizeType p = 0; p < terms_.size(); ++p)
+			nterms += terms_[p].size();
+
+		PsimagLite::OstringStream msg;
+		msg<<"KronMatrixSu2: size="<<rows_<<" patches="<<patches_.size();
+		msg<<" terms="<<nterms;
+		progress_.printline(msg, std::cout);
+	}
+
+	SizeType rows() const { return rows_; }
+
+	template<typename SomeVectorType>
+	void matrixVectorProduct(SomeVectorType& x, const SomeVectorType& y) const
+	{
+		assert(x.size() == rows_ && y.size() == rows_);
+		for (SizeType p = 0; p < patches_.size(); ++p) {
+			const Patch& patch = patches_[p];
+			VectorType& yp = yPatches_[p];
+			yp.resize(patch.index.size());
+			for (SizeType i = 0; i < yp.size(); ++i) {
+				int ix = patch.index[i];
+				yp[i] = (ix < 0) ? 0.0 : y[ix];
+			}
+		}
+
+		if (!ConcurrencyType::hasMpi()) {
+			addPatches(x);
+			return;
+		}
+
+		// each rank did only some patches
+		VectorType c(rows_, 0.0);
+		addPatches(c);
+		PsimagLite::MPI::allReduce(c);
+		for (SizeType i = 0; i < rows_; ++i)
+			x[i] += c[i];
+	}
+
+private:
+
+	template<typename SomeVectorType>
+	void addPatches(SomeVectorType& x) const
+	{
+		typedef PsimagLite::Parallelizer<MyLoop<SomeVectorType> > ParallelizerType;
+		ParallelizerType threadObject(ConcurrencyType::npthreads,
+		                              PsimagLite::MPI::COMM_WORLD);
+
+		MyLoop<SomeVectorType> helper(*this, x);
+		threadObject.loopCreate(helper);
+	}
+
+	KronMatrixSu2(const KronMatrixSu2&);
+
+	KronMatrixSu2& operator=(const KronMatrixSu2&);
+
+	void setPatches()
+	{
+		const LeftRightSuperType& lrs = modelHelper_.leftRightSuper();
+		const BasisWithOperatorsType& left = lrs.left();
+		const BasisWithOperatorsType& right = lrs.right();
+		int offset = lrs.super().partition(modelHelper_.m());
+		SizeType jj = left.jMax()*right.jMax();
+		SizeType n = su2reduced_.reducedEffectiveSize();
+		VectorIntType sectorIndex(n, -1);
+		VectorSizeType patchOf(n, 0);
+		PsimagLite::Map<SizeType, SizeType>::Type keyToPatch;
+
+		for (SizeType i = 0; i < n; ++i) {
+			int ix = su2reduced_.flavorMapping(i) - offset;
+			if (ix < 0 || ix >= static_cast<int>(rows_)) continue;
+
+			SizeType i1 = su2reduced_.reducedEffective(i).first;
+			SizeType i2 = su2reduced_.reducedEffective(i).second;
+			SizeType j1 = left.jmValue(left.reducedIndex(i1)).first;
+			SizeType j2 = right.jmValue(right.reducedIndex(i2)).first;
+			SizeType n1 = left.electrons(left.reducedIndex(i1));
+			SizeType key = j1 + j2*left.jMax() + n1*jj;
+
+			PsimagLite::Map<SizeType, SizeType>::Type::const_iterator it =
+			        keyToPatch.find(key);
+			SizeType p = 0;
+			if (it == keyToPatch.end()) {
+				p = patches_.size();
+				keyToPatch[key] = p;
+				Patch patch;
+				patch.j1 = j1;
+				patch.j2 = j2;
+				patch.n1 = n1;
+				patch.leftLocal.resize(left.reducedSize(), -1);
+				patch.rightLocal.resize(right.reducedSize(), -1);
+				patches_.push_back(patch);
+			} else {
+				p = it->second;
+			}
+
+			Patch& patch = patches_[p];
+			if (patch.leftLocal[i1] < 0) {
+				patch.leftLocal[i1] = patch.left.size();
+				patch.left.push_back(i1);
+			}
+
+			if (patch.rightLocal[i2] < 0) {
+				patch.rightLocal[i2] = patch.right.size();
+				patch.right.push_back(i2);
+			}
+
+			sectorIndex[i] = ix;
+			patchOf[i] = p;
+		}
+
+		for (SizeType p = 0; p < patches_.size(); ++p)
+			patches_[p].index.resize(patches_[p].left.size()*patches_[p].right.size(), -1);
+
+		for (SizeType i = 0; i < n; ++i) {
+			if (sectorIndex[i] < 0) continue;
+			Patch& patch = patches_[patchOf[i]];
+			SizeType a = patch.leftLocal[su2reduced_.reducedEffective(i).first];
+			SizeType b = patch.rightLocal[su2reduced_.reducedEffective(i).second];
+			patch.index[a*patch.right.size() + b] = sectorIndex[i];
+		}
+	}
+
+	// H_L\otimes 1 + 1\otimes H_R; the reduced Hamiltonian factor
+	// only selects the patches, as in ModelHelperSu2
+	void addHamiltonians()
+	{
+		const LeftRightSuperType& lrs = modelHelper_.leftRightSuper();
+		SparseMatrixType identityL;
+		SparseMatrixType identityR;
+		identityL.makeDiagonal(lrs.left().reducedSize(), 1.0);
+		identityR.makeDiagonal(lrs.right().reducedSize(), 1.0);
+		const SparseMatrixType& hl = su2reduced_.hamiltonianLeft();
+		const SparseMatrixType& hr = su2reduced_.hamiltonianRight();
+
+		for (SizeType p = 0; p < patches_.size(); ++p) {
+			ComplexOrRealType lfactor =
+			        su2reduced_.reducedHamiltonianFactor(patches_[p].j1, patches_[p].j2);
+			if (lfactor == static_cast<ComplexOrRealType>(0)) continue;
+			for (SizeType q = 0; q < patches_.size(); ++q) {
+				addTerm(p, q, 1.0, hl, identityR);
+				addTerm(p, q, 1.0, identityL, hr);
+			}
+		}
+	}
+
+	void addConnections(const ModelType& model)
+	{
+		SizeType jMax = modelHelper_.leftRightSuper().left().jMax();
+		SizeType total = model.getLinkProductStruct(modelHelper_);
+
+		for (SizeType ix = 0; ix < total; ++ix) {
+			const SparseMatrixType* A = 0;
+			const SparseMatrixType* B = 0;
+			LinkType link = model.getConnection(&A,&B,ix,modelHelper_);
+			RealType fermionSign = (link.fermionOrBoson == ProgramGlobals::FERMION) ? -1 : 1;
+			bool flip = false;
+			if (link.type == ProgramGlobals::ENVIRON_SYSTEM) {
+				std::swap(A, B);
+				link.value *= fermionSign;
+				flip = true;
+			}
+
+			for (SizeType p = 0; p < patches_.size(); ++p) {
+				SizeType n1 = patches_[p].n1;
+				RealType fsign = (n1 > 0 && n1%2 != 0) ? fermionSign : 1;
+				SizeType lf1 = patches_[p].j1 + patches_[p].j2*jMax;
+				for (SizeType q = 0; q < patches_.size(); ++q) {
+					SizeType lf2 = patches_[q].j1 + patches_[q].j2*jMax;
+					ComplexOrRealType lfactor = su2reduced_.reducedFactor(link.angularMomentum,
+					                                                      link.category,
+					                                                      flip,
+					                                                      lf1,
+					                                                      lf2);
+					if (lfactor == static_cast<ComplexOrRealType>(0)) continue;
+					lfactor *= link.angularFactor;
+					addTerm(p, q, fsign*link.value*lfactor, *A, *B);
+				}
+			}
+		}
+	}
+
+	void addTerm(SizeType p,
+	             SizeType q,
+	             const ComplexOrRealType& factor,
+	             const SparseMatrixType& a,
+	             const SparseMatrixType& b)
+	{
+		Term term;
+		term.in = q;
+		term.factor = factor;
+		extract(term.a, a, patches_[p].left, patches_[q].leftLocal, patches_[q].left.size());
+		if (term.a.nonZero() == 0) return;
+		extract(term.b, b, patches_[p].right, patches_[q].rightLocal, patches_[q].right.size());
+		if (term.b.nonZero() == 0) return;
+		terms_[p].push_back(term);
+	}
+
+	static void extract(SparseMatrixType& sub,
+	                    const SparseMatrixType& m,
+	                    const VectorSizeType& rows,
+	                    const VectorIntType& colLocal,
+	                    SizeType cols)
+	{
+		sub.resize(rows.size(), cols);
+		SizeType counter = 0;
+		for (SizeType a = 0; a < rows.size(); ++a) {
+			sub.setRow(a, counter);
+			SizeType row = rows[a];
+			for (int k = m.getRowPtr(row); k < m.getRowPtr(row + 1); ++k) {
+				int col = colLocal[m.getCol(k)];
+				if (col < 0) continue;
+				sub.pushCol(col);
+				sub.pushValue(m.getValue(k));
+				++counter;
+			}
+		}
+
+		sub.setRow(rows.size(), counter);
+		sub.checkValidity();
+	}
+
+	const ModelHelperType& modelHelper_;
+	const Su2ReducedType& su2reduced_;
+	SizeType rows_;
+	PsimagLite::ProgressIndicator progress_;
+	VectorPatchType patches_;
+	VectorVectorTermType terms_;
+	mutable VectorVectorType yPatches_;
+	mutable VectorVectorType xbuffers_;
+	mutable VectorVectorType tbuffers_;
+}; // class KronMatrixSu2
+
+// For helpers without a reduced basis; never constructed, because
+// MatrixVectorKron only builds KronMatrixSu2 when isSu2() is true
+template<typename ModelType>
+class KronMatrixSu2Disabled {
+
+	typedef typename ModelType::ModelHelperType ModelHelperType;
+
+public:
+
+	KronMatrixSu2Disabled(const ModelType&, const ModelHelperType&)
+	{
+		throw PsimagLite::RuntimeError("KronMatrixSu2: needs ModelHelperSu2\n");
+	}
+
+	SizeType rows() const { return 0; }
+
+	template<typename SomeVectorType>
+	void matrixVectorProduct(SomeVectorType&, const SomeVectorType&) const
+	{}
+};
+
+template<typename ModelType, typename ModelHelperType>
+struct KronMatrixSu2Select {
+	typedef KronMatrixSu2Disabled<ModelType> Type;
+};
+
+template<typename ModelType, typename LeftRightSuperType>
+struct KronMatrixSu2Select<ModelType, ModelHelperSu2<LeftRightSuperType> > {
+	typedef KronMatrixSu2<ModelType> Type;
+};
+} // namespace Dmrg
+
+/*@}*/
+#endif // KRON_MATRIX_SU2_H
@@ -83,6 +83,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Vector.h"
 #include "InitKronHamiltonian.h"
 #include "KronMatrix.h"
+#include "KronMatrixSu2.h"
 #include "MatrixVectorBase.h"
 
 namespace Dmrg {
@@ -101,6 +102,7 @@ public:
 	typedef typename ModelType::ReflectionSymmetryType ReflectionSymmetryType;
 	typedef InitKronHamiltonian<ModelType> InitKronType;
 	typedef KronMatrix<InitKronType> KronMatrixType;
+	typedef typename KronMatrixSu2Select<ModelType, ModelHelperType>::Type KronMatrixSu2Type;
 	typedef typename ModelHelperType::SparseMatrixType SparseMatrixType;
 	typedef typename SparseMatrixType::value_type ComplexOrRealType;
 	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
@@ -112,9 +114,17 @@ public:
 	                 ModelHelperType const *modelHelper,
 	                 ReflectionSymmetryType* = 0)
 	    : model_(model),
-	      initKron_(*model,*modelHelper),
-	      kronMatrix_(initKron_, "Hamiltonian")
+	      initKron_(0),
+	      kronMatrix_(0),
+	      kronSu2_(0)
 	{
+		if (ModelHelperType::isSu2()) {
+			kronSu2_ = new KronMatrixSu2Type(*model, *modelHelper);
+		} else {
+			initKron_ = new InitKronType(*model, *modelHelper);
+			kronMatrix_ = new KronMatrixType(*initKron_, "Hamiltonian");
+		}
+
 		int maxMatrixRankStored = model->params().maxMatrixRankStored;
 		if (modelHelper->size() > maxMatrixRankStored) return;
 
@@ -124,7 +134,20 @@ public:
 		checkKron();
 	}
 
-	SizeType rows() const { return initKron_.size(InitKronType::NEW); }
+	~MatrixVectorKron()
+	{
+		delete kronMatrix_;
+		kronMatrix_ = 0;
+		delete initKron_;
+		initKron_ = 0;
+		delete kronSu2_;
+		kronSu2_ = 0;
+	}
+
+	SizeType rows() const
+	{
+		return (kronSu2_) ? kronSu2_->rows() : initKron_->size(InitKronType::NEW);
+	}
 
 	template<typename SomeVectorType>
 	void matrixVectorProduct(SomeVectorType &x,SomeVectorType const &y) const
@@ -132,7 +155,7 @@ public:
 		if (matrixStored_.rows() > 0)
 			matrixStored_.matrixVectorProduct(x,y);
 		else
-			kronMatrix_.matrixVectorProduct(x,y);
+			kronProduct(x,y);
 	}
 
 	void fullDiag(VectorRealType& eigs,FullMatrixType& fm) const
@@ -142,6 +165,19 @@ public:
 
 private:
 
+	MatrixVectorKron(const MatrixVectorKron&);
+
+	MatrixVectorKron& operator=(const MatrixVectorKron&);
+
+	template<typename SomeVectorType>
+	void kronProduct(SomeVectorType &x,SomeVectorType const &y) const
+	{
+		if (kronSu2_)
+			kronSu2_->matrixVectorProduct(x,y);
+		else
+			kronMatrix_->matrixVectorProduct(x,y);
+	}
+
 	void checkKron() const
 	{
 		if (!CHECK_KRON)
@@ -158,7 +194,7 @@ private:
 			VectorType e(n, 0.0);
 			e[i] = 1.0;
 			VectorType ey(n, 0.0);
-			kronMatrix_.matrixVectorProduct(ey,e);
+			kronProduct(ey,e);
 			for (SizeType j = 0; j < n; ++j)
 				m(i, j) = ey[j];
 
@@ -172,8 +208,9 @@ private:
 	}
 
 	const ModelType* model_;
-	InitKronType initKron_;
-	KronMatrixType kronMatrix_;
+	InitKronType* initKron_;
+	KronMatrixType* kronMatrix_;
+	KronMatrixSu2Type* kronSu2_;
 	SparseMatrixType matrixStored_;
 }; // class MatrixVectorKron
 } // namespace Dmrg
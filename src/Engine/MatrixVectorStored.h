@@ -83,6 +83,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include <vector>
 #include "ProgressIndicator.h"
 #include "MatrixVectorBase.h"
+#include "HermitianSparseMatrix.h"
 
 namespace Dmrg {
 template<typename ModelType_>
@@ -101,6 +102,7 @@ public:
 	typedef typename SparseMatrixType::value_type ComplexOrRealType;
 	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
 	typedef PsimagLite::Matrix<ComplexOrRealType> FullMatrixType;
+	typedef HermitianSparseMatrix<ComplexOrRealType> HermitianSparseMatrixType;
 
 	MatrixVectorStored(ModelType const *model,
 	                   ModelHelperType const *modelHelper,
@@ -114,21 +116,29 @@ public:
 		PsimagLite::String options = model->params().options;
 		bool debugMatrix = (options.find("debugmatrix") != PsimagLite::String::npos);
 		if (!rs) {
-			matrixStored_[0].clear();
-			model->fullHamiltonian(matrixStored_[0],*modelHelper);
-			assert(isHermitian(matrixStored_[0],true));
+			// neither the full matrix nor its terms are ever built
+			model->hermitianHamiltonian(matrixStored_[0],*modelHelper);
 			PsimagLite::OstringStream msg;
 			msg<<"fullHamiltonian has rank="<<matrixStored_[0].rows();
 			msg<<" nonzeros="<<matrixStored_[0].nonZero();
 			progress_.printline(msg,std::cout);
-			if (debugMatrix)
-				printFullMatrix(matrixStored_[0],"matrix",1);
+			if (debugMatrix) {
+				SparseMatrixType matrix;
+				matrixStored_[0].toCrs(matrix);
+				printFullMatrix(matrix,"matrix",1);
+			}
+
 			return;
 		}
 
 		SparseMatrixType matrix2;
 		model->fullHamiltonian(matrix2,*modelHelper);
-		rs->transform(matrixStored_[0],matrixStored_[1],matrix2);
+		SparseMatrixType matrix0;
+		SparseMatrixType matrix1;
+		rs->transform(matrix0,matrix1,matrix2);
+		matrix2.clear();
+		matrixStored_[0].set(matrix0);
+		matrixStored_[1].set(matrix1);
 		PsimagLite::OstringStream msg;
 		msg<<" sector="<<matrixStored_[0].rows()<<" and sector="<<matrixStored_[1].rows();
 		progress_.printline(msg,std::cout);
@@ -153,16 +163,18 @@ public:
 
 	void fullDiag(VectorRealType& eigs,FullMatrixType& fm) const
 	{
+		SparseMatrixType matrix;
+		matrixStored_[pointer_].toCrs(matrix);
 		BaseType::fullDiag(eigs,
 		                   fm,
-		                   matrixStored_[pointer_],
+		                   matrix,
 		                   model_->params().maxMatrixRankStored);
 	}
 
 private:
 	ModelType const *model_;
 	ModelHelperType const *modelHelper_;
-	typename PsimagLite::Vector<SparseMatrixType>::Type matrixStored_;
+	typename PsimagLite::Vector<HermitianSparseMatrixType>::Type matrixStored_;
 	SizeType pointer_;
 	PsimagLite::ProgressIndicator progress_;
 }; // class MatrixVectorStored
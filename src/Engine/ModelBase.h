@@ -117,6 +117,7 @@ public:
 	typedef ModelCommonBase<ModelHelperType,ParametersType,GeometryType> ModelCommonBaseType;
 	typedef typename ModelCommonBaseType::LinkProductStructType LinkProductStructType;
 	typedef typename ModelCommonBaseType::VectorType VectorType;
+	typedef typename ModelCommonBaseType::HermitianSparseMatrixType HermitianSparseMatrixType;
 	typedef ParametersType SolverParamsType;
 	typedef typename ModelHelperType::LinkType LinkType;
 	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
@@ -209,6 +210,13 @@ public:
 		return modelCommon_->fullHamiltonian(matrix,modelHelper);
 	}
 
+	// H with only its diagonal and upper triangle, built row by row
+	virtual void hermitianHamiltonian(HermitianSparseMatrixType& matrix,
+	                                  const ModelHelperType& modelHelper) const
+	{
+		return modelCommon_->hermitianHamiltonian(matrix,modelHelper);
+	}
+
 	virtual SizeType getLinkProductStruct(const ModelHelperType& modelHelper) const
 	{
 		return modelCommon_->getLinkProductStruct(modelHelper);
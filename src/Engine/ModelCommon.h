@@ -86,11 +86,13 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "VerySparseMatrix.h"
 #include "IoSimple.h"
 #include "HamiltonianConnection.h"
+#include "ParallelHamiltonianConnection.h"
 #include "Su2SymmetryGlobals.h"
 #include "InputNg.h"
 #include "InputCheck.h"
 #include "ProgressIndicator.h"
 #include "NoPthreads.h"
+#include "ThreadPool.h"
 
 namespace Dmrg {
 
@@ -107,6 +109,126 @@ class ModelCommon : public ModelBaseType::ModelCommonBaseType {
 	typedef typename ModelHelperType::LinkType LinkType;
 	typedef typename GeometryType::AdditionalDataType AdditionalDataType;
 
+	// x += H y with the pre-summed connections of one sector;
+	// tasks 0 and 1 are the left and right Hamiltonians
+	class ComplementaryProduct {
+
+		typedef typename ModelHelperType::ComplementaryOperatorsType
+		ComplementaryOperatorsType;
+		typedef typename PsimagLite::Vector<SparseElementType>::Type VectorType;
+		typedef typename PsimagLite::Vector<SizeType>::Type VectorSizeType;
+		typedef PsimagLite::Concurrency ConcurrencyType;
+
+	public:
+
+		ComplementaryProduct(VectorType& x,
+		                     const VectorType& y,
+		                     const ModelHelperType& modelHelper,
+		                     const ComplementaryOperatorsType& co)
+		    : x_(x),
+		      y_(y),
+		      modelHelper_(modelHelper),
+		      co_(co),
+		      started_(ThreadPool::maxThreads(),0)
+		{}
+
+		SizeType tasks() const { return co_.size() + 2; }
+
+		void doTask(SizeType taskNumber, SizeType threadNum)
+		{
+			assert(threadNum < xtemp_.size());
+			VectorType& xtemp = xtemp_[threadNum];
+			if (!started_[threadNum]) {
+				xtemp.assign(x_.size(),0.0);
+				started_[threadNum] = 1;
+			}
+
+			if (taskNumber == 0) {
+				modelHelper_.hamiltonianLeftProduct(xtemp,y_);
+				return;
+			}
+
+			if (taskNumber == 1) {
+				modelHelper_.hamiltonianRightProduct(xtemp,y_);
+				return;
+			}
+
+			SparseMatrixType const* A = 0;
+			SparseMatrixType const* B = 0;
+			LinkType link2 = co_(&A,&B,taskNumber - 2);
+			modelHelper_.fastOpProdInter(xtemp,y_,*A,*B,link2);
+		}
+
+		void sync()
+		{
+			VectorType x(x_.size(),0);
+			for (SizeType threadNum = 0; threadNum < started_.size(); threadNum++) {
+				if (!started_[threadNum]) continue;
+				const VectorType& xtemp = xtemp_[threadNum];
+				for (SizeType i=0;i<x_.size();i++)
+					x[i]+=xtemp[i];
+			}
+
+			if (!ConcurrencyType::isMpiDisabled("HamiltonianConnection"))
+				PsimagLite::MPI::allReduce(x);
+
+			for (SizeType i=0;i<x_.size();i++)
+				x_[i] += x[i];
+		}
+
+	private:
+
+		VectorType& x_;
+		const VectorType& y_;
+		const ModelHelperType& modelHelper_;
+		const ComplementaryOperatorsType& co_;
+		ThreadScratch<VectorType> xtemp_;
+		VectorSizeType started_;
+	}; // class ComplementaryProduct
+
+	// the rows of the Hamiltonian of one sector, for HermitianSparseMatrix:
+	// the left and right Hamiltonians and the connection of each pair of
+	// sites, summed one row at a time
+	class HamiltonianRows {
+
+		typedef typename PsimagLite::Vector<SizeType>::Type VectorSizeType;
+		typedef typename PsimagLite::Vector<SparseElementType>::Type VectorType;
+		typedef HamiltonianConnection<GeometryType,
+		                              ModelHelperType,
+		                              LinkProductType> HamiltonianConnectionType;
+		typedef typename HamiltonianConnectionType::VectorConnectionType VectorConnectionType;
+
+	public:
+
+		HamiltonianRows(const GeometryType& geometry,
+		                const ModelHelperType& modelHelper)
+		    : modelHelper_(modelHelper)
+		{
+			HamiltonianConnectionType hc(geometry,modelHelper);
+			hc.connections(connections_);
+		}
+
+		SizeType rows() const { return modelHelper_.size(); }
+
+		void row(VectorSizeType& cols, VectorType* values, SizeType i) const
+		{
+			modelHelper_.hamiltonianPartRow(cols,values,i,true);
+			modelHelper_.hamiltonianPartRow(cols,values,i,false);
+			for (SizeType k = 0; k < connections_.size(); ++k)
+				modelHelper_.fastOpProdInterRow(cols,
+				                                values,
+				                                i,
+				                                *connections_[k].A,
+				                                *connections_[k].B,
+				                                connections_[k].link);
+		}
+
+	private:
+
+		const ModelHelperType& modelHelper_;
+		VectorConnectionType connections_;
+	}; // class HamiltonianRows
+
 public:
 
 	typedef PsimagLite::InputNg<InputCheck>::Readable InputValidatorType;
@@ -123,10 +245,21 @@ public:
 	typedef typename PsimagLite::Vector<OperatorType>::Type VectorOperatorType;
 	typedef typename ModelBaseType::SolverParamsType SolverParamsType;
 	typedef typename PsimagLite::Vector<LinkProductStructType>::Type VectorLinkProductStructType;
+	typedef typename ModelHelperType::ComplementaryOperatorsType ComplementaryOperatorsType;
+	typedef typename ModelCommonBaseType::HermitianSparseMatrixType HermitianSparseMatrixType;
 
 	ModelCommon(const SolverParamsType& params,const GeometryType& geometry)
-	    : ModelCommonBaseType(params,geometry),progress_("ModelCommon")
+	    : ModelCommonBaseType(params,geometry),
+	      progress_("ModelCommon"),
+	      complementaryOperators_(params.options.find("complementaryOperators") !=
+	            PsimagLite::String::npos)
 	{
+		if (complementaryOperators_ && ModelHelperType::isSu2()) {
+			PsimagLite::String str("ModelCommon: complementaryOperators ");
+			str += "cannot be used with SU(2) symmetry\n";
+			throw PsimagLite::RuntimeError(str);
+		}
+
 		if (LinkProductType::terms() > this->geometry().terms()) {
 			PsimagLite::String str("ModelCommon: NumberOfTerms must be ");
 			str += ttos(LinkProductType::terms()) + " in input file for this model\n";
@@ -172,24 +305,23 @@ public:
 	                              const LeftRightSuperType& lrs,
 	                              RealType currentTime) const
 	{
-		int bs,offset;
-		SparseMatrixType matrixBlock;
-
-		for (SizeType m=0;m<lrs.super().partition()-1;m++) {
-			offset =lrs.super().partition(m);
-			bs = lrs.super().partition(m+1)-offset;
-			matrixBlock.makeDiagonal(bs);
-			SizeType threadId = 0;
-			ModelHelperType modelHelper(m,lrs,currentTime,threadId);
-
-			VerySparseMatrixType vsm(matrixBlock.rows());
-			addHamiltonianConnection(vsm,modelHelper);
-			SparseMatrixType matrixBlock2;
-			matrixBlock2 = vsm;
-			matrixBlock += matrixBlock2;
-
-			sumBlock(matrix,matrixBlock,offset);
-		}
+		typedef ParallelHamiltonianConnection<GeometryType,
+		        ModelHelperType,
+		        HamiltonianConnectionType> ParallelHamiltonianConnectionType;
+		typedef ParallelizerThreads<ParallelHamiltonianConnectionType> ParallelizerType;
+
+		SparseMatrixType result;
+		ParallelHamiltonianConnectionType helper(result,
+		                                         matrix,
+		                                         this->geometry(),
+		                                         lrs,
+		                                         currentTime);
+		ParallelizerType parallelConnections(PsimagLite::Concurrency::npthreads);
+		parallelConnections.loopCreate(helper);
+		helper.numericPass();
+		parallelConnections.loopCreate(helper);
+
+		matrix = result;
 	}
 
 private:
@@ -202,6 +334,11 @@ private:
 	                                  const typename PsimagLite::Vector<SparseElementType>::Type& y,
 	                                  const ModelHelperType& modelHelper) const
 	{
+		if (complementaryOperators_) {
+			complementaryProduct(x,y,modelHelper);
+			return;
+		}
+
 		const LinkProductStructType& lpsConst = modelHelper.lps();
 		LinkProductStructType& lps = const_cast<LinkProductStructType&>(lpsConst);
 		LinkProductStructType lpsOne(ProgramGlobals::MAX_LPS);
@@ -256,7 +393,7 @@ private:
 			progress_.printline(msg2,std::cout);
 		}
 
-		typedef PsimagLite::Parallelizer<HamiltonianConnectionType> ParallelizerType;
+		typedef ParallelizerPool<HamiltonianConnectionType> ParallelizerType;
 		ParallelizerType parallelConnections(PsimagLite::Concurrency::npthreads,
 		                                     PsimagLite::MPI::COMM_WORLD);
 		parallelConnections.loopCreate(hc);
@@ -265,6 +402,73 @@ private:
 	}
 
 	SizeType getLinkProductStruct(const ModelHelperType& modelHelper) const
+	{
+		if (complementaryOperators_)
+			return complementaryOperators(modelHelper).size();
+
+		return fillLinkProductStruct(modelHelper);
+	}
+
+	LinkType getConnection(const SparseMatrixType** A,
+	                       const SparseMatrixType** B,
+	                       SizeType ix,
+	                       const ModelHelperType& modelHelper) const
+	{
+		if (complementaryOperators_)
+			return complementaryOperators(modelHelper)(A,B,ix);
+
+		return connectionFromLps(A,B,ix,modelHelper);
+	}
+
+	/* With SolverOptions=complementaryOperators the connections
+	 * value * A_i x B_j of this sector are folded into
+	 * A_i x (sum_j value B_j), once per sector; see ComplementaryOperators.h
+	 */
+	const ComplementaryOperatorsType& complementaryOperators(const ModelHelperType& modelHelper) const
+	{
+		const ComplementaryOperatorsType& coConst = modelHelper.complementaryOperators();
+		if (coConst.sealed()) return coConst;
+
+		ComplementaryOperatorsType& co = const_cast<ComplementaryOperatorsType&>(coConst);
+		SizeType total = fillLinkProductStruct(modelHelper);
+		for (SizeType ix = 0; ix < total; ++ix) {
+			SparseMatrixType const* A = 0;
+			SparseMatrixType const* B = 0;
+			LinkType link2 = connectionFromLps(&A,&B,ix,modelHelper);
+			if (link2.type==ProgramGlobals::ENVIRON_SYSTEM)  {
+				if (link2.fermionOrBoson == ProgramGlobals::FERMION)
+					link2.value *= -1.0;
+				co.push(*B,*A,link2.value,link2.fermionOrBoson);
+				continue;
+			}
+
+			co.push(*A,*B,link2.value,link2.fermionOrBoson);
+		}
+
+		co.seal();
+
+		PsimagLite::OstringStream msg;
+		msg<<"ComplementaryOperators: connections="<<co.connections();
+		msg<<" terms="<<co.size();
+		progress_.printline(msg,std::cout);
+		return co;
+	}
+
+	void complementaryProduct(typename PsimagLite::Vector<SparseElementType>::Type& x,
+	                          const typename PsimagLite::Vector<SparseElementType>::Type& y,
+	                          const ModelHelperType& modelHelper) const
+	{
+		typedef ParallelizerPool<ComplementaryProduct> ParallelizerType;
+
+		ComplementaryProduct helper(x,y,modelHelper,complementaryOperators(modelHelper));
+		ParallelizerType parallelConnections(PsimagLite::Concurrency::npthreads,
+		                                     PsimagLite::MPI::COMM_WORLD);
+		parallelConnections.loopCreate(helper);
+
+		helper.sync();
+	}
+
+	SizeType fillLinkProductStruct(const ModelHelperType& modelHelper) const
 	{
 		typename PsimagLite::Vector<SparseElementType>::Type x,y; // bogus
 
@@ -288,7 +492,7 @@ private:
 		}
 
 		if (lps.typesaved.size() != total) {
-			PsimagLite::String str("getLinkProductStruct: InternalError\n");
+			PsimagLite::String str("fillLinkProductStruct: InternalError\n");
 			throw PsimagLite::RuntimeError(str);
 		}
 
@@ -302,10 +506,10 @@ private:
 		return total;
 	}
 
-	LinkType getConnection(const SparseMatrixType** A,
-	                       const SparseMatrixType** B,
-	                       SizeType ix,
-	                       const ModelHelperType& modelHelper) const
+	LinkType connectionFromLps(const SparseMatrixType** A,
+	                           const SparseMatrixType** B,
+	                           SizeType ix,
+	                           const ModelHelperType& modelHelper) const
 	{
 		const LinkProductStructType& lps = modelHelper.lps();
 		typename PsimagLite::Vector<SparseElementType>::Type x,y; // bogus
@@ -347,6 +551,18 @@ private:
 		matrix = vsm;
 	}
 
+	/**
+		Returns H for basis1 and partition $m$, keeping only its diagonal
+		and upper triangle. H is built one block of rows at a time,
+		in parallel, so that neither H nor its terms are ever stored.
+		*/
+	void hermitianHamiltonian(HermitianSparseMatrixType& matrix,
+	                          const ModelHelperType& modelHelper) const
+	{
+		HamiltonianRows rows(this->geometry(),modelHelper);
+		matrix.set(rows);
+	}
+
 	void addConnectionsInNaturalBasis(SparseMatrixType& hmatrix,
 	                                  const VectorOperatorType& cm,
 	                                  const Block& block,
@@ -484,6 +700,7 @@ private:
 	}
 
 	PsimagLite::ProgressIndicator progress_;
+	bool complementaryOperators_;
 };     //class ModelCommon
 } // namespace Dmrg
 /*@}*/
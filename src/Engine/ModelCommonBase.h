@@ -84,6 +84,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include <iostream>
 
 #include "LinkProductStruct.h"
+#include "HermitianSparseMatrix.h"
 
 namespace Dmrg {
 
@@ -109,6 +110,7 @@ public:
 
 	typedef LinkProductStruct<SparseElementType> LinkProductStructType;
 	typedef typename PsimagLite::Vector<SparseElementType>::Type VectorType;
+	typedef HermitianSparseMatrix<SparseElementType> HermitianSparseMatrixType;
 
 	ModelCommonBase(const SolverParamsType& params,const GeometryType& geometry)
 	    : params_(params),geometry_(geometry)
@@ -131,6 +133,9 @@ public:
 
 	virtual void fullHamiltonian(SparseMatrixType& matrix,const ModelHelperType& modelHelper) const = 0;
 
+	virtual void hermitianHamiltonian(HermitianSparseMatrixType& matrix,
+	                                  const ModelHelperType& modelHelper) const = 0;
+
 
 	virtual void addConnectionsInNaturalBasis(SparseMatrixType& hmatrix,
 	                                          const VectorOperatorType& cm,
@@ -73,6 +73,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "PackIndices.h" // in PsimagLite
 #include "Link.h"
 #include "LinkProductStruct.h"
+#include "ComplementaryOperators.h"
 #include "Concurrency.h"
 
 /** \ingroup DMRG */
@@ -105,8 +106,10 @@ public:
 	typedef typename LeftRightSuperType::BasisWithOperatorsType BasisWithOperatorsType;
 	typedef Link<SparseElementType> LinkType;
 	typedef LinkProductStruct<SparseElementType> LinkProductStructType;
+	typedef ComplementaryOperators<SparseMatrixType> ComplementaryOperatorsType;
 	typedef typename PsimagLite::Vector<SparseElementType>::Type VectorSparseElementType;
 	typedef typename PsimagLite::Vector<SparseMatrixType>::Type VectorSparseMatrixType;
+	typedef typename PsimagLite::Vector<SizeType>::Type VectorSizeType;
 	typedef typename LeftRightSuperType::KroneckerDumperType KroneckerDumperType;
 	typedef typename LeftRightSuperType::ParamsForKroneckerDumperType
 	ParamsForKroneckerDumperType;
@@ -135,6 +138,18 @@ public:
 
 	SizeType m() const { return m_; }
 
+	// Moves this helper to partition m, keeping what does not depend
+	// on the partition, such as the transposed operators.
+	// The Kronecker dumper, if any, stays with the first partition
+	void setPartition(SizeType m)
+	{
+		if (m_ == static_cast<int>(m)) return;
+		m_ = m;
+		createBuffer();
+		createAlphaAndBeta();
+		complementaryOperators_ = ComplementaryOperatorsType();
+	}
+
 	const RealType& time() const { return targetTime_; }
 
 	static bool isSu2() { return false; }
@@ -225,6 +240,47 @@ public:
 		matrixBlock.setRow(i,counter);
 	}
 
+	// Appends to cols the columns of row i of the block that
+	// fastOpProdInter(A,B,matrixBlock,link) builds, and their values to
+	// values, unless values is zero
+	void fastOpProdInterRow(VectorSizeType& cols,
+	                        VectorSparseElementType* values,
+	                        SizeType i,
+	                        SparseMatrixType const &A,
+	                        SparseMatrixType const &B,
+	                        const LinkType& link) const
+	{
+		RealType fermionSign =(link.fermionOrBoson==ProgramGlobals::FERMION) ? -1 : 1;
+
+		if (link.type==ProgramGlobals::ENVIRON_SYSTEM)  {
+			LinkType link2 = link;
+			link2.value *= fermionSign;
+			link2.type = ProgramGlobals::SYSTEM_ENVIRON;
+			fastOpProdInterRow(cols,values,i,B,A,link2);
+			return;
+		}
+
+		assert(i < alpha_.size());
+		int alpha=alpha_[i];
+		int beta=beta_[i];
+
+		SparseElementType fsValue = (fermionSign < 0 && fermionSigns_[i])
+		        ? -link.value
+		        : link.value;
+
+		for (int k=A.getRowPtr(alpha);k<A.getRowPtr(alpha+1);k++) {
+			int alphaPrime = A.getCol(k);
+			for (int kk=B.getRowPtr(beta);kk<B.getRowPtr(beta+1);kk++) {
+				int betaPrime= B.getCol(kk);
+				int j = buffer_[alphaPrime][betaPrime];
+				if (j<0) continue;
+				cols.push_back(j);
+				if (values)
+					values->push_back(A.getValue(k) * B.getValue(kk)*fsValue);
+			}
+		}
+	}
+
 	// Does x+= (AB)y, where A belongs to pSprime and B  belongs to pEprime or
 	// viceversa (inter)
 	// Has been changed to accomodate for reflection symmetry
@@ -415,6 +471,35 @@ public:
 		matrixBlock.setRow(lrs_.super().partition(m+1)-offset,counter);
 	}
 
+	// Appends to cols the columns of row i of the block that
+	// calcHamiltonianPart(matrixBlock,option) builds, and their values
+	// to values, unless values is zero
+	void hamiltonianPartRow(VectorSizeType& cols,
+	                        VectorSparseElementType* values,
+	                        SizeType i,
+	                        bool option) const
+	{
+		SizeType offset = lrs_.super().partition(m_);
+		SizeType end = lrs_.super().partition(m_+1);
+		SizeType ns=lrs_.left().size();
+		const SparseMatrixType& hamiltonian = (option) ? lrs_.left().hamiltonian()
+		                                               : lrs_.right().hamiltonian();
+
+		assert(i < alpha_.size());
+		SizeType alpha = alpha_[i];
+		SizeType beta = beta_[i];
+		SizeType r = (option) ? alpha : beta;
+		assert(r<hamiltonian.rows());
+		for (int k=hamiltonian.getRowPtr(r);k<hamiltonian.getRowPtr(r+1);k++) {
+			SizeType alphaPrime = (option) ? hamiltonian.getCol(k) : alpha;
+			SizeType betaPrime = (option) ? beta : hamiltonian.getCol(k);
+			SizeType j = lrs_.super().permutationInverse(alphaPrime + betaPrime*ns);
+			if (j<offset || j>=end) continue;
+			cols.push_back(j-offset);
+			if (values) values->push_back(hamiltonian.getValue(k));
+		}
+	}
+
 	const LeftRightSuperType& leftRightSuper() const
 	{
 		return lrs_;
@@ -424,6 +509,11 @@ public:
 
 	const LinkProductStructType& lps() const { return lps_; }
 
+	const ComplementaryOperatorsType& complementaryOperators() const
+	{
+		return complementaryOperators_;
+	}
+
 private:
 
 	const SparseMatrixType& getTcOperator(int i,SizeType sigma,SizeType type) const
@@ -518,10 +608,11 @@ private:
 	SizeType threadId_;
 	typename PsimagLite::Vector<PsimagLite::Vector<int>::Type>::Type buffer_;
 	VectorSparseMatrixType basis2tc_,basis3tc_;
-	typename PsimagLite::Vector<SizeType>::Type alpha_,beta_;
+	VectorSizeType alpha_,beta_;
 	typename PsimagLite::Vector<bool>::Type fermionSigns_;
 	mutable KroneckerDumperType kroneckerDumper_;
 	mutable LinkProductStructType lps_;
+	mutable ComplementaryOperatorsType complementaryOperators_;
 }; // class ModelHelperLocal
 } // namespace Dmrg
 /*@}*/
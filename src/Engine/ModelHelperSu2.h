@@ -75,6 +75,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Su2Reduced.h"
 #include "Link.h"
 #include "LinkProductStruct.h"
+#include "ComplementaryOperators.h"
 
 /** \ingroup DMRG */
 /*@{*/
@@ -109,9 +110,12 @@ public:
 	typedef typename SparseMatrixType::value_type SparseElementType;
 	typedef Link<SparseElementType> LinkType;
 	typedef LinkProductStruct<SparseElementType> LinkProductStructType;
+	typedef ComplementaryOperators<SparseMatrixType> ComplementaryOperatorsType;
 	typedef typename PsimagLite::Vector<SparseElementType>::Type VectorSparseElementType;
+	typedef typename PsimagLite::Vector<SizeType>::Type VectorSizeType;
 	typedef typename LeftRightSuperType::ParamsForKroneckerDumperType
 	ParamsForKroneckerDumperType;
+	typedef Su2Reduced<LeftRightSuperType> Su2ReducedType;
 
 	ModelHelperSu2(int m,
 	               const LeftRightSuperType& lrs,
@@ -122,8 +126,27 @@ public:
 	      lrs_(lrs),
 	      targetTime_(targetTime),
 	      threadId_(threadId),
-	      su2reduced_(m,lrs)
-	{}
+	      su2reduced_(new Su2ReducedType(m,lrs))
+	{
+		createReducedOfRow();
+	}
+
+	~ModelHelperSu2()
+	{
+		delete su2reduced_;
+	}
+
+	// Moves this helper to partition m
+	void setPartition(SizeType m)
+	{
+		if (m_ == static_cast<int>(m)) return;
+		m_ = m;
+		delete su2reduced_;
+		su2reduced_ = 0;
+		su2reduced_ = new Su2ReducedType(m,lrs_);
+		createReducedOfRow();
+		complementaryOperators_ = ComplementaryOperatorsType();
+	}
 
 	static bool isSu2() { return true; }
 
@@ -181,13 +204,13 @@ public:
 		matrixBlock.resize(total,total);
 
 		SizeType counter=0;
-		for (SizeType i=0;i<su2reduced_.reducedEffectiveSize();i++) {
-			int ix = su2reduced_.flavorMapping(i)-offset;
+		for (SizeType i=0;i<su2reduced_->reducedEffectiveSize();i++) {
+			int ix = su2reduced_->flavorMapping(i)-offset;
 			if (ix<0 || ix>=int(matrixBlock.rows())) continue;
 			matrixBlock.setRow(ix,counter);
 
-			SizeType i1=su2reduced_.reducedEffective(i).first;
-			SizeType i2=su2reduced_.reducedEffective(i).second;
+			SizeType i1=su2reduced_->reducedEffective(i).first;
+			SizeType i2=su2reduced_->reducedEffective(i).second;
 			PairType jm1 = lrs_.left().jmValue(lrs_.left().reducedIndex(i1));
 
 			SizeType n1=lrs_.left().electrons(lrs_.left().reducedIndex(i1));
@@ -208,7 +231,7 @@ public:
 					                                         reducedIndex(i2prime));
 					SparseElementType lfactor;
 					SizeType lf2 =jm1prime.first + jm2prime.first*lrs_.left().jMax();
-					lfactor=su2reduced_.reducedFactor(link.angularMomentum,
+					lfactor=su2reduced_->reducedFactor(link.angularMomentum,
 					                                  link.category,
 					                                  flip,
 					                                  lf1,
@@ -217,7 +240,7 @@ public:
 
 					lfactor *= link.angularFactor;
 
-					int jx = su2reduced_.flavorMapping(i1prime,i2prime)-offset;
+					int jx = su2reduced_->flavorMapping(i1prime,i2prime)-offset;
 					if (jx<0 || jx >= int(matrixBlock.rows()) ) continue;
 
 					matrixBlock.pushCol(jx);
@@ -230,6 +253,76 @@ public:
 		matrixBlock.setRow(matrixBlock.rows(),counter);
 	}
 
+	// Appends to cols the columns of row ix of the block that
+	// fastOpProdInter(A,B,matrixBlock,link) builds, and their values to
+	// values, unless values is zero. The reduced factors are needed
+	// either way, because they decide which entries are there
+	void fastOpProdInterRow(VectorSizeType& cols,
+	                        VectorSparseElementType* values,
+	                        SizeType ix,
+	                        SparseMatrixType const &A,
+	                        SparseMatrixType const &B,
+	                        const LinkType& link,
+	                        bool flip=false) const
+	{
+		RealType fermionSign = (link.fermionOrBoson==ProgramGlobals::FERMION) ? -1 : 1;
+
+		if (link.type==ProgramGlobals::ENVIRON_SYSTEM)  {
+			LinkType link2 = link;
+			link2.value *= fermionSign;
+			link2.type = ProgramGlobals::SYSTEM_ENVIRON;
+			fastOpProdInterRow(cols,values,ix,B,A,link2,true);
+			return;
+		}
+
+		assert(ix < reducedOfRow_.size());
+		int i = reducedOfRow_[ix];
+		if (i < 0) return;
+
+		int offset = lrs_.super().partition(m_);
+		int total = lrs_.super().partition(m_+1) - offset;
+
+		SizeType i1=su2reduced_->reducedEffective(i).first;
+		SizeType i2=su2reduced_->reducedEffective(i).second;
+		PairType jm1 = lrs_.left().jmValue(lrs_.left().reducedIndex(i1));
+
+		SizeType n1=lrs_.left().electrons(lrs_.left().reducedIndex(i1));
+		RealType fsign=1;
+		if (n1>0 && n1%2!=0) fsign= fermionSign;
+
+		PairType jm2 = lrs_.right().jmValue(lrs_.right().reducedIndex(i2));
+		SizeType lf1 =jm1.first + jm2.first*lrs_.left().jMax();
+
+		for (int k1=A.getRowPtr(i1);k1<A.getRowPtr(i1+1);k1++) {
+			SizeType i1prime = A.getCol(k1);
+			PairType jm1prime = lrs_.left().jmValue(lrs_.left().
+			                                        reducedIndex(i1prime));
+
+			for (int k2=B.getRowPtr(i2);k2<B.getRowPtr(i2+1);k2++) {
+				SizeType i2prime = B.getCol(k2);
+				PairType jm2prime = lrs_.right().jmValue(lrs_.right().
+				                                         reducedIndex(i2prime));
+				SizeType lf2 =jm1prime.first + jm2prime.first*lrs_.left().jMax();
+				SparseElementType lfactor=su2reduced_->reducedFactor(link.angularMomentum,
+				                                                     link.category,
+				                                                     flip,
+				                                                     lf1,
+				                                                     lf2);
+				if (lfactor==static_cast<SparseElementType>(0)) continue;
+
+				lfactor *= link.angularFactor;
+
+				int jx = su2reduced_->flavorMapping(i1prime,i2prime)-offset;
+				if (jx<0 || jx >= total) continue;
+
+				cols.push_back(jx);
+				if (values)
+					values->push_back(fsign*link.value*lfactor*
+					                  A.getValue(k1)*B.getValue(k2));
+			}
+		}
+	}
+
 	// Does x+= (AB)y, where A belongs to pSprime and B
 	// belongs to pEprime or viceversa (inter)
 	// Has been changed to accomodate for reflection symmetry
@@ -255,12 +348,12 @@ public:
 		int m = m_;
 		int offset = lrs_.super().partition(m);
 
-		for (SizeType i=0;i<su2reduced_.reducedEffectiveSize();i++) {
-			int ix = su2reduced_.flavorMapping(i)-offset;
+		for (SizeType i=0;i<su2reduced_->reducedEffectiveSize();i++) {
+			int ix = su2reduced_->flavorMapping(i)-offset;
 			if (ix<0 || ix>=int(x.size())) continue;
 
-			SizeType i1=su2reduced_.reducedEffective(i).first;
-			SizeType i2=su2reduced_.reducedEffective(i).second;
+			SizeType i1=su2reduced_->reducedEffective(i).first;
+			SizeType i2=su2reduced_->reducedEffective(i).second;
 			PairType jm1 = lrs_.left().jmValue(lrs_.left().reducedIndex(i1));
 			SizeType n1=lrs_.left().electrons(lrs_.left().reducedIndex(i1));
 			RealType fsign=1;
@@ -282,7 +375,7 @@ public:
 					SparseElementType lfactor;
 					SizeType lf2 =jm1prime.first + jm2prime.first*lrs_.left().jMax();
 
-					lfactor=su2reduced_.reducedFactor(link.angularMomentum,
+					lfactor=su2reduced_->reducedFactor(link.angularMomentum,
 					                                  link.category,
 					                                  flipped,
 					                                  lf1,
@@ -290,7 +383,7 @@ public:
 					if (lfactor==static_cast<SparseElementType>(0)) continue;
 					lfactor *= link.angularFactor;
 
-					int jx = su2reduced_.flavorMapping(i1prime,i2prime)-offset;
+					int jx = su2reduced_->flavorMapping(i1prime,i2prime)-offset;
 					if (jx<0 || jx >= int(y.size()) ) continue;
 
 					x[ix] += fsign*link.value*lfactor*
@@ -312,26 +405,26 @@ public:
 		//! work only on partition m
 		int m = m_;
 		int offset = lrs_.super().partition(m);
-		const SparseMatrixType& A = su2reduced_.hamiltonianLeft();
+		const SparseMatrixType& A = su2reduced_->hamiltonianLeft();
 
-		for (SizeType i=0;i<su2reduced_.reducedEffectiveSize();i++) {
-			int ix = su2reduced_.flavorMapping(i)-offset;
+		for (SizeType i=0;i<su2reduced_->reducedEffectiveSize();i++) {
+			int ix = su2reduced_->flavorMapping(i)-offset;
 			if (ix<0 || ix>=int(x.size())) continue;
 
-			SizeType i1=su2reduced_.reducedEffective(i).first;
-			SizeType i2=su2reduced_.reducedEffective(i).second;
+			SizeType i1=su2reduced_->reducedEffective(i).first;
+			SizeType i2=su2reduced_->reducedEffective(i).second;
 
 			PairType jm1 = lrs_.left().jmValue(lrs_.left().reducedIndex(i1));
 			PairType jm2 = lrs_.right().jmValue(lrs_.right().reducedIndex(i2));
 
 			for (int k1=A.getRowPtr(i1);k1<A.getRowPtr(i1+1);k1++) {
 				SizeType i1prime = A.getCol(k1);
-				SparseElementType lfactor=su2reduced_.reducedHamiltonianFactor(jm1.first,
+				SparseElementType lfactor=su2reduced_->reducedHamiltonianFactor(jm1.first,
 				                                                               jm2.first);
 
 				if (lfactor==static_cast<SparseElementType>(0)) continue;
 
-				int jx = su2reduced_.flavorMapping(i1prime,i2)-offset;
+				int jx = su2reduced_->flavorMapping(i1prime,i2)-offset;
 				if (jx<0 || jx >= int(y.size()) ) continue;
 
 				x[ix] += A.getValue(k1)*y[jx];
@@ -350,24 +443,24 @@ public:
 		//! work only on partition m
 		int m = m_;
 		int offset = lrs_.super().partition(m);
-		const SparseMatrixType& B = su2reduced_.hamiltonianRight();
+		const SparseMatrixType& B = su2reduced_->hamiltonianRight();
 
-		for (SizeType i=0;i<su2reduced_.reducedEffectiveSize();i++) {
-			int ix = su2reduced_.flavorMapping(i)-offset;
+		for (SizeType i=0;i<su2reduced_->reducedEffectiveSize();i++) {
+			int ix = su2reduced_->flavorMapping(i)-offset;
 			if (ix<0 || ix>=int(x.size())) continue;
 
-			SizeType i1=su2reduced_.reducedEffective(i).first;
-			SizeType i2=su2reduced_.reducedEffective(i).second;
+			SizeType i1=su2reduced_->reducedEffective(i).first;
+			SizeType i2=su2reduced_->reducedEffective(i).second;
 			PairType jm1 = lrs_.left().jmValue(lrs_.left().reducedIndex(i1));
 			PairType jm2 = lrs_.right().jmValue(lrs_.right().reducedIndex(i2));
 
 			for (int k2=B.getRowPtr(i2);k2<B.getRowPtr(i2+1);k2++) {
 				SizeType i2prime = B.getCol(k2);
-				SparseElementType lfactor=su2reduced_.reducedHamiltonianFactor(jm1.first,
+				SparseElementType lfactor=su2reduced_->reducedHamiltonianFactor(jm1.first,
 				                                                               jm2.first);
 				if (lfactor==static_cast<SparseElementType>(0)) continue;
 
-				int jx = su2reduced_.flavorMapping(i1,i2prime)-offset;
+				int jx = su2reduced_->flavorMapping(i1,i2prime)-offset;
 				if (jx<0 || jx >= int(y.size()) ) continue;
 
 				x[ix] += B.getValue(k2)*y[jx];
@@ -382,28 +475,28 @@ public:
 		int m = m_;
 		int offset = lrs_.super().partition(m);
 		int bs = lrs_.super().partition(m+1)-offset;
-		const SparseMatrixType& A = su2reduced_.hamiltonianLeft();
+		const SparseMatrixType& A = su2reduced_->hamiltonianLeft();
 
 		matrixBlock.resize(bs,bs);
 		SizeType counter=0;
-		for (SizeType i=0;i<su2reduced_.reducedEffectiveSize();i++) {
-			int ix = su2reduced_.flavorMapping(i)-offset;
+		for (SizeType i=0;i<su2reduced_->reducedEffectiveSize();i++) {
+			int ix = su2reduced_->flavorMapping(i)-offset;
 			matrixBlock.setRow(ix,counter);
 			if (ix<0 || ix>=int(matrixBlock.rows())) continue;
 
-			SizeType i1=su2reduced_.reducedEffective(i).first;
-			SizeType i2=su2reduced_.reducedEffective(i).second;
+			SizeType i1=su2reduced_->reducedEffective(i).first;
+			SizeType i2=su2reduced_->reducedEffective(i).second;
 			PairType jm1 = lrs_.left().jmValue(lrs_.left().reducedIndex(i1));
 			PairType jm2 = lrs_.right().jmValue(lrs_.right().reducedIndex(i2));
 
 			for (int k1=A.getRowPtr(i1);k1<A.getRowPtr(i1+1);k1++) {
 				SizeType i1prime = A.getCol(k1);
-				SparseElementType lfactor=su2reduced_.reducedHamiltonianFactor(jm1.first,
+				SparseElementType lfactor=su2reduced_->reducedHamiltonianFactor(jm1.first,
 				                                                               jm2.first);
 
 				if (lfactor==static_cast<SparseElementType>(0)) continue;
 
-				int jx = su2reduced_.flavorMapping(i1prime,i2)-offset;
+				int jx = su2reduced_->flavorMapping(i1prime,i2)-offset;
 				if (jx<0 || jx >= int(matrixBlock.rows()) ) continue;
 
 				matrixBlock.pushCol(jx);
@@ -421,27 +514,27 @@ public:
 		int m = m_;
 		int offset = lrs_.super().partition(m);
 		int bs = lrs_.super().partition(m+1)-offset;
-		const SparseMatrixType& B = su2reduced_.hamiltonianRight();
+		const SparseMatrixType& B = su2reduced_->hamiltonianRight();
 
 		matrixBlock.resize(bs,bs);
 		SizeType counter=0;
-		for (SizeType i=0;i<su2reduced_.reducedEffectiveSize();i++) {
-			int ix = su2reduced_.flavorMapping(i)-offset;
+		for (SizeType i=0;i<su2reduced_->reducedEffectiveSize();i++) {
+			int ix = su2reduced_->flavorMapping(i)-offset;
 			matrixBlock.setRow(ix,counter);
 			if (ix<0 || ix>=int(matrixBlock.rows())) continue;
 
-			SizeType i1=su2reduced_.reducedEffective(i).first;
-			SizeType i2=su2reduced_.reducedEffective(i).second;
+			SizeType i1=su2reduced_->reducedEffective(i).first;
+			SizeType i2=su2reduced_->reducedEffective(i).second;
 			PairType jm1 = lrs_.left().jmValue(lrs_.left().reducedIndex(i1));
 			PairType jm2 = lrs_.right().jmValue(lrs_.right().reducedIndex(i2));
 
 			for (int k2=B.getRowPtr(i2);k2<B.getRowPtr(i2+1);k2++) {
 				SizeType i2prime = B.getCol(k2);
-				SparseElementType lfactor=su2reduced_.reducedHamiltonianFactor(jm1.first,
+				SparseElementType lfactor=su2reduced_->reducedHamiltonianFactor(jm1.first,
 				                                                               jm2.first);
 				if (lfactor==static_cast<SparseElementType>(0)) continue;
 
-				int jx = su2reduced_.flavorMapping(i1,i2prime)-offset;
+				int jx = su2reduced_->flavorMapping(i1,i2prime)-offset;
 				if (jx<0 || jx >= int(matrixBlock.rows()) ) continue;
 
 				matrixBlock.pushCol(jx);
@@ -464,6 +557,43 @@ public:
 		else calcHamiltonianPartRight(matrixBlock);
 	}
 
+	// Appends to cols the columns of row ix of the block that
+	// calcHamiltonianPart(matrixBlock,option) builds, and their values
+	// to values, unless values is zero
+	void hamiltonianPartRow(VectorSizeType& cols,
+	                        VectorSparseElementType* values,
+	                        SizeType ix,
+	                        bool option) const
+	{
+		assert(ix < reducedOfRow_.size());
+		int i = reducedOfRow_[ix];
+		if (i < 0) return;
+
+		int offset = lrs_.super().partition(m_);
+		int total = lrs_.super().partition(m_+1) - offset;
+		const SparseMatrixType& A = (option) ? su2reduced_->hamiltonianLeft()
+		                                     : su2reduced_->hamiltonianRight();
+
+		SizeType i1=su2reduced_->reducedEffective(i).first;
+		SizeType i2=su2reduced_->reducedEffective(i).second;
+		PairType jm1 = lrs_.left().jmValue(lrs_.left().reducedIndex(i1));
+		PairType jm2 = lrs_.right().jmValue(lrs_.right().reducedIndex(i2));
+		SparseElementType lfactor=su2reduced_->reducedHamiltonianFactor(jm1.first,
+		                                                               jm2.first);
+		if (lfactor==static_cast<SparseElementType>(0)) return;
+
+		SizeType r = (option) ? i1 : i2;
+		for (int k=A.getRowPtr(r);k<A.getRowPtr(r+1);k++) {
+			SizeType rprime = A.getCol(k);
+			int jx = (option) ? su2reduced_->flavorMapping(rprime,i2)-offset
+			                  : su2reduced_->flavorMapping(i1,rprime)-offset;
+			if (jx<0 || jx >= total) continue;
+
+			cols.push_back(jx);
+			if (values) values->push_back(A.getValue(k));
+		}
+	}
+
 	SizeType m() const {return m_;}
 
 	const LeftRightSuperType& leftRightSuper() const
@@ -475,14 +605,43 @@ public:
 
 	const LinkProductStructType& lps() const { return lps_; }
 
+	const ComplementaryOperatorsType& complementaryOperators() const
+	{
+		return complementaryOperators_;
+	}
+
+	const Su2ReducedType& su2reduced() const
+	{
+		return *su2reduced_;
+	}
+
 private:
 
+	ModelHelperSu2(const ModelHelperSu2&);
+
+	ModelHelperSu2& operator=(const ModelHelperSu2&);
+
+	// reduced index of each row of partition m_, as in fastOpProdInter
+	void createReducedOfRow()
+	{
+		int offset = lrs_.super().partition(m_);
+		int total = lrs_.super().partition(m_+1) - offset;
+		reducedOfRow_.assign(total,-1);
+		for (SizeType i=0;i<su2reduced_->reducedEffectiveSize();i++) {
+			int ix = su2reduced_->flavorMapping(i)-offset;
+			if (ix<0 || ix>=total) continue;
+			reducedOfRow_[ix] = i;
+		}
+	}
+
 	int m_;
 	const LeftRightSuperType&  lrs_;
 	RealType targetTime_;
 	SizeType threadId_;
-	Su2Reduced<LeftRightSuperType> su2reduced_;
+	Su2ReducedType* su2reduced_;
+	PsimagLite::Vector<int>::Type reducedOfRow_;
 	LinkProductStructType lps_;
+	ComplementaryOperatorsType complementaryOperators_;
 };
 } // namespace Dmrg
 /*@}*/
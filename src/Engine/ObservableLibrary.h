@@ -113,16 +113,18 @@ public:
 
 	template<typename IoInputter>
 	ObservableLibrary(IoInputter& io,
+	                  const SerializerIndex& index,
 	                  SizeType numberOfSites,
 	                  bool hasTimeEvolution,
 	                  const ModelType& model,
 	                  SizeType nf,
 	                  SizeType trail,
-	                  bool verbose)
+	                  bool verbose,
+	                  SizeType cacheSize = 0)
 	    : numberOfSites_(numberOfSites),
 	      hasTimeEvolution_(hasTimeEvolution),
 	      model_(model),
-	      observe_(io,nf,trail,hasTimeEvolution,model,verbose)
+	      observe_(io,index,nf,trail,hasTimeEvolution,model,verbose,cacheSize)
 	{
 		PsimagLite::String modelName = model.params().model;
 		bool hubbardLike = (modelName == "HubbardOneBand" ||
@@ -87,6 +87,8 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "VectorWithOffset.h" // for operator*
 #include "Profiling.h"
 #include "Parallel4PointDs.h"
+#include "Parallel3PointCorrelations.h"
+#include "Parallel4PointCorrelations.h"
 #include "MultiPointCorrelations.h"
 #include "Concurrency.h"
 #include "Parallelizer.h"
@@ -116,6 +118,12 @@ class Observer {
 	typedef FourPointCorrelations<CorrelationsSkeletonType> FourPointCorrelationsType;
 	typedef MultiPointCorrelations<CorrelationsSkeletonType> MultiPointCorrelationsType;
 	typedef PsimagLite::Profiling ProfilingType;
+	typedef Parallel3PointCorrelations<FourPointCorrelationsType>
+	Parallel3PointCorrelationsType;
+	typedef Parallel4PointCorrelations<FourPointCorrelationsType>
+	Parallel4PointCorrelationsType;
+	typedef typename Parallel4PointCorrelationsType::PairType PairType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
 
 	static SizeType const GROW_RIGHT = CorrelationsSkeletonType::GROW_RIGHT;
 	static SizeType const GROW_LEFT = CorrelationsSkeletonType::GROW_LEFT;
@@ -133,12 +141,21 @@ public:
 	typedef Parallel4PointDs<ModelType,FourPointCorrelationsType> Parallel4PointDsType;
 
 	Observer(IoInputType& io,
+	         const SerializerIndex& index,
 	         SizeType nf,
 	         SizeType trail,
 	         bool hasTimeEvolution,
 	         const ModelType& model,
-	         bool verbose=false)
-	    : helper_(io,nf,trail,model.params().nthreads,hasTimeEvolution,verbose),
+	         bool verbose=false,
+	         SizeType cacheSize=0)
+	    : helper_(io,
+	              index,
+	              nf,
+	              trail,
+	              model.params().nthreads,
+	              hasTimeEvolution,
+	              verbose,
+	              cacheSize),
 	      verbose_(verbose),
 	      onepoint_(helper_),
 	      skeleton_(helper_,model,verbose),
@@ -204,13 +221,19 @@ public:
 		case 0: // no sites given
 			return twopoint_(storage,m0,m1,fermionSign);
 		case 1: //first site given
-			for (site1 = 0; site1 < sites; ++site1)
+			for (site1 = 0; site1 < braket.site(0) && site1 < sites; ++site1)
 				storage(braket.site(0),site1) = twopoint_.calcCorrelation(braket.site(0),
 				                                                          site1,
 				                                                          braket.op(0).data,
 				                                                          braket.op(1).data,
 				                                                          fermionSign,
 				                                                          threadId);
+			twopoint_.calcCorrelationRow(storage,
+			                             braket.site(0),
+			                             braket.op(0).data,
+			                             braket.op(1).data,
+			                             fermionSign,
+			                             threadId);
 			return;
 
 		case 3:
@@ -276,35 +299,39 @@ public:
 			return;
 		}
 
+		VectorSizeType sites;
 		if (flag == 1) {
-			SizeType site0 = braket.site(0);
-			std::cout<<"#Fixed site0= "<<site0<<"\n";
-			for (SizeType site1 = site0+1; site1 < rows; ++site1) {
-				for (SizeType site2 = site1+1; site2 < cols; ++site2) {
-					typename MatrixType::value_type tmp = fourpoint_.threePoint(site0,
-					                                                            site1,
-					                                                            site2,
-					                                                            braket,
-					                                                            threadId);
-					std::cout<<site1<<" "<<site2<<"  "<<tmp<<"\n";
+			sites.push_back(braket.site(0));
+			std::cout<<"#Fixed site0= "<<sites[0]<<"\n";
+		} else {
+			assert(flag == 0);
+			for (SizeType site0 = 0; site0 < rows; ++site0)
+				sites.push_back(site0);
+		}
 
-				}
-			}
+		typename Parallel3PointCorrelationsType::VectorVectorFieldType values;
+		typedef PsimagLite::Parallelizer<Parallel3PointCorrelationsType> ParallelizerType;
+		ParallelizerType threaded3Points(PsimagLite::Concurrency::npthreads,
+		                                 PsimagLite::MPI::COMM_WORLD);
 
-			return;
-		}
+		Parallel3PointCorrelationsType helper3Points(values,
+		                                             fourpoint_,
+		                                             sites,
+		                                             rows,
+		                                             cols,
+		                                             braket);
+
+		threaded3Points.loopCreate(helper3Points);
+		helper3Points.sync();
 
-		assert(flag == 0);
-		for (SizeType site0 = 0; site0 < rows; ++site0) {
+		for (SizeType x = 0; x < sites.size(); ++x) {
+			SizeType site0 = sites[x];
+			SizeType counter = 0;
 			for (SizeType site1 = site0+1; site1 < rows; ++site1) {
 				for (SizeType site2 = site1+1; site2 < cols; ++site2) {
-
-					typename MatrixType::value_type tmp = fourpoint_.threePoint(site0,
-					                                                            site1,
-					                                                            site2,
-					                                                            braket,
-					                                                            threadId);
-					std::cout<<site0<<" "<<site1<<" "<<site2<<"  "<<tmp<<"\n";
+					assert(counter < values[x].size());
+					if (flag == 0) std::cout<<site0<<" ";
+					std::cout<<site1<<" "<<site2<<"  "<<values[x][counter++]<<"\n";
 				}
 			}
 		}
@@ -366,52 +393,45 @@ public:
 			return;
 		}
 
+		typename Parallel4PointCorrelationsType::VectorPairType pairs;
 		if (flag == 3) {
-			SizeType site0 = braket.site(0);
-			SizeType site1 = braket.site(1);
-			std::cout<<"#Fixed site0= "<<site0<<"\n";
-			std::cout<<"#Fixed site1= "<<site1<<"\n";
-			typename FourPointCorrelationsType::SparseMatrixType O2gt;
-			fourpoint_.firstStage(O2gt,'N',site0,'N',site1,braket,0,1,threadId);
+			pairs.push_back(PairType(braket.site(0),braket.site(1)));
+			std::cout<<"#Fixed site0= "<<braket.site(0)<<"\n";
+			std::cout<<"#Fixed site1= "<<braket.site(1)<<"\n";
+		} else {
+			assert(flag == 0);
+			for (SizeType site0 = 0; site0 < rows; ++site0)
+				for (SizeType site1 = site0+1; site1 < cols; ++site1)
+					pairs.push_back(PairType(site0,site1));
+		}
 
+		typename Parallel4PointCorrelationsType::VectorVectorFieldType values;
+		typedef PsimagLite::Parallelizer<Parallel4PointCorrelationsType> ParallelizerType;
+		ParallelizerType threaded4Points(PsimagLite::Concurrency::npthreads,
+		                                 PsimagLite::MPI::COMM_WORLD);
+
+		Parallel4PointCorrelationsType helper4Points(values,
+		                                             fourpoint_,
+		                                             pairs,
+		                                             rows,
+		                                             cols,
+		                                             braket);
+
+		threaded4Points.loopCreate(helper4Points);
+		helper4Points.sync();
+
+		for (SizeType x = 0; x < pairs.size(); ++x) {
+			SizeType site0 = pairs[x].first;
+			SizeType site1 = pairs[x].second;
+			SizeType counter = 0;
 			for (SizeType site2 = site1+1; site2 < rows; ++site2) {
 				for (SizeType site3 = site2+1; site3 < cols; ++site3) {
-					typename MatrixType::value_type tmp = fourpoint_.secondStage(O2gt,
-					                                                             site1,
-					                                                             'N',
-					                                                             site2,
-					                                                             'N',
-					                                                             site3,
-					                                                             braket,
-					                                                             2,
-					                                                             3,
-					                                                             threadId);
-					std::cout<<site2<<" "<<site3<<" "<<tmp<<"\n";
-				}
-			}
-
-			return;
-		}
-
-		assert(flag == 0);
-		for (SizeType site0 = 0; site0 < rows; ++site0) {
-			for (SizeType site1 = site0+1; site1 < cols; ++site1) {
-				for (SizeType site2 = site1+1; site2 < rows; ++site2) {
-					for (SizeType site3 = site2+1; site3 < cols; ++site3) {
-						typename FourPointCorrelationsType::SparseMatrixType O2gt;
-						fourpoint_.firstStage(O2gt,'N',site0,'N',site1,braket,0,1,threadId);
-						typename MatrixType::value_type tmp = fourpoint_.secondStage(O2gt,
-						                                                             site1,
-						                                                             'N',
-						                                                             site2,
-						                                                             'N',
-						                                                             site3,
-						                                                             braket,
-						                                                             2,
-						                                                             3,
-						                                                             threadId);
+					assert(counter < values[x].size());
+					if (flag == 0) {
 						std::cout<<site0<<" "<<site1<<" ";
-						std::cout<<site2<<" "<<site3<<" "<<tmp<<"\n";
+						std::cout<<site2<<" "<<site3<<" "<<values[x][counter++]<<"\n";
+					} else {
+						std::cout<<site2<<" "<<site3<<" "<<values[x][counter++]<<"\n";
 					}
 				}
 			}
@@ -84,6 +84,9 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "DmrgSerializer.h"
 #include "VectorWithOffsets.h" // to include norm
 #include "VectorWithOffset.h" // to include norm
+#include "SerializerIndex.h"
+#include "BinaryStore.h"
+#include "Concurrency.h"
 
 namespace Dmrg {
 template<
@@ -109,26 +112,53 @@ public:
 	typedef typename BasisWithOperatorsType::OperatorType OperatorType;
 	typedef DmrgSerializer<LeftRightSuperType,VectorWithOffsetType> DmrgSerializerType;
 	typedef typename DmrgSerializerType::FermionSignType FermionSignType;
+	typedef PsimagLite::Concurrency ConcurrencyType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
 
 	enum {LEFT_BRAKET=0,RIGHT_BRAKET=1};
 	enum SaveEnum {SAVE_YES, SAVE_NO};
 
+	// index is that of io's file, built once by the caller and shared
+	// by the helpers of all sweeps. cacheSize is the maximum number of
+	// steps kept in memory when the data file has a step index; zero
+	// means the default of two per thread
 	ObserverHelper(IoInputType& io,
+	               const SerializerIndex& index,
 	               SizeType nf,
 	               SizeType trail,
 	               SizeType numberOfPthreads,
 	               bool hasTimeEvolution,
-	               bool verbose)
+	               bool verbose,
+	               SizeType cacheSize = 0)
 	    :	io_(io),
+	      index_(index),
+	      lazy_(index_.size() > 0),
+	      hasTimeEvolution_(hasTimeEvolution),
+	      cacheSize_((cacheSize > 0) ? cacheSize : 2*numberOfPthreads),
 	      dSerializerV_(),//(1,DmrgSerializerType(io_,true)),
 	      timeSerializerV_(),//(nf),
 	      currentPos_(numberOfPthreads),
+	      pinned_(numberOfPthreads,0),
+	      ioPerThread_(numberOfPthreads,0),
+	      resident_(0),
+	      useCounter_(0),
 	      verbose_(verbose),
 	      bracket_(2,0),
 	      noMoreData_(false)
 	{
+		ConcurrencyType::mutexInit(&mutex_);
+
+		// looked up here, so that threads later find it already open
+		BinaryStore::reader(io.filename());
+
 		PsimagLite::String msg = "No more data to construct this object\n";
 
+		if (lazy_) {
+			if (!initIndexed(nf,trail))
+				throw PsimagLite::RuntimeError(msg);
+			return;
+		}
+
 		if (nf > 0)
 			if (!init(hasTimeEvolution,nf,SAVE_YES))
 				throw PsimagLite::RuntimeError(msg);
@@ -141,9 +171,18 @@ public:
 	~ObserverHelper()
 	{
 		for (SizeType i=0;i<dSerializerV_.size();i++) {
-			DmrgSerializerType* p = dSerializerV_[i];
-			delete p;
+			delete dSerializerV_[i];
+			dSerializerV_[i] = 0;
+			delete timeSerializerV_[i];
+			timeSerializerV_[i] = 0;
 		}
+
+		for (SizeType i=0;i<ioPerThread_.size();i++) {
+			delete ioPerThread_[i];
+			ioPerThread_[i] = 0;
+		}
+
+		ConcurrencyType::mutexDestroy(&mutex_);
 	}
 
 	bool endOfData() const { return noMoreData_; }
@@ -151,7 +190,12 @@ public:
 	void setPointer(SizeType threadId,SizeType pos)
 	{
 		assert(threadId<currentPos_.size());
-		currentPos_[threadId]=pos;
+		if (!lazy_ || (pinned_[threadId] && currentPos_[threadId] == pos)) {
+			currentPos_[threadId]=pos;
+			return;
+		}
+
+		pin(threadId,pos);
 	}
 
 	SizeType getPointer(SizeType threadId) const
@@ -168,76 +212,64 @@ public:
 
 	void transform(SparseMatrixType& ret,const SparseMatrixType& O2,size_t threadId) const
 	{
-		assert(checkPos(threadId));
-		return dSerializerV_[currentPos_[threadId]]->transform(ret,O2);
+		return serializer(threadId).transform(ret,O2);
 	}
 
 	SizeType columns(SizeType threadId) const
 	{
-		assert(checkPos(threadId));
-		return dSerializerV_[currentPos_[threadId]]->columns();
+		return serializer(threadId).columns();
 	}
 
 	SizeType rows(SizeType threadId) const
 	{
-		assert(checkPos(threadId));
-		return dSerializerV_[currentPos_[threadId]]->rows();
+		return serializer(threadId).rows();
 	}
 
 	const FermionSignType& fermionicSignLeft(SizeType threadId) const
 	{
-		assert(checkPos(threadId));
-		return dSerializerV_[currentPos_[threadId]]->fermionicSignLeft();
+		return serializer(threadId).fermionicSignLeft();
 	}
 
 	const FermionSignType& fermionicSignRight(SizeType threadId) const
 	{
-		assert(checkPos(threadId));
-		return dSerializerV_[currentPos_[threadId]]->fermionicSignRight();
+		return serializer(threadId).fermionicSignRight();
 	}
 
 	const LeftRightSuperType& leftRightSuper(SizeType threadId) const
 	{
-		assert(checkPos(threadId));
-		return dSerializerV_[currentPos_[threadId]]->leftRightSuper();
+		return serializer(threadId).leftRightSuper();
 	}
 
 	ProgramGlobals::DirectionEnum direction(SizeType threadId) const
 	{
-		assert(checkPos(threadId));
-		return dSerializerV_[currentPos_[threadId]]->direction();
+		return serializer(threadId).direction();
 	}
 
 	const VectorWithOffsetType& wavefunction(SizeType threadId) const
 	{
-		assert(checkPos(threadId));
-		return dSerializerV_[currentPos_[threadId]]->wavefunction();
+		return serializer(threadId).wavefunction();
 	}
 
 	RealType time(SizeType threadId) const
 	{
-		if (timeSerializerV_.size() == 0) return 0.0;
-		assert(checkPos(threadId));
-		return timeSerializerV_[currentPos_[threadId]].time();
+		if (!hasTimeEvolution_) return 0.0;
+		return timeSerializer(threadId).time();
 	}
 
 	SizeType site(SizeType threadId) const
 	{
-		assert(checkPos(threadId));
-		return  (timeSerializerV_.size()==0) ?
-		            dSerializerV_[currentPos_[threadId]]->site()
-		        : timeSerializerV_[currentPos_[threadId]].site();
-		}
+		return  (!hasTimeEvolution_) ? serializer(threadId).site()
+		                             : timeSerializer(threadId).site();
+	}
 
-		SizeType size() const
-		{
+	SizeType size() const
+	{
 		return dSerializerV_.size(); //-1;
 	}
 
 	SizeType marker(SizeType threadId) const
 	{
-		assert(checkPos(threadId));
-		return timeSerializerV_[currentPos_[threadId]].marker();
+		return timeSerializer(threadId).marker();
 	}
 
 	const VectorWithOffsetType& getVectorFromBracketId(SizeType leftOrRight,
@@ -257,8 +289,7 @@ public:
 	const VectorWithOffsetType& timeVector(SizeType braketId,
 	                                       SizeType threadId) const
 	{
-		assert(checkPos(threadId));
-		return timeSerializerV_[currentPos_[threadId]].vector(braketId);
+		return timeSerializer(threadId).vector(braketId);
 	}
 
 
@@ -281,6 +312,11 @@ public:
 
 private:
 
+	// Not allowed, because of the mutex
+	ObserverHelper(const ObserverHelper&);
+
+	ObserverHelper& operator=(const ObserverHelper&);
+
 	bool init(bool hasTimeEvolution,SizeType nf, SaveEnum saveOrNot)
 	{
 		// Not rewinding is done here
@@ -293,14 +329,16 @@ private:
 			try {
 				DmrgSerializerType* dSerializer = new
 				        DmrgSerializerType(io_,false,true);
-				if (saveOrNot == SAVE_YES)
+				TimeSerializerType* ts = 0;
+				if (hasTimeEvolution)
+					ts = new TimeSerializerType(io_);
+
+				if (saveOrNot == SAVE_YES) {
 					dSerializerV_.push_back(dSerializer);
-				else
+					timeSerializerV_.push_back(ts);
+				} else {
 					delete dSerializer;
-				if (hasTimeEvolution) {
-					TimeSerializerType ts(io_);
-					if (saveOrNot == SAVE_YES)
-						timeSerializerV_.push_back(ts);
+					delete ts;
 				}
 
 				counter++;
@@ -318,14 +356,152 @@ private:
 		return true;
 	}
 
+	// Only the step numbers are read here; steps are loaded on demand,
+	// and io_ is left at the start of the step after the trail
+	bool initIndexed(SizeType nf, SizeType trail)
+	{
+		int first = 0;
+		try {
+			io_.readline(first,SerializerIndex::label());
+		} catch (std::exception& e) {
+			std::cerr<<"CAUGHT: "<<e.what();
+			std::cerr<<"Ignore prev. error, if any. It simply means there's ";
+			std::cerr<<"no more data\n";
+			noMoreData_ = true;
+			return false;
+		}
+
+		SizeType total = index_.size();
+		if (first < 0 || static_cast<SizeType>(first) >= total)
+			throw PsimagLite::RuntimeError("ObserverHelper: step not in index\n");
+
+		SizeType end = first + nf;
+		if (end > total) {
+			end = total;
+			noMoreData_ = true;
+		}
+
+		for (SizeType i = first; i < end; ++i)
+			steps_.push_back(i);
+
+		dSerializerV_.resize(steps_.size(),0);
+		timeSerializerV_.resize(steps_.size(),0);
+		pins_.resize(steps_.size(),0);
+		lastUse_.resize(steps_.size(),0);
+
+		SizeType next = end + trail;
+		if (next >= total) {
+			if (next > total) noMoreData_ = true;
+			SerializerIndex::seek(io_,index_.end());
+		} else {
+			SerializerIndex::seek(io_,index_.offset(next));
+		}
+
+		if (verbose_)
+			std::cerr<<"ObserverHelper: steps "<<first<<" to "<<end<<" of "<<total<<"\n";
+
+		return (steps_.size() > 0);
+	}
+
+	const DmrgSerializerType& serializer(SizeType threadId) const
+	{
+		assert(checkPos(threadId));
+		if (lazy_ && !pinned_[threadId]) pin(threadId,currentPos_[threadId]);
+		assert(dSerializerV_[currentPos_[threadId]]);
+		return *dSerializerV_[currentPos_[threadId]];
+	}
+
+	const TimeSerializerType& timeSerializer(SizeType threadId) const
+	{
+		assert(checkPos(threadId));
+		if (lazy_ && !pinned_[threadId]) pin(threadId,currentPos_[threadId]);
+		if (!timeSerializerV_[currentPos_[threadId]])
+			throw PsimagLite::RuntimeError("ObserverHelper: no time data\n");
+		return *timeSerializerV_[currentPos_[threadId]];
+	}
+
+	// Loads step pos if needed, and keeps it in memory for as long
+	// as it is the current step of threadId
+	void pin(SizeType threadId, SizeType pos) const
+	{
+		if (pos >= dSerializerV_.size())
+			throw PsimagLite::RuntimeError("ObserverHelper: no such step\n");
+
+		ConcurrencyType::mutexLock(&mutex_);
+		if (dSerializerV_[pos] == 0) {
+			ConcurrencyType::mutexUnlock(&mutex_);
+
+			// different threads read different steps at the same time
+			IoInputType& io = ioForThread(threadId);
+			SerializerIndex::seek(io,index_.offset(steps_[pos]));
+			DmrgSerializerType* ds = new DmrgSerializerType(io,false,true);
+			TimeSerializerType* ts = (hasTimeEvolution_) ? new TimeSerializerType(io) : 0;
+
+			ConcurrencyType::mutexLock(&mutex_);
+			if (dSerializerV_[pos] == 0) {
+				dSerializerV_[pos] = ds;
+				timeSerializerV_[pos] = ts;
+				++resident_;
+			} else { // another thread loaded it meanwhile
+				delete ds;
+				delete ts;
+			}
+		}
+
+		if (pinned_[threadId]) {
+			assert(pins_[currentPos_[threadId]] > 0);
+			pins_[currentPos_[threadId]]--;
+		}
+
+		pins_[pos]++;
+		pinned_[threadId] = 1;
+		currentPos_[threadId] = pos;
+		lastUse_[pos] = ++useCounter_;
+
+		evictIfNeeded();
+		ConcurrencyType::mutexUnlock(&mutex_);
+	}
+
+	// Call with mutex_ locked
+	// Evicts the least recently used steps that no thread is on
+	void evictIfNeeded() const
+	{
+		while (cacheSize_ > 0 && resident_ > cacheSize_) {
+			SizeType victim = dSerializerV_.size();
+			for (SizeType i = 0; i < dSerializerV_.size(); ++i) {
+				if (dSerializerV_[i] == 0 || pins_[i] > 0) continue;
+				if (victim < dSerializerV_.size() && lastUse_[i] >= lastUse_[victim])
+					continue;
+				victim = i;
+			}
+
+			if (victim == dSerializerV_.size()) return;
+
+			delete dSerializerV_[victim];
+			dSerializerV_[victim] = 0;
+			delete timeSerializerV_[victim];
+			timeSerializerV_[victim] = 0;
+			--resident_;
+		}
+	}
+
+	IoInputType& ioForThread(SizeType threadId) const
+	{
+		assert(threadId < ioPerThread_.size());
+		if (!ioPerThread_[threadId])
+			ioPerThread_[threadId] = new IoInputType(index_.filename());
+		return *ioPerThread_[threadId];
+	}
+
 	void integrityChecks()
 	{
 		if (dSerializerV_.size()!=timeSerializerV_.size()) throw PsimagLite::RuntimeError("Error 1\n");
 		if (dSerializerV_.size()==0) return;
 		for (SizeType x=0;x<dSerializerV_.size()-1;x++) {
+			if (!dSerializerV_[x] || !timeSerializerV_[x]) continue;
 			SizeType n = dSerializerV_[x]->leftRightSuper().super().size();
 			if (n==0) continue;
-			if (n!=timeSerializerV_[x].size())
+			if (n!=timeSerializerV_[x]->size())
 				throw PsimagLite::RuntimeError("Error 2\n");
 		}
 
@@ -361,9 +537,7 @@ private:
 		if (pos>=dSerializerV_.size())
 			return checkFailed1(threadId,pos);
 
-		bool hasTimeE = (timeSerializerV_.size()>0);
-
-		if (!hasTimeE) return true;
+		if (!hasTimeEvolution_) return true;
 		if (pos>=timeSerializerV_.size())
 			return checkFailed2(threadId,pos);
 		return true;
@@ -403,11 +577,23 @@ private:
 	}
 
 	IoInputType& io_;
-	typename PsimagLite::Vector<DmrgSerializerType*>::Type dSerializerV_;
-	typename PsimagLite::Vector<TimeSerializerType>::Type timeSerializerV_;
-	typename PsimagLite::Vector<SizeType>::Type currentPos_; // it's a vector: one per pthread
+	const SerializerIndex& index_;
+	bool lazy_;
+	bool hasTimeEvolution_;
+	SizeType cacheSize_;
+	VectorSizeType steps_; // step in the data file, one per position
+	mutable typename PsimagLite::Vector<DmrgSerializerType*>::Type dSerializerV_;
+	mutable typename PsimagLite::Vector<TimeSerializerType*>::Type timeSerializerV_;
+	mutable VectorSizeType currentPos_; // it's a vector: one per pthread
+	mutable VectorSizeType pinned_; // one per pthread
+	mutable VectorSizeType pins_; // one per position
+	mutable VectorSizeType lastUse_; // one per position
+	mutable typename PsimagLite::Vector<IoInputType*>::Type ioPerThread_;
+	mutable SizeType resident_;
+	mutable SizeType useCounter_;
+	mutable ConcurrencyType::MutexType mutex_;
 	bool verbose_;
-	typename PsimagLite::Vector<SizeType>::Type bracket_;
+	VectorSizeType bracket_;
 	bool noMoreData_;
 };  //ObserverHelper
 } // namespace Dmrg
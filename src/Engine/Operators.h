@@ -85,6 +85,10 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "Complex.h"
 #include "Concurrency.h"
 #include "Parallelizer.h"
+#include "ThreadPool.h"
+#include "Utils.h"
+#include "CrsCodec.h"
+#include <algorithm>
 
 namespace Dmrg {
 /* PSIDOC Operators
@@ -125,6 +129,7 @@ public:
 	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
 	typedef typename PsimagLite::Vector<SizeType>::Type VectorSizeType;
 	typedef std::pair<SizeType,SizeType> PairSizeSizeType;
+	typedef CrsCodec::VectorByteType VectorByteType;
 
 	class MyLoop {
 
@@ -167,6 +172,16 @@ public:
 			return operators_.size();
 		}
 
+		// cost of each task: the non-zeros of the operator to transform
+		VectorSizeType weights() const
+		{
+			VectorSizeType w(tasks(),1);
+			if (useSu2Symmetry_) return w;
+			for (SizeType k = 0; k < w.size(); ++k)
+				if (!isExcluded(k)) w[k] += operators_[k].data.nonZero();
+			return w;
+		}
+
 		void gather()
 		{
 			if (ConcurrencyType::isMpiDisabled("Operators")) return;
@@ -213,6 +228,109 @@ public:
 		const PairSizeSizeType& startEnd_;
 	};
 
+	// One task per operator of the product, heaviest first
+	template<typename BasisWithOperatorsType,typename ApplyFactorsType>
+	class MyLoopExternalProduct {
+
+		typedef typename PsimagLite::Vector<VectorRealType>::Type VectorVectorRealType;
+		typedef std::pair<SizeType,SizeType> PairCostIndexType;
+
+	public:
+
+		MyLoopExternalProduct(typename PsimagLite::Vector<OperatorType>::Type& operators,
+		                      const BasisWithOperatorsType& basis2,
+		                      const BasisWithOperatorsType& basis3,
+		                      const VectorSizeType& electrons,
+		                      const ApplyFactorsType& apply)
+		    : operators_(operators),
+		      basis2_(basis2),
+		      basis3_(basis3),
+		      apply_(apply),
+		      n2_(basis2.numberOfOperators()),
+		      order_(operators.size()),
+		      weights_(operators.size())
+		{
+			typename PsimagLite::Vector<PairCostIndexType>::Type costs(operators_.size());
+			for (SizeType i = 0; i < operators_.size(); ++i) {
+				const OperatorType& op = source(i);
+				SizeType other = (i < n2_) ? basis3_.size() : basis2_.size();
+				costs[i] = PairCostIndexType(op.data.nonZero()*other,i);
+
+				// one vector of signs per distinct fermion sign
+				if (signIndex(op.fermionSign) < signValues_.size()) continue;
+				signValues_.push_back(op.fermionSign);
+				signs_.resize(signValues_.size());
+				utils::fillFermionicSigns(signs_.back(),electrons,op.fermionSign);
+			}
+
+			// with MPI, gather() needs each rank to own a range of operators
+			if (!ConcurrencyType::hasMpi())
+				std::sort(costs.begin(),costs.end());
+			else
+				std::reverse(costs.begin(),costs.end());
+
+			for (SizeType i = 0; i < costs.size(); ++i) {
+				const PairCostIndexType& cost = costs[costs.size() - 1 - i];
+				order_[i] = cost.second;
+				weights_[i] = cost.first + 1;
+			}
+		}
+
+		void doTask(SizeType taskNumber, SizeType)
+		{
+			SizeType i = order_[taskNumber];
+			const OperatorType& m = source(i);
+			bool option = (i < n2_);
+			int x = (option) ? basis3_.size() : basis2_.size();
+			const VectorRealType& fermionicSigns = signs_[signIndex(m.fermionSign)];
+			PsimagLite::externalProduct(operators_[i].data,m.data,x,fermionicSigns,option);
+			operators_[i].fermionSign=m.fermionSign;
+			operators_[i].jm=m.jm;
+			operators_[i].angularFactor=m.angularFactor;
+			apply_(operators_[i].data);
+		}
+
+		SizeType tasks() const { return operators_.size(); }
+
+		// cost of each task, in task order
+		const VectorSizeType& weights() const { return weights_; }
+
+		void gather()
+		{
+			if (ConcurrencyType::isMpiDisabled("Operators")) return;
+			if (!ConcurrencyType::hasMpi()) return;
+
+			PsimagLite::MPI::pointByPointGather(operators_);
+			for (SizeType i = 0; i < operators_.size(); i++)
+				Dmrg::bcast(operators_[i]);
+		}
+
+	private:
+
+		const OperatorType& source(SizeType i) const
+		{
+			return (i < n2_) ? basis2_.getOperatorByIndex(i)
+			                 : basis3_.getOperatorByIndex(i - n2_);
+		}
+
+		SizeType signIndex(int fermionSign) const
+		{
+			for (SizeType i = 0; i < signValues_.size(); ++i)
+				if (signValues_[i] == fermionSign) return i;
+			return signValues_.size();
+		}
+
+		typename PsimagLite::Vector<OperatorType>::Type& operators_;
+		const BasisWithOperatorsType& basis2_;
+		const BasisWithOperatorsType& basis3_;
+		const ApplyFactorsType& apply_;
+		SizeType n2_;
+		VectorSizeType order_;
+		VectorSizeType weights_;
+		typename PsimagLite::Vector<int>::Type signValues_;
+		VectorVectorRealType signs_;
+	};
+
 	Operators(const BasisType* thisBasis)
 	    : useSu2Symmetry_(BasisType::useSu2Symmetry()),
 	      reducedOpImpl_(thisBasis),
@@ -288,19 +406,93 @@ public:
 	                 const BasisType* thisBasis,
 	                 const PairSizeSizeType& startEnd)
 	{
-		typedef PsimagLite::Parallelizer<MyLoop> ParallelizerType;
+		typedef ParallelizerPool<MyLoop> ParallelizerType;
 		ParallelizerType threadObject(PsimagLite::Concurrency::npthreads,
 		                              PsimagLite::MPI::COMM_WORLD);
 
 		MyLoop helper(useSu2Symmetry_,reducedOpImpl_,operators_,ftransform,thisBasis,startEnd);
 
-		threadObject.loopCreate(helper); // FIXME: needs weights
+		// with MPI, gather() needs the default split of tasks among ranks
+		if (PsimagLite::Concurrency::hasMpi())
+			threadObject.loopCreate(helper);
+		else
+			threadObject.loopCreate(helper,helper.weights());
 
 		helper.gather();
 
 		reducedOpImpl_.changeBasisHamiltonian(hamiltonian_,ftransform);
 	}
 
+	// Clears the operators that this rank does not own;
+	// owner[k] is the rank that owns operator k
+	void keepOwned(const VectorSizeType& owner, SizeType rank)
+	{
+		assert(!useSu2Symmetry_);
+		assert(owner.size() == operators_.size());
+		for (SizeType k = 0; k < operators_.size(); ++k)
+			if (owner[k] != rank) operators_[k].data.clear();
+	}
+
+	// Collective: rank 0 receives the operators owned by the other
+	// ranks, and then broadcasts all of them
+	void fetchOwned(const VectorSizeType& owner)
+	{
+		assert(!useSu2Symmetry_);
+		assert(owner.size() == operators_.size());
+		if (!ConcurrencyType::hasMpi()) return;
+
+		const int tag = 0;
+		SizeType rank = PsimagLite::MPI::commRank(PsimagLite::MPI::COMM_WORLD);
+		for (SizeType k = 0; k < operators_.size(); ++k) {
+			if (owner[k] == 0) continue;
+			if (rank == owner[k])
+				operators_[k].send(0,tag,PsimagLite::MPI::COMM_WORLD);
+			else if (rank == 0)
+				operators_[k].recv(owner[k],tag,PsimagLite::MPI::COMM_WORLD);
+		}
+
+		for (SizeType k = 0; k < operators_.size(); ++k)
+			Dmrg::bcast(operators_[k]);
+	}
+
+	// Keeps the data of all operators encoded in one byte buffer,
+	// see CrsCodec; nothing else may use the operators until decompress()
+	void compress(bool valuesAsFloat)
+	{
+		assert(!useSu2Symmetry_);
+		if (isCompressed()) return;
+
+		VectorByteType buffer;
+		typename PsimagLite::Vector<OperatorType>::Type empty;
+		empty.reserve(operators_.size());
+		for (SizeType k = 0; k < operators_.size(); ++k) {
+			const OperatorType& op = operators_[k];
+			CrsCodec::encode(buffer, op.data, valuesAsFloat);
+			empty.push_back(OperatorType(SparseMatrixType(),
+			                             op.fermionSign,
+			                             op.jm,
+			                             op.angularFactor,
+			                             op.su2Related));
+		}
+
+		// swap so that the memory of the matrices is really released
+		operators_.swap(empty);
+		VectorByteType(buffer).swap(compressed_);
+	}
+
+	void decompress()
+	{
+		if (!isCompressed()) return;
+
+		SizeType pos = 0;
+		for (SizeType k = 0; k < operators_.size(); ++k)
+			CrsCodec::decode(operators_[k].data, compressed_, pos);
+
+		VectorByteType().swap(compressed_);
+	}
+
+	bool isCompressed() const { return compressed_.size() > 0; }
+
 	void reorder(const   VectorSizeType& permutation)
 	{
 		for (SizeType k=0;k<numberOfOperators();k++) {
@@ -366,6 +558,32 @@ public:
 		apply(operators_[i].data);
 	}
 
+	// All operators of basis2 and basis3, with their outer products,
+	// in parallel; electrons are those of basis2, which give the signs
+	template<typename BasisWithOperatorsType,typename ApplyFactorsType>
+	void externalProduct(const BasisWithOperatorsType& basis2,
+	                     const BasisWithOperatorsType& basis3,
+	                     const VectorSizeType& electrons,
+	                     const ApplyFactorsType& apply)
+	{
+		assert(!useSu2Symmetry_);
+		assert(operators_.size() == basis2.numberOfOperators() + basis3.numberOfOperators());
+		typedef MyLoopExternalProduct<BasisWithOperatorsType,ApplyFactorsType> MyLoopExternalProductType;
+		typedef ParallelizerPool<MyLoopExternalProductType> ParallelizerType;
+		ParallelizerType threadObject(PsimagLite::Concurrency::npthreads,
+		                              PsimagLite::MPI::COMM_WORLD);
+
+		MyLoopExternalProductType helper(operators_,basis2,basis3,electrons,apply);
+
+		// with MPI, gather() needs the default split of tasks among ranks
+		if (PsimagLite::Concurrency::hasMpi())
+			threadObject.loopCreate(helper);
+		else
+			threadObject.loopCreate(helper,helper.weights());
+
+		helper.gather();
+	}
+
 	void externalProductReduced(SizeType i,
 	                            const BasisType& basis2,
 	                            const BasisType& basis3,
@@ -432,8 +650,20 @@ public:
 	          typename PsimagLite::EnableIf<
 	          PsimagLite::IsOutputLike<IoOutputter>::True, int>::Type = 0) const
 	{
-		if (!useSu2Symmetry_) io.printVector(operators_,"#OPERATORS");
-		else reducedOpImpl_.save(io,s);
+		if (isCompressed()) {
+			// decoded for the save only, these operators stay compressed
+			assert(!useSu2Symmetry_);
+			typename PsimagLite::Vector<OperatorType>::Type ops(operators_);
+			SizeType pos = 0;
+			for (SizeType k = 0; k < ops.size(); ++k)
+				CrsCodec::decode(ops[k].data, compressed_, pos);
+			io.printVector(ops,"#OPERATORS");
+		} else if (!useSu2Symmetry_) {
+			io.printVector(operators_,"#OPERATORS");
+		} else {
+			reducedOpImpl_.save(io,s);
+		}
+
 		io.printMatrix(hamiltonian_,"#HAMILTONIAN");
 	}
 
@@ -482,6 +712,7 @@ private:
 	typename PsimagLite::Vector<OperatorType>::Type operators_;
 	SparseMatrixType hamiltonian_;
 	PsimagLite::ProgressIndicator progress_;
+	VectorByteType compressed_;
 }; //class Operators
 } // namespace Dmrg
 
@@ -93,18 +93,19 @@ class Parallel2PointCorrelations {
 
 public:
 
-	typedef std::pair<SizeType,SizeType> PairType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
 	typedef typename PsimagLite::Real<FieldType>::Type RealType;
 
+	// One task per row i; each task sweeps j=i,i+1,... reusing the grown O1
 	Parallel2PointCorrelations(MatrixType& w,
 	                           TwoPointCorrelationsType& twopoint,
-	                           const typename PsimagLite::Vector<PairType>::Type& pairs,
+	                           const VectorSizeType& rows,
 	                           const SparseMatrixType& O1,
 	                           const SparseMatrixType& O2,
 	                           int fermionicSign)
 	    : w_(w),
 	      twopoint_(twopoint),
-	      pairs_(pairs),
+	      rows_(rows),
 	      O1_(O1),
 	      O2_(O2),
 	      fermionicSign_(fermionicSign)
@@ -112,18 +113,21 @@ public:
 
 	void doTask(SizeType taskNumber ,SizeType threadNum)
 	{
-		SizeType i = pairs_[taskNumber].first;
-		SizeType j = pairs_[taskNumber].second;
-		w_(i,j) = twopoint_.calcCorrelation(i,j,O1_,O2_,fermionicSign_,threadNum);
+		twopoint_.calcCorrelationRow(w_,
+		                             rows_[taskNumber],
+		                             O1_,
+		                             O2_,
+		                             fermionicSign_,
+		                             threadNum);
 	}
 
-	SizeType tasks() const { return pairs_.size(); }
+	SizeType tasks() const { return rows_.size(); }
 
 private:
 
 	MatrixType& w_;
 	TwoPointCorrelationsType& twopoint_;
-	const typename PsimagLite::Vector<PairType>::Type& pairs_;
+	const VectorSizeType& rows_;
 	const SparseMatrixType& O1_;
 	const SparseMatrixType& O2_;
 	int fermionicSign_;
@@ -0,0 +1,158 @@
+/*
+Copyright (c) 2009-2018, UT-Battelle, LLC
+All rights reserved
+
+[DMRG++, Version 3.0]
+[by G.A., Oak Ridge National Laboratory]
+
+UT Battelle Open Source Software License 11242008
+
+OPEN SOURCE LICENSE
+
+Subject to the conditions of this License, each
+contributor to this software hereby grants, free of
+charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), a
+perpetual, worldwide, non-exclusive, no-charge,
+royalty-free, irrevocable copyright license to use, copy,
+modify, merge, publish, distribute, and/or sublicense
+copies of the Software.
+
+1. Redistributions of Software must retain the above
+copyright and license notices, this list of conditions,
+and the following disclaimer.  Changes or modifications
+to, or derivative works of, the Software should be noted
+with comments and the contributor and organization's
+name.
+
+2. Neither the names of UT-Battelle, LLC or the
+Department of Energy nor the names of the Software
+contributors may be used to endorse or promote products
+derived from this software without specific prior written
+permission of UT-Battelle.
+
+3. The software and the end-user documentation included
+with the redistribution, with or without modification,
+must include the following acknowledgment:
+
+"This product includes software produced by UT-Battelle,
+LLC under Contract No. DE-AC05-00OR22725  with the
+Department of Energy."
+
+*********************************************************
+DISCLAIMER
+
+THE SOFTWARE IS SUPPLIED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER, CONTRIBUTORS, UNITED STATES GOVERNMENT,
+OR THE UNITED STATES DEPARTMENT OF ENERGY BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+NEITHER THE UNITED STATES GOVERNMENT, NOR THE UNITED
+STATES DEPARTMENT OF ENERGY, NOR THE COPYRIGHT OWNER, NOR
+ANY OF THEIR EMPLOYEES, REPRESENTS THAT THE USE OF ANY
+INFORMATION, DATA, APPARATUS, PRODUCT, OR PROCESS
+DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
+
+*********************************************************
+*/
+/** \ingroup DMRG */
+/*@{*/
+/** \file Parallel3PointCorrelations.h
+*/
+
+#ifndef PARALLEL_3POINT_CORRELATIONS_H
+#define PARALLEL_3POINT_CORRELATIONS_H
+
+#include "Vector.h"
+#include "Mpi.h"
+#include "Concurrency.h"
+
+namespace Dmrg {
+
+// One task per first site; each task reuses its grown partial products
+template<typename FourPointCorrelationsType>
+class Parallel3PointCorrelations {
+
+	typedef typename FourPointCorrelationsType::BraketType BraketType;
+	typedef typename FourPointCorrelationsType::VectorFieldType VectorFieldType;
+	typedef typename FourPointCorrelationsType::VectorSizeType VectorSizeType;
+
+public:
+
+	typedef typename PsimagLite::Vector<VectorFieldType>::Type VectorVectorFieldType;
+
+	Parallel3PointCorrelations(VectorVectorFieldType& values,
+	                           const FourPointCorrelationsType& fourpoint,
+	                           const VectorSizeType& sites,
+	                           SizeType rows,
+	                           SizeType cols,
+	                           const BraketType& braket)
+	    : values_(values),
+	      fourpoint_(fourpoint),
+	      sites_(sites),
+	      rows_(rows),
+	      cols_(cols),
+	      braket_(braket)
+	{
+		values_.resize(sites_.size());
+	}
+
+	void doTask(SizeType taskNumber, SizeType threadNum)
+	{
+		values_[taskNumber].clear();
+		fourpoint_.threePoint(values_[taskNumber],
+		                      sites_[taskNumber],
+		                      rows_,
+		                      cols_,
+		                      braket_,
+		                      threadNum);
+	}
+
+	SizeType tasks() const { return sites_.size(); }
+
+	// With MPI each rank computed only its tasks; the others are
+	// zero-filled and summed, so that every rank has all the values
+	void sync()
+	{
+		if (!PsimagLite::Concurrency::hasMpi()) return;
+
+		for (SizeType x = 0; x < values_.size(); ++x) {
+			values_[x].resize(valuesAfter(sites_[x]), 0.0);
+			PsimagLite::MPI::allReduce(values_[x]);
+		}
+	}
+
+private:
+
+	// number of values of a task whose last fixed site is site
+	SizeType valuesAfter(SizeType site) const
+	{
+		SizeType n = 0;
+		for (SizeType s = site + 1; s < rows_; ++s)
+			if (s + 1 < cols_) n += cols_ - s - 1;
+		return n;
+	}
+
+	VectorVectorFieldType& values_;
+	const FourPointCorrelationsType& fourpoint_;
+	const VectorSizeType& sites_;
+	SizeType rows_;
+	SizeType cols_;
+	const BraketType& braket_;
+}; // class Parallel3PointCorrelations
+} // namespace Dmrg
+
+/*@}*/
+#endif // PARALLEL_3POINT_CORRELATIONS_H
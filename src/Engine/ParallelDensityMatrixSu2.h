@@ -0,0 +1,242 @@
+/*
+Copyright (c) 2009-2018, UT-Battelle, LLC
+All rights reserved
+
+[DMRG++, Version 3.0]
+[by G.A., Oak Ridge National Laboratory]
+
+UT Battelle Open Source Software License 11242008
+
+OPEN SOURCE LICENSE
+
+Subject to the conditions of this License, each
+contributor to this software hereby grants, free of
+charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), a
+perpetual, worldwide, non-exclusive, no-charge,
+royalty-free, irrevocable copyright license to use, copy,
+modify, merge, publish, distribute, and/or sublicense
+copies of the Software.
+
+1. Redistributions of Software must retain the above
+copyright and license notices, this list of conditions,
+and the following disclaimer.  Changes or modifications
+to, or derivative works of, the Software should be noted
+with comments and the contributor and organization's
+name.
+
+2. Neither the names of UT-Battelle, LLC or the
+Department of Energy nor the names of the Software
+contributors may be used to endorse or promote products
+derived from this software without specific prior written
+permission of UT-Battelle.
+
+3. The software and the end-user documentation included
+with the redistribution, with or without modification,
+must include the following acknowledgment:
+
+"This product includes software produced by UT-Battelle,
+LLC under Contract No. DE-AC05-00OR22725  with the
+Department of Energy."
+
+*********************************************************
+DISCLAIMER
+
+THE SOFTWARE IS SUPPLIED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER, CONTRIBUTORS, UNITED STATES GOVERNMENT,
+OR THE UNITED STATES DEPARTMENT OF ENERGY BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+NEITHER THE UNITED STATES GOVERNMENT, NOR THE UNITED
+STATES DEPARTMENT OF ENERGY, NOR THE COPYRIGHT OWNER, NOR
+ANY OF THEIR EMPLOYEES, REPRESENTS THAT THE USE OF ANY
+INFORMATION, DATA, APPARATUS, PRODUCT, OR PROCESS
+DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
+
+*********************************************************
+*/
+
+/** \ingroup DMRG */
+/*@{*/
+
+/*! \file ParallelDensityMatrixSu2.h
+ *
+ *  Builds the blocks of the SU(2) density matrix, one task per
+ *  partition. For each target the wavefunction is transformed with
+ *  the factors of the SU(2) basis into a matrix W whose rows are the
+ *  states of the partition and whose columns are the states summed
+ *  over; the block is then sum over targets of weight*W*W^\dagger,
+ *  computed with a single GEMM.
+ */
+
+#ifndef PARALLEL_DENSITY_MATRIX_SU2_H
+#define PARALLEL_DENSITY_MATRIX_SU2_H
+
+#include "ProgramGlobals.h"
+#include "Concurrency.h"
+#include "BLAS.h"
+
+namespace Dmrg {
+
+template<typename BlockMatrixType,
+         typename BasisWithOperatorsType,
+         typename TargettingType>
+class ParallelDensityMatrixSu2 {
+
+	typedef typename BlockMatrixType::BuildingBlockType BuildingBlockType;
+	typedef typename TargettingType::TargetVectorType::value_type DensityMatrixElementType;
+	typedef typename BasisWithOperatorsType::BasisType BasisType;
+	typedef typename BasisType::FactorsType FactorsType;
+	typedef typename PsimagLite::Vector<DensityMatrixElementType>::Type VectorType;
+
+public:
+
+	typedef typename PsimagLite::Real<DensityMatrixElementType>::Type RealType;
+	typedef typename PsimagLite::Vector<BuildingBlockType>::Type VectorBuildingBlockType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+
+	ParallelDensityMatrixSu2(const TargettingType& target,
+	                         const BasisWithOperatorsType& pBasis,
+	                         const BasisWithOperatorsType& pBasisSummed,
+	                         const BasisType& pSE,
+	                         ProgramGlobals::DirectionEnum direction,
+	                         VectorBuildingBlockType& blocks)
+	    : target_(target),
+	      pBasis_(pBasis),
+	      pBasisSummed_(pBasisSummed),
+	      pSE_(pSE),
+	      direction_(direction),
+	      blocks_(blocks)
+	{
+		blocks_.resize(tasks());
+	}
+
+	SizeType tasks() const { return pBasis_.partition() - 1; }
+
+	// the cost of a partition grows with the square of its size
+	VectorSizeType weights() const
+	{
+		VectorSizeType w(tasks());
+		for (SizeType m = 0; m < w.size(); ++m) {
+			SizeType bs = pBasis_.partition(m + 1) - pBasis_.partition(m);
+			w[m] = bs*bs;
+		}
+
+		return w;
+	}
+
+	void doTask(SizeType taskNumber, SizeType)
+	{
+		SizeType start = pBasis_.partition(taskNumber);
+		SizeType bs = pBasis_.partition(taskNumber + 1) - start;
+		BuildingBlockType& matrixBlock = blocks_[taskNumber];
+		matrixBlock.reset(bs, bs);
+		if (bs == 0) return;
+
+		VectorType w;
+		SizeType cols = 0;
+		if (target_.includeGroundStage())
+			addColumns(w, cols, start, bs, target_.gs(), target_.gsWeight());
+
+		for (SizeType i = 0; i < target_.size(); ++i)
+			addColumns(w,
+			           cols,
+			           start,
+			           bs,
+			           target_(i),
+			           target_.weight(i)/target_.normSquared(i));
+
+		if (cols == 0) {
+			for (SizeType i = 0; i < bs; ++i)
+				for (SizeType j = 0; j < bs; ++j)
+					matrixBlock(i, j) = 0.0;
+			return;
+		}
+
+		DensityMatrixElementType alpha = 1.0;
+		DensityMatrixElementType beta = 0.0;
+		psimag::BLAS::GEMM('N',
+		                   'C',
+		                   bs,
+		                   bs,
+		                   cols,
+		                   alpha,
+		                   &(w[0]),
+		                   bs,
+		                   &(w[0]),
+		                   bs,
+		                   beta,
+		                   &(matrixBlock(0,0)),
+		                   bs);
+	}
+
+private:
+
+	// appends to w (column major, bs rows) one column per state summed over,
+	// skipping columns that are zero
+	template<typename TargetVectorType>
+	void addColumns(VectorType& w,
+	                SizeType& cols,
+	                SizeType start,
+	                SizeType bs,
+	                const TargetVectorType& v,
+	                RealType weight) const
+	{
+		if (weight == 0) return;
+		assert(weight > 0);
+		RealType sqrtWeight = sqrt(weight);
+
+		SizeType total = pBasisSummed_.size();
+		SizeType ns = (direction_ == ProgramGlobals::EXPAND_SYSTEM) ?
+		            pSE_.size()/total : total;
+
+		// Make sure we don't copy just get the reference here!!
+		const FactorsType& factors = pSE_.getFactors();
+
+		for (SizeType beta = 0; beta < total; ++beta) {
+			SizeType offset = cols*bs;
+			w.resize(offset + bs);
+			bool nonZero = false;
+			for (SizeType a = 0; a < bs; ++a) {
+				SizeType alpha = a + start;
+				SizeType i = (direction_ == ProgramGlobals::EXPAND_SYSTEM) ?
+				            alpha + beta*ns : beta + alpha*ns;
+				DensityMatrixElementType sum = 0.0;
+				for (int k = factors.getRowPtr(i); k < factors.getRowPtr(i + 1); ++k) {
+					SizeType eta = factors.getCol(k);
+					sum += v.slowAccess(pSE_.permutationInverse(eta))*factors.getValue(k);
+				}
+
+				w[offset + a] = sum*sqrtWeight;
+				if (sum != static_cast<DensityMatrixElementType>(0.0)) nonZero = true;
+			}
+
+			if (nonZero) ++cols;
+		}
+
+		w.resize(cols*bs);
+	}
+
+	const TargettingType& target_;
+	const BasisWithOperatorsType& pBasis_;
+	const BasisWithOperatorsType& pBasisSummed_;
+	const BasisType& pSE_;
+	ProgramGlobals::DirectionEnum direction_;
+	VectorBuildingBlockType& blocks_;
+}; // class ParallelDensityMatrixSu2
+} // namespace Dmrg
+
+/*@}*/
+#endif // PARALLEL_DENSITY_MATRIX_SU2_H
@@ -0,0 +1,334 @@
+/*
+Copyright (c) 2009-2018, UT-Battelle, LLC
+All rights reserved
+
+[DMRG++, Version 3.0]
+[by G.A., Oak Ridge National Laboratory]
+
+UT Battelle Open Source Software License 11242008
+
+OPEN SOURCE LICENSE
+
+Subject to the conditions of this License, each
+contributor to this software hereby grants, free of
+charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), a
+perpetual, worldwide, non-exclusive, no-charge,
+royalty-free, irrevocable copyright license to use, copy,
+modify, merge, publish, distribute, and/or sublicense
+copies of the Software.
+
+1. Redistributions of Software must retain the above
+copyright and license notices, this list of conditions,
+and the following disclaimer.  Changes or modifications
+to, or derivative works of, the Software should be noted
+with comments and the contributor and organization's
+name.
+
+2. Neither the names of UT-Battelle, LLC or the
+Department of Energy nor the names of the Software
+contributors may be used to endorse or promote products
+derived from this software without specific prior written
+permission of UT-Battelle.
+
+3. The software and the end-user documentation included
+with the redistribution, with or without modification,
+must include the following acknowledgment:
+
+"This product includes software produced by UT-Battelle,
+LLC under Contract No. DE-AC05-00OR22725  with the
+Department of Energy."
+
+*********************************************************
+DISCLAIMER
+
+THE SOFTWARE IS SUPPLIED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER, CONTRIBUTORS, UNITED STATES GOVERNMENT,
+OR THE UNITED STATES DEPARTMENT OF ENERGY BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+NEITHER THE UNITED STATES GOVERNMENT, NOR THE UNITED
+STATES DEPARTMENT OF ENERGY, NOR THE COPYRIGHT OWNER, NOR
+ANY OF THEIR EMPLOYEES, REPRESENTS THAT THE USE OF ANY
+INFORMATION, DATA, APPARATUS, PRODUCT, OR PROCESS
+DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
+
+*********************************************************
+*/
+/** \ingroup DMRG */
+/*@{*/
+/** \file ParallelHamiltonianConnection.h
+*/
+
+#ifndef PARALLEL_HAMILTONIAN_CONNECTION_H
+#define PARALLEL_HAMILTONIAN_CONNECTION_H
+
+#include <algorithm>
+#include <cassert>
+#include "Vector.h"
+#include "Mpi.h"
+#include "Concurrency.h"
+
+namespace Dmrg {
+
+// Adds the Hamiltonian connection of lrs to matrix, one task per
+// superblock partition, writing CRS directly. The tasks must be split
+// among threads only, because the rows are not gathered across ranks:
+// the symbolic pass only counts the entries of each row of the result,
+// from the column indices of the connection; then call numericPass(),
+// and loop again to compute the values and fill the rows in place
+template<typename GeometryType,typename ModelHelperType,typename HamiltonianConnectionType>
+class ParallelHamiltonianConnection {
+
+	typedef typename ModelHelperType::SparseMatrixType SparseMatrixType;
+	typedef typename SparseMatrixType::value_type SparseElementType;
+	typedef typename ModelHelperType::LeftRightSuperType LeftRightSuperType;
+	typedef typename ModelHelperType::RealType RealType;
+	typedef typename PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef typename PsimagLite::Vector<SparseElementType>::Type VectorSparseElementType;
+	typedef typename HamiltonianConnectionType::ConnectionType ConnectionType;
+	typedef typename HamiltonianConnectionType::VectorConnectionType VectorConnectionType;
+	typedef PsimagLite::Concurrency ConcurrencyType;
+
+	enum PassEnum {PASS_SYMBOLIC, PASS_NUMERIC};
+
+public:
+
+	ParallelHamiltonianConnection(SparseMatrixType& result,
+	                              const SparseMatrixType& matrix,
+	                              const GeometryType& geometry,
+	                              const LeftRightSuperType& lrs,
+	                              RealType currentTime)
+	    : result_(result),
+	      matrix_(matrix),
+	      geometry_(geometry),
+	      lrs_(lrs),
+	      currentTime_(currentTime),
+	      pass_(PASS_SYMBOLIC),
+	      rowSize_(matrix.rows(),0),
+	      mark_(ConcurrencyType::storageSize(ConcurrencyType::npthreads)),
+	      stamp_(mark_.size(),0),
+	      value_(mark_.size()),
+	      cols_(mark_.size()),
+	      rowCols_(mark_.size()),
+	      rowValues_(mark_.size()),
+	      modelHelpers_(mark_.size(),0),
+	      connections_(mark_.size())
+	{
+		if (matrix.rows() != lrs.super().size() || matrix.cols() != matrix.rows())
+			throw PsimagLite::RuntimeError("ParallelHamiltonianConnection: wrong matrix size\n");
+	}
+
+	~ParallelHamiltonianConnection()
+	{
+		for (SizeType i = 0; i < modelHelpers_.size(); ++i)
+			delete modelHelpers_[i];
+	}
+
+	void doTask(SizeType m, SizeType threadNum)
+	{
+		if (pass_ == PASS_SYMBOLIC)
+			symbolic(m,threadNum);
+		else
+			numeric(m,threadNum);
+	}
+
+	SizeType tasks() const { return lrs_.super().partition() - 1; }
+
+	// Sizes result_ from the row sizes found by the symbolic pass
+	void numericPass()
+	{
+		SizeType rows = rowSize_.size();
+		SizeType nonzeros = 0;
+		for (SizeType i = 0; i < rows; ++i)
+			nonzeros += rowSize_[i];
+
+		result_.resize(rows,rows,nonzeros);
+		SizeType counter = 0;
+		for (SizeType i = 0; i < rows; ++i) {
+			result_.setRow(i,counter);
+			counter += rowSize_[i];
+		}
+
+		result_.setRow(rows,counter);
+		pass_ = PASS_NUMERIC;
+	}
+
+private:
+
+	ParallelHamiltonianConnection(const ParallelHamiltonianConnection&);
+
+	ParallelHamiltonianConnection& operator=(const ParallelHamiltonianConnection&);
+
+	// One helper per thread, moved from partition to partition
+	const ModelHelperType& modelHelper(SizeType m, SizeType threadNum)
+	{
+		assert(threadNum < modelHelpers_.size());
+		ModelHelperType*& helper = modelHelpers_[threadNum];
+		if (helper) {
+			helper->setPartition(m);
+			return *helper;
+		}
+
+		helper = new ModelHelperType(m,lrs_,currentTime_,threadNum);
+		findConnections(threadNum);
+		return *helper;
+	}
+
+	// The terms of the connection, with the operators of the helper of
+	// threadNum, which stay the same when it changes partition
+	void findConnections(SizeType threadNum)
+	{
+		HamiltonianConnectionType hc(geometry_,*modelHelpers_[threadNum]);
+		hc.connections(connections_[threadNum]);
+	}
+
+	// Size of each row of partition m of the result, from column indices only
+	void symbolic(SizeType m, SizeType threadNum)
+	{
+		SizeType offset = lrs_.super().partition(m);
+		SizeType bs = lrs_.super().partition(m+1) - offset;
+		const ModelHelperType& helper = modelHelper(m,threadNum);
+		const VectorConnectionType& connections = connections_[threadNum];
+		prepare(threadNum);
+		VectorSizeType& mark = mark_[threadNum];
+		VectorSizeType& rowCols = rowCols_[threadNum];
+		for (SizeType r = 0; r < bs; ++r) {
+			SizeType row = r + offset;
+			SizeType stamp = ++stamp_[threadNum];
+			SizeType size = 0;
+
+			// the diagonal is always there, as before
+			mark[row] = stamp;
+			++size;
+
+			for (int k = matrix_.getRowPtr(row); k < matrix_.getRowPtr(row+1); ++k) {
+				SizeType c = matrix_.getCol(k);
+				if (mark[c] == stamp) continue;
+				mark[c] = stamp;
+				++size;
+			}
+
+			rowCols.clear();
+			for (SizeType x = 0; x < connections.size(); ++x) {
+				const ConnectionType& connection = connections[x];
+				helper.fastOpProdInterRow(rowCols,0,r,*connection.A,*connection.B,connection.link);
+			}
+
+			for (SizeType k = 0; k < rowCols.size(); ++k) {
+				SizeType c = rowCols[k] + offset;
+				if (mark[c] == stamp) continue;
+				mark[c] = stamp;
+				++size;
+			}
+
+			rowSize_[row] = size;
+		}
+	}
+
+	// Rows of partition m of result_ = matrix_ + connection
+	void numeric(SizeType m, SizeType threadNum)
+	{
+		SizeType offset = lrs_.super().partition(m);
+		SizeType bs = lrs_.super().partition(m+1) - offset;
+		const ModelHelperType& helper = modelHelper(m,threadNum);
+		const VectorConnectionType& connections = connections_[threadNum];
+		prepare(threadNum);
+		VectorSizeType& mark = mark_[threadNum];
+		VectorSparseElementType& value = value_[threadNum];
+		VectorSizeType& cols = cols_[threadNum];
+		VectorSizeType& rowCols = rowCols_[threadNum];
+		VectorSparseElementType& rowValues = rowValues_[threadNum];
+		for (SizeType r = 0; r < bs; ++r) {
+			SizeType row = r + offset;
+			SizeType stamp = ++stamp_[threadNum];
+			cols.clear();
+			accumulate(row,0.0,stamp,mark,value,cols);
+			for (int k = matrix_.getRowPtr(row); k < matrix_.getRowPtr(row+1); ++k)
+				accumulate(matrix_.getCol(k),matrix_.getValue(k),stamp,mark,value,cols);
+
+			rowCols.clear();
+			rowValues.clear();
+			for (SizeType x = 0; x < connections.size(); ++x) {
+				const ConnectionType& connection = connections[x];
+				helper.fastOpProdInterRow(rowCols,
+				                          &rowValues,
+				                          r,
+				                          *connection.A,
+				                          *connection.B,
+				                          connection.link);
+			}
+
+			assert(rowCols.size() == rowValues.size());
+			for (SizeType k = 0; k < rowCols.size(); ++k)
+				accumulate(rowCols[k] + offset,rowValues[k],stamp,mark,value,cols);
+
+			assert(cols.size() == rowSize_[row]);
+			std::sort(cols.begin(),cols.end());
+			SizeType start = result_.getRowPtr(row);
+			for (SizeType k = 0; k < cols.size(); ++k) {
+				result_.setCol(start + k,cols[k]);
+				result_.setValues(start + k,value[cols[k]]);
+			}
+		}
+	}
+
+	static void accumulate(SizeType c,
+	                       const SparseElementType& v,
+	                       SizeType stamp,
+	                       VectorSizeType& mark,
+	                       VectorSparseElementType& value,
+	                       VectorSizeType& cols)
+	{
+		if (mark[c] != stamp) {
+			mark[c] = stamp;
+			value[c] = 0.0;
+			cols.push_back(c);
+		}
+
+		value[c] += v;
+	}
+
+	// scratch of one thread, indexed by column of matrix_
+	void prepare(SizeType threadNum)
+	{
+		assert(threadNum < mark_.size());
+		SizeType n = matrix_.cols();
+		if (mark_[threadNum].size() == n) return;
+		mark_[threadNum].resize(n,0);
+		value_[threadNum].resize(n,0.0);
+		stamp_[threadNum] = 0;
+	}
+
+	SparseMatrixType& result_;
+	const SparseMatrixType& matrix_;
+	const GeometryType& geometry_;
+	const LeftRightSuperType& lrs_;
+	RealType currentTime_;
+	PassEnum pass_;
+	VectorSizeType rowSize_;
+	typename PsimagLite::Vector<VectorSizeType>::Type mark_;
+	VectorSizeType stamp_;
+	typename PsimagLite::Vector<VectorSparseElementType>::Type value_;
+	typename PsimagLite::Vector<VectorSizeType>::Type cols_;
+	typename PsimagLite::Vector<VectorSizeType>::Type rowCols_;
+	typename PsimagLite::Vector<VectorSparseElementType>::Type rowValues_;
+	typename PsimagLite::Vector<ModelHelperType*>::Type modelHelpers_;
+	typename PsimagLite::Vector<VectorConnectionType>::Type connections_;
+}; // class ParallelHamiltonianConnection
+} // namespace Dmrg
+
+/*@}*/
+#endif // PARALLEL_HAMILTONIAN_CONNECTION_H
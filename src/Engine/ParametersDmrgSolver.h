@@ -110,6 +110,10 @@ exits it will be truncated.
 
 \item[InfiniteLoopKeptStates=integer]  \emph{m} value for the infinite algorithm.
 
+\item[CompressedStacksDistance=integer] Optional, only used with compressedStacks
+in SolverOptions. Blocks that are this many entries or more below the top of
+the sys. and env. stacks are kept compressed; it defaults to 2, and must be positive.
+
 \item[FiniteLoops=vector]
 A series of space-separated numbers. More than one space is allowed.
 The first number is the number of finite algorithm movements, followed by series
@@ -143,6 +147,7 @@ struct ParametersDmrgSolver {
 	SizeType dumperBegin;
 	SizeType dumperEnd;
 	SizeType precision;
+	SizeType compressedStacksDistance;
 	int useReflectionSymmetry;
 	PairRealSizeType truncationControl;
 	PsimagLite::String filename;
@@ -188,6 +193,7 @@ struct ParametersDmrgSolver {
 	      dumperBegin(0),
 	      dumperEnd(0),
 	      precision(6),
+	      compressedStacksDistance(2),
 	      recoverySave("0"),
 	      degeneracyMax(1e-12),
 	      denseSparseThreshold(0.1)
@@ -280,6 +286,13 @@ struct ParametersDmrgSolver {
 			io.readline(recoverySave,"RecoverySave=");
 		} catch (std::exception&) {}
 
+		try {
+			io.readline(compressedStacksDistance,"CompressedStacksDistance=");
+		} catch (std::exception&) {}
+
+		if (compressedStacksDistance == 0)
+			throw PsimagLite::RuntimeError("FATAL: CompressedStacksDistance must be positive\n");
+
 		try {
 			io.readline(dumperBegin,"KroneckerDumperBegin=");
 		} catch (std::exception&) {}
@@ -518,6 +531,9 @@ std::ostream &operator<<(std::ostream &os,
 	}
 
 	os<<"parameters.precision="<<p.precision<<"\n";
+	if (p.options.find("compressedStacks") != PsimagLite::String::npos)
+		os<<"parameters.compressedStacksDistance="<<p.compressedStacksDistance<<"\n";
+
 	os<<"parameters.keptStatesInfinite="<<p.keptStatesInfinite<<"\n";
 	os<<"FiniteLoops ";
 	os<<p.finiteLoop;
@@ -73,6 +73,21 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 
 /*! \file Recovery.h
  *
+ *  Recovery snapshots, written after each finite loop
+ *
+ *  Snapshots alternate between Recovery0 and Recovery1 so that one is
+ *  always complete. The parameters, bases, targets and WFT are written
+ *  by the caller; the sys. and env. stacks, by far the largest part, are
+ *  written by a background thread while the next loop runs. Only the
+ *  stack entries pushed since the previous snapshot into the same file
+ *  are written. The thread is handed views of them that share the
+ *  entries with the stacks, which copy an entry only if they change it
+ *  before it is written, and it writes them one at a time. The main
+ *  file is written under a temporary name and renamed when the stacks
+ *  are done, and that commits the snapshot.
+ *
+ *  With operatorsDistributed the blocks get their operators back with
+ *  collective calls, so the stacks are written by the caller instead.
  *
  */
 
@@ -80,9 +95,14 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #define DMRG_RECOVER_H
 
 #include "Checkpoint.h"
+#include "IncrementalDiskStack.h"
 #include "Vector.h"
 #include "ProgramGlobals.h"
 #include "ProgressIndicator.h"
+#include <cstdio>
+#ifdef USE_PTHREADS
+#include <pthread.h>
+#endif
 
 namespace Dmrg {
 
@@ -101,6 +121,40 @@ public:
 	typedef typename PsimagLite::Vector<SizeType>::Type VectorSizeType;
 	typedef typename CheckpointType::MemoryStackType MemoryStackType;
 	typedef typename CheckpointType::DiskStackType DiskStackType;
+	typedef IncrementalDiskStack<BasisWithOperatorsType> IncrementalDiskStackType;
+	typedef typename CheckpointType::MemoryStackViewType MemoryStackViewType;
+
+private:
+
+	// The stacks of one snapshot, as the background thread writes them
+	struct Snapshot {
+
+		Snapshot() : stacks(2, 0), keep(2, 0) {}
+
+		void write()
+		{
+			try {
+				for (SizeType i = 0; i < 2; ++i) {
+					stacks[i]->write(keep[i], entries[i]);
+					entries[i].clear();
+				}
+
+				if (rename(tmpName.c_str(), rootName.c_str()) != 0)
+					error = "cannot rename " + tmpName + " to " + rootName + "\n";
+			} catch (std::exception& e) {
+				error = e.what();
+			}
+		}
+
+		typename PsimagLite::Vector<IncrementalDiskStackType*>::Type stacks;
+		VectorSizeType keep;
+		MemoryStackViewType entries[2];
+		PsimagLite::String tmpName;
+		PsimagLite::String rootName;
+		PsimagLite::String error;
+	};
+
+public:
 
 	Recovery(const CheckpointType& checkpoint,
 	         const WaveFunctionTransfType& wft,
@@ -111,11 +165,29 @@ public:
 	      wft_(wft),
 	      pS_(pS),
 	      pE_(pE),
-	      flag_m_(false)
-	{}
+	      flag_m_(false),
+	      unchanged_(4, 0),
+	      running_(false)
+	{
+		for (SizeType slot = 0; slot < 2; ++slot) {
+			PsimagLite::String rootName = rootNameOf(slot);
+			stacks_.push_back(IncrementalDiskStackType(
+			                      utils::pathPrepend(checkpoint_.SYSTEM_STACK_STRING,
+			                                         rootName)));
+			stacks_.push_back(IncrementalDiskStackType(
+			                      utils::pathPrepend(checkpoint_.ENVIRON_STACK_STRING,
+			                                         rootName)));
+		}
+	}
 
 	~Recovery()
 	{
+		try {
+			wait();
+		} catch (std::exception& e) {
+			std::cerr<<e.what();
+		}
+
 		if (checkpoint_.parameters().options.find("recoveryNoDelete") !=
 		        PsimagLite::String::npos) return;
 
@@ -131,27 +203,118 @@ public:
 		if (checkpoint_.parameters().recoverySave == "0")
 			return;
 
-		PsimagLite::String prefix("Recovery");
-		prefix += (flag_m_) ? "1" : "0";
-		PsimagLite::String rootName(prefix + checkpoint_.parameters().filename);
-		typename IoType::Out ioOut(rootName);
-		ioOut<<checkpoint_.parameters();
-		checkpoint_.save(pS_,pE_,ioOut);
-		psi.save(vsites,ioOut);
-		PsimagLite::OstringStream msg;
-		msg<<"#LastLoopSign="<<lastSign<<"\n";
-		ioOut<<msg.str();
-		files_.push_back(rootName);
+		wait();
 
-		saveStacksForRecovery(rootName,isObserveCode);
+		SizeType slot = (flag_m_) ? 1 : 0;
+		PsimagLite::String rootName = rootNameOf(slot);
+		bool inBackground = (!checkpoint_.memoryStack(SYSTEM).inDisk() &&
+		                     !checkpoint_.operatorsDistributed());
 
+		// this slot is not a snapshot until it is complete
+		unlink(rootName.c_str());
+		PsimagLite::String mainName = (inBackground) ? rootName + ".tmp" : rootName;
+
+		{
+			typename IoType::Out ioOut(mainName);
+			ioOut<<checkpoint_.parameters();
+			checkpoint_.save(pS_,pE_,ioOut);
+			psi.save(vsites,ioOut);
+			PsimagLite::OstringStream msg;
+			msg<<"#LastLoopSign="<<lastSign<<"\n";
+			ioOut<<msg.str();
+		}
+
+		files_.push_back(rootName);
+
+		// before the stacks, since in the background the rename
+		// that commits the snapshot may happen at any time after
 		wft_.save(rootName);
 		wft_.appendFileList(files_,rootName);
+
+		if (inBackground)
+			saveStacksInBackground(slot, mainName, rootName);
+		else
+			saveStacksForRecovery(rootName,isObserveCode);
+
 		flag_m_ = !flag_m_;
 	}
 
 private:
 
+	PsimagLite::String rootNameOf(SizeType slot) const
+	{
+		PsimagLite::String prefix("Recovery");
+		prefix += (slot == 1) ? "1" : "0";
+		return prefix + checkpoint_.parameters().filename;
+	}
+
+	// Takes views of the entries that changed since this slot was last
+	// written, then the background thread writes them
+	void saveStacksInBackground(SizeType slot,
+	                            PsimagLite::String tmpName,
+	                            PsimagLite::String rootName) const
+	{
+		PsimagLite::OstringStream msg;
+		msg<<"Writing sys. and env. stacks to disk (for recovery) in the background";
+		progress_.printline(msg,std::cout);
+
+		for (SizeType i = 0; i < 2; ++i) {
+			SizeType what = (i == 0) ? SYSTEM : ENVIRON;
+			SizeType lowWater = checkpoint_.takeLowWater(what);
+			for (SizeType otherSlot = 0; otherSlot < 2; ++otherSlot) {
+				SizeType& unchanged = unchanged_[2*otherSlot + i];
+				if (lowWater < unchanged) unchanged = lowWater;
+			}
+
+			IncrementalDiskStackType& stack = stacks_[2*slot + i];
+			SizeType total = checkpoint_.memoryStack(what).size();
+			SizeType& unchanged = unchanged_[2*slot + i];
+			if (unchanged > stack.size()) unchanged = stack.size();
+			if (unchanged > total) unchanged = total;
+
+			snapshot_.stacks[i] = &stack;
+			snapshot_.keep[i] = unchanged;
+			checkpoint_.topOfStack(snapshot_.entries[i], what, total - unchanged);
+			unchanged = total;
+			files_.push_back(stack.file());
+		}
+
+		snapshot_.tmpName = tmpName;
+		snapshot_.rootName = rootName;
+		snapshot_.error = "";
+
+#ifdef USE_PTHREADS
+		if (pthread_create(&thread_, 0, snapshotMain, &snapshot_) == 0) {
+			running_ = true;
+			return;
+		}
+#endif
+
+		snapshot_.write();
+	}
+
+	static void* snapshotMain(void* arg)
+	{
+		static_cast<Snapshot*>(arg)->write();
+		return 0;
+	}
+
+	// Waits for the snapshot in progress, if any
+	void wait() const
+	{
+#ifdef USE_PTHREADS
+		if (running_) {
+			pthread_join(thread_, 0);
+			running_ = false;
+		}
+#endif
+
+		if (snapshot_.error == "") return;
+		PsimagLite::String str("Recovery: " + snapshot_.error);
+		snapshot_.error = "";
+		throw PsimagLite::RuntimeError(str);
+	}
+
 	void saveStacksForRecovery(PsimagLite::String rootWriteFile,
 	                           bool isObserveCode) const
 	{
@@ -169,14 +332,16 @@ private:
 			MemoryStackType systemStackCopy(checkpoint_.memoryStack(SYSTEM));
 			DiskStackType systemDiskTemp(sysReadFile,sysWriteFile,false,isObserveCode);
 			files_.push_back(sysWriteFile);
-			CheckpointType::loadStack(systemDiskTemp,systemStackCopy);
+			checkpoint_.loadStackFetching(systemDiskTemp,systemStackCopy);
+			systemDiskTemp.finalize();
 		}
 
 		{
 			MemoryStackType envStackCopy(checkpoint_.memoryStack(ENVIRON));
 			DiskStackType envDiskTemp(envReadFile,envWriteFile,false,isObserveCode);
 			files_.push_back(envWriteFile);
-			CheckpointType::loadStack(envDiskTemp,envStackCopy);
+			checkpoint_.loadStackFetching(envDiskTemp,envStackCopy);
+			envDiskTemp.finalize();
 		}
 	}
 
@@ -187,6 +352,13 @@ private:
 	const BasisWithOperatorsType& pE_;
 	mutable bool flag_m_;
 	mutable VectorStringType files_;
+	mutable typename PsimagLite::Vector<IncrementalDiskStackType>::Type stacks_;
+	mutable VectorSizeType unchanged_;
+	mutable Snapshot snapshot_;
+	mutable bool running_;
+#ifdef USE_PTHREADS
+	mutable pthread_t thread_;
+#endif
 };     //class Recovery
 
 } // namespace Dmrg
@@ -79,6 +79,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #ifndef REDUCEDOP_IMPL_H
 #define REDUCEDOP_IMPL_H
 
+#include <algorithm>
 #include "Su2SymmetryGlobals.h"
 #include "Operator.h"
 #include "ChangeOfBasis.h"
@@ -237,6 +238,13 @@ public:
 
 		j1Max_=basis2.jMax();
 		j2Max_=basis3.jMax();
+		setLfactorStrides();
+
+		// tabulate the Clebsch-Gordan coefficients this product can reach
+		SizeType jReached = std::max(std::max(j1Max_,j2Max_),thisBasis_->jMax());
+		for (SizeType i=0;i<momentumOfOperators_.size();i++)
+			jReached = std::max(jReached,momentumOfOperators_[i]+1);
+		if (jReached>0) cgObject_->grow(jReached-1);
 
 		// build all lfactors
 		lfactorLeft_.resize(momentumOfOperators_.size());
@@ -420,23 +428,6 @@ public:
 
 private:
 
-	SparseElementType lfactor(int ki,
-	                          bool order,
-	                          SizeType j1,
-	                          SizeType j2,
-	                          SizeType j1prime,
-	                          SizeType jProd,
-	                          SizeType jProdPrime) const
-	{
-		SizeType ix=lfactorIndex(order,j1,j2,j1prime,jProd,jProdPrime);
-		if (ki<0) {
-			if (order) return lfactorHamLeft_[ix];
-			return lfactorHamRight_[ix];
-		}
-		if (order) return lfactorLeft_[ki][ix];
-		return lfactorRight_[ki][ix];
-	}
-
 	SizeType lfactorIndex(bool order,
 	                      SizeType j1,
 	                      SizeType j2,
@@ -454,9 +445,8 @@ private:
 	                          SizeType jProd,
 	                          SizeType jProdPrime) const
 	{
-		SizeType ix = j1+j2*j1Max_+j1prime*j1Max_*j2Max_+jProd*j1Max_*j1Max_*j2Max_+
-		        jProdPrime*thisBasis_->jMax()*j1Max_*j1Max_*j2Max_;
-		return ix;
+		const VectorSizeType& s = lfactorStrideLeft_;
+		return j1+j2*s[1]+j1prime*s[2]+jProd*s[3]+jProdPrime*s[4];
 	}
 
 	SizeType lfactorIndexRight(SizeType j2,
@@ -465,9 +455,27 @@ private:
 	                           SizeType jProd,
 	                           SizeType jProdPrime) const
 	{
-		SizeType ix = j2+j1*j2Max_+j2prime*j2Max_*j1Max_+jProd*j2Max_*j2Max_*j1Max_+
-		        jProdPrime*thisBasis_->jMax()*j2Max_*j2Max_*j1Max_;
-		return ix;
+		const VectorSizeType& s = lfactorStrideRight_;
+		return j2+j1*s[1]+j2prime*s[2]+jProd*s[3]+jProdPrime*s[4];
+	}
+
+	// strides of the arguments of lfactorIndexLeft and lfactorIndexRight
+	void setLfactorStrides()
+	{
+		SizeType jMax = thisBasis_->jMax();
+		lfactorStrideLeft_.resize(5);
+		lfactorStrideLeft_[0] = 1;
+		lfactorStrideLeft_[1] = j1Max_;
+		lfactorStrideLeft_[2] = j1Max_*j2Max_;
+		lfactorStrideLeft_[3] = j1Max_*j1Max_*j2Max_;
+		lfactorStrideLeft_[4] = jMax*j1Max_*j1Max_*j2Max_;
+
+		lfactorStrideRight_.resize(5);
+		lfactorStrideRight_[0] = 1;
+		lfactorStrideRight_[1] = j2Max_;
+		lfactorStrideRight_[2] = j2Max_*j1Max_;
+		lfactorStrideRight_[3] = j2Max_*j2Max_*j1Max_;
+		lfactorStrideRight_[4] = jMax*j2Max_*j2Max_*j1Max_;
 	}
 
 	void calcReducedMapping(const BasisType&,const BasisType&)
@@ -595,7 +603,11 @@ private:
 							                        basisB->jVals(i2),
 							                        basisA->jVals(i1prime),
 							                        thisBasis_->jVals(i),
-							                        thisBasis_->jVals(iprime),k);
+							                        thisBasis_->jVals(iprime),k)*
+							        magicCorrection(basisA->jVals(i1),
+							                        basisA->jVals(i1prime),
+							                        thisBasis_->jVals(i),
+							                        thisBasis_->jVals(iprime));
 						}
 					}
 				}
@@ -603,6 +615,16 @@ private:
 		}
 	}
 
+	// externalProd_ reads lfactor(j1prime,j2,j1,jProdPrime,jProd) and
+	// needs it times sqrt((jProd+1)/(jProdPrime+1))*sqrt((j1prime+1)/(j1+1))
+	RealType magicCorrection(SizeType j1,
+	                         SizeType j1prime,
+	                         SizeType jProd,
+	                         SizeType jProdPrime) const
+	{
+		return sqrt(jProdPrime+1.0)/sqrt(jProd+1.0)*sqrt(j1+1.0)/sqrt(j1prime+1.0);
+	}
+
 	SparseElementType calcLfactor(bool order,
 	                              SizeType j1,
 	                              SizeType j2,
@@ -753,6 +775,13 @@ private:
 		const typename PsimagLite::Vector<VectorSizeType>::Type* fastBasis =
 		        &fastBasisLeft_;
 		if (!order) fastBasis = &fastBasisRight_;
+
+		const VectorType* lfactorPtr = 0;
+		if (ki<0) lfactorPtr = (order) ? &lfactorHamLeft_ : &lfactorHamRight_;
+		else lfactorPtr = (order) ? &lfactorLeft_[ki] : &lfactorRight_[ki];
+		const VectorType& lfactors = *lfactorPtr;
+		const VectorSizeType& strides = (order) ? lfactorStrideLeft_ : lfactorStrideRight_;
+
 		for (SizeType i0=0;i0<fastBasis->size();i0++) {
 			const PsimagLite::Vector<SizeType>::Type& twopairs = (*fastBasis)[i0];
 			SizeType i = twopairs[0];
@@ -774,6 +803,10 @@ private:
 			RealType fsign = 1;
 			if (!order && (ne2%2 !=0)) fsign = fermionSign;
 
+			// index of (j1prime,j2,j1,jProdPrime,jProd) without the j1prime term
+			SizeType ixBase = j2*strides[1] + j1*strides[2] + jProdPrime*strides[3] +
+			        jProd*strides[4];
+
 			for (int k=A.getRowPtr(i1);k<A.getRowPtr(i1+1);k++) {
 				SizeType i1prime = A.getCol(k);
 				SizeType ii1prime = basisA->reducedIndex(i1prime);
@@ -783,21 +816,12 @@ private:
 				if (order) fprime = flavorIndexCached_(i1prime,i2);
 				else fprime = flavorIndexCached_(i2,i1prime);
 
-				SparseElementType tmp = lfactor(ki,
-				                                order,
-				                                j1prime,
-				                                j2,
-				                                j1,
-				                                jProdPrime,
-				                                jProd);
+				// includes the magic correction, see buildLfactor
+				SparseElementType tmp = lfactors[ixBase + j1prime];
 				if (tmp==static_cast<SparseElementType>(0)) continue;
 				int iy = reducedMapping_(jProdPrime,fprime);
 				if (iy<0 || iy>=int(n)) continue;
 
-				// magic correction::
-				tmp *= sqrt(jProd+1.0)/sqrt(jProdPrime+1.0);
-				tmp *= sqrt(j1prime+1.0)/sqrt(j1+1.0);
-
 				tmp *= fsign * A.getValue(k);
 				B(ix,iy)=tmp;
 			}
@@ -888,6 +912,8 @@ private:
 	VectorVectorType lfactorLeft_;
 	VectorVectorType lfactorRight_;
 	VectorType lfactorHamLeft_,lfactorHamRight_;
+	VectorSizeType lfactorStrideLeft_;
+	VectorSizeType lfactorStrideRight_;
 	PsimagLite::Matrix<int> reducedMapping_;
 	PsimagLite::Vector<PsimagLite::Vector<SizeType>::Type>::Type fastBasisLeft_;
 	PsimagLite::Vector<PsimagLite::Vector<SizeType>::Type>::Type fastBasisRight_;
@@ -1,9 +1,8 @@
-// BEGIN LICENSE BLOCK
 /*
-Copyright (c) 2009, UT-Battelle, LLC
+Copyright (c) 2009-2018, UT-Battelle, LLC
 All rights reserved
 
-[DMRG++, Version 2.0.0]
+[DMRG++, Version 3.0]
 [by G.A., Oak Ridge National Laboratory]
 
 UT Battelle Open Source Software License 11242008
@@ -39,7 +38,7 @@ must include the following acknowledgment:
 "This product includes software produced by UT-Battelle,
 LLC under Contract No. DE-AC05-00OR22725  with the
 Department of Energy."
- 
+
 *********************************************************
 DISCLAIMER
 
@@ -67,50 +66,104 @@ INFORMATION, DATA, APPARATUS, PRODUCT, OR PROCESS
 DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 
 *********************************************************
-
-
 */
-// END LICENSE BLOCK
 /** \ingroup DMRG */
 /*@{*/
 
-/*! \file Runner.h
+/*! \file SerializerIndex.h
  *
- *  A class to help repeating a task multiple times
- * 
+ *  Step index (offset table) of a data file
+ *
+ *  DmrgSolver writes the label below, followed by the step number,
+ *  in front of each DmrgSerializer (and TimeSerializer) it saves.
+ *  This class scans the data file once, without parsing the steps,
+ *  and records the offset at which each step starts, so that a
+ *  step can be loaded on its own with seek(...)
  */
-#ifndef RUNNER_HEADER_H
-#define RUNNER_HEADER_H
+#ifndef DMRG_SERIALIZER_INDEX_H
+#define DMRG_SERIALIZER_INDEX_H
 
-#include "String.h"
 #include <fstream>
-#include <iostream>
-#include <vector>
-#include "TypeToString.h"
+#include <climits>
 #include <cstdlib>
+#include <cassert>
+#include "Vector.h"
+#include "TypeToString.h"
 
 namespace Dmrg {
-	class	Runner {
-	public:
-		Runner(const PsimagLite::String& exec,
-		       const PsimagLite::String& inputRoot,
-		       const PsimagLite::String& ext)
-		: exec_(exec),inputRoot_(inputRoot),ext_(ext)
-		{
+
+class SerializerIndex {
+
+public:
+
+	typedef long int OffsetType;
+	typedef PsimagLite::Vector<OffsetType>::Type VectorOffsetType;
+
+	SerializerIndex(const PsimagLite::String& filename)
+	    : filename_(filename), end_(0)
+	{
+		std::ifstream fin(filename.c_str());
+		if (!fin || !fin.good() || fin.bad()) return;
+
+		PsimagLite::String label = SerializerIndex::label();
+		std::string line;
+		OffsetType pos = fin.tellg();
+		while (std::getline(fin,line)) {
+			if (line.compare(0,label.length(),label) == 0) {
+				SizeType step = atoi(line.substr(label.length()).c_str());
+				// e.g., more than one run in the same file:
+				// do not index, and let the caller parse sequentially
+				if (step != offsets_.size()) {
+					offsets_.clear();
+					break;
+				}
+
+				offsets_.push_back(pos);
+			}
+
+			pos = fin.tellg();
 		}
-		
-		void operator()(SizeType i) const
-		{
-			PsimagLite::String s = exec_ + " " + inputRoot_ + ttos(i) + ext_;
-			system(s.c_str());
+
+		fin.clear();
+		fin.seekg(0,std::ios::end);
+		end_ = fin.tellg();
+	}
+
+	static PsimagLite::String label() { return "#SERIALIZERSTEP="; }
+
+	const PsimagLite::String& filename() const { return filename_; }
+
+	// Zero for data files written before steps were indexed
+	SizeType size() const { return offsets_.size(); }
+
+	OffsetType offset(SizeType step) const
+	{
+		assert(step < offsets_.size());
+		return offsets_[step];
+	}
+
+	OffsetType end() const { return end_; }
+
+	// Places io so that its next read is at offset
+	template<typename IoInputType>
+	static void seek(IoInputType& io, OffsetType offset)
+	{
+		io.rewind();
+		while (offset > INT_MAX) {
+			io.move(INT_MAX);
+			offset -= INT_MAX;
 		}
 
-	private:
+		io.move(offset);
+	}
 
-		PsimagLite::String exec_,inputRoot_,ext_;
-	}; // class Runner
+private:
+
+	PsimagLite::String filename_;
+	VectorOffsetType offsets_;
+	OffsetType end_;
+}; // class SerializerIndex
 } // namespace Dmrg
 
 /*@}*/
-#endif // RUNNER_HEADER_H
-
+#endif // DMRG_SERIALIZER_INDEX_H
@@ -447,7 +447,7 @@ namespace Dmrg {
 		typename PsimagLite::Vector<PairType>::Type reducedEffective_;
 		PsimagLite::Matrix<SizeType> reducedInverse_;
 		typename PsimagLite::Vector<SizeType>::Type flavorsOldInverse_;
-		ClebschGordanType& cgObject_;
+		const ClebschGordanType& cgObject_;
 
 	}; // class
 
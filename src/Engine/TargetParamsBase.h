@@ -101,7 +101,7 @@ public:
 
 	enum ConcatEnum {PRODUCT, SUM};
 
-	enum {KRYLOV,RUNGE_KUTTA,SUZUKI_TROTTER};
+	enum {KRYLOV,RUNGE_KUTTA,SUZUKI_TROTTER,TDVP};
 
 	virtual ~TargetParamsBase() {}
 
@@ -195,6 +195,16 @@ public:
 		return unimplemented("tau");
 	}
 
+	virtual void tau(RealType)
+	{
+		unimplemented("tau(RealType)");
+	}
+
+	virtual RealType errorTolerance() const
+	{
+		return 0;
+	}
+
 	virtual RealType maxTime() const
 	{
 		return unimplemented("maxTime");
@@ -100,7 +100,11 @@ public:
 	      advanceEach_(0),
 	      algorithm_(BaseType::KRYLOV),
 	      tau_(0),
-	      timeDirection_(1.0)
+	      timeDirection_(1.0),
+	      errorTolerance_(0),
+	      tauMin_(0),
+	      tauMax_(0),
+	      outputInterval_(0)
 	{
 		/*PSIDOC TargetParamsTimeVectors
 		\item[TSPTau] [RealType], $\tau$ for the Krylov,
@@ -110,8 +114,26 @@ public:
 		\item[TSPAdvanceEach] [Integer] Number of sites to sweep before
 		advancing to the next time.
 		\item[TSPAlgorithm] [String] Either
-		\verb!Krylov! or \verb!RungeKutta! or \verb!SuzukiTrotter!\\
+		\verb!Krylov! or \verb!RungeKutta! or \verb!SuzukiTrotter! or
+		\verb!TDVP!\\
 		Note that SuzukiTrotter is currently very experimental and unsupported.
+		TDVP targets a single vector, so it needs TSPTimeSteps=1; it evolves
+		by TSPTau every half sweep, so TSPAdvanceEach must be the number of
+		finite steps in a half sweep.
+		\item[TSPErrorTolerance] [RealType] Optional. If positive, $\tau$
+		is adapted after each time step so that the Krylov or Runge-Kutta
+		error estimate stays below this tolerance. The truncation error is
+		printed with each change of $\tau$ but does not change it.
+		TSPTau is then only the initial $\tau$.
+		Defaults to 0, which keeps $\tau$ fixed.
+		\item[TSPTauMin] [RealType] Optional. Smallest $\tau$ allowed in
+		adaptive mode. Defaults to TSPTau/16.
+		\item[TSPTauMax] [RealType] Optional. Largest $\tau$ allowed in
+		adaptive mode. Defaults to 16*TSPTau.
+		\item[TSPOutputInterval] [RealType] Optional. In adaptive mode,
+		steps are shortened so that every multiple of this interval is reached
+		exactly, and the in-situ measurements are made there.
+		Defaults to 0, meaning no output grid.
 		*/
 		io.readline(tau_,"TSPTau=");
 		io.readline(timeSteps_,"TSPTimeSteps=");
@@ -124,11 +146,14 @@ public:
 				algorithm_ = BaseType::RUNGE_KUTTA;
 			if (s=="SuzukiTrotter" || s=="suzukiTrotter" || s=="suzukitrotter")
 				algorithm_ = BaseType::SUZUKI_TROTTER;
+			if (s=="TDVP" || s=="Tdvp" || s=="tdvp")
+				algorithm_ = BaseType::TDVP;
 		} catch (std::exception&) {
 			PsimagLite::String s(__FILE__);
 			s += "\n FATAL: TSPAlgorithm not found in input file.\n";
 			s += "Please add either TSPAlgorithm=Krylov or TSPAlgorithm=RungeKutta";
-			s += " or TSPAlgorithm=SuzukiTrotter just below the TSPAdvanceEach= ";
+			s += " or TSPAlgorithm=SuzukiTrotter or TSPAlgorithm=TDVP";
+			s += " just below the TSPAdvanceEach= ";
 			s += " line in the input file.\n";
 			throw PsimagLite::RuntimeError(s.c_str());
 		}
@@ -136,6 +161,31 @@ public:
 		try {
 			io.readline(timeDirection_,"TSPTimeFactor=");
 		} catch (std::exception&) {}
+
+		try {
+			io.readline(errorTolerance_,"TSPErrorTolerance=");
+		} catch (std::exception&) {}
+
+		tauMin_ = tau_/16.0;
+		tauMax_ = tau_*16.0;
+
+		try {
+			io.readline(tauMin_,"TSPTauMin=");
+		} catch (std::exception&) {}
+
+		try {
+			io.readline(tauMax_,"TSPTauMax=");
+		} catch (std::exception&) {}
+
+		try {
+			io.readline(outputInterval_,"TSPOutputInterval=");
+		} catch (std::exception&) {}
+
+		if (errorTolerance_ > 0 && (tauMin_ <= 0 || tauMin_ > tauMax_)) {
+			PsimagLite::String s(__FILE__);
+			s += "\n FATAL: Adaptive time step needs 0 < TSPTauMin <= TSPTauMax\n";
+			throw PsimagLite::RuntimeError(s.c_str());
+		}
 	}
 
 	virtual SizeType timeSteps() const
@@ -158,6 +208,31 @@ public:
 		return tau_;
 	}
 
+	virtual void tau(RealType x)
+	{
+		tau_ = x;
+	}
+
+	virtual RealType errorTolerance() const
+	{
+		return errorTolerance_;
+	}
+
+	RealType tauMin() const
+	{
+		return tauMin_;
+	}
+
+	RealType tauMax() const
+	{
+		return tauMax_;
+	}
+
+	RealType outputInterval() const
+	{
+		return outputInterval_;
+	}
+
 	virtual RealType timeDirection() const
 	{
 		return timeDirection_;
@@ -170,6 +245,10 @@ private:
 	SizeType algorithm_;
 	RealType tau_;
 	RealType timeDirection_;
+	RealType errorTolerance_;
+	RealType tauMin_;
+	RealType tauMax_;
+	RealType outputInterval_;
 
 }; // class TargetParamsTimeVectors
 
@@ -183,6 +262,13 @@ operator<<(std::ostream& os,const TargetParamsTimeVectors<ModelType>& t)
 	os<<"#TargetParams.advanceEach="<<t.advanceEach()<<"\n";
 	os<<"#TargetParams.algorithm="<<t.algorithm()<<"\n";
 	os<<"#TargetParams.timeDirection="<<t.timeDirection()<<"\n";
+	if (t.errorTolerance() > 0) {
+		os<<"#TargetParams.errorTolerance="<<t.errorTolerance()<<"\n";
+		os<<"#TargetParams.tauMin="<<t.tauMin()<<"\n";
+		os<<"#TargetParams.tauMax="<<t.tauMax()<<"\n";
+		os<<"#TargetParams.outputInterval="<<t.outputInterval()<<"\n";
+	}
+
 	return os;
 }
 } // namespace Dmrg
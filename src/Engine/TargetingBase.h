@@ -153,6 +153,9 @@ public:
 
 	virtual bool includeGroundStage() const {return true; }
 
+	// Discarded weight of the truncation that follows evolve
+	virtual void truncationError(RealType) {}
+
 	virtual void updateOnSiteForCorners(BasisWithOperatorsType& basisWithOps) const
 	{
 		if (BasisWithOperatorsType::useSu2Symmetry()) return;
@@ -219,6 +219,11 @@ public:
 
 	void timeHasAdvanced() { applyOpExpression_.timeHasAdvanced(); }
 
+	RealType timeVectorsErrorEstimate() const
+	{
+		return applyOpExpression_.timeVectorsErrorEstimate();
+	}
+
 	template<typename IoOutputType>
 	void save(const VectorSizeType& block,
 	          IoOutputType& io,
@@ -174,7 +174,8 @@ public:
 	      mettsCollapse_(mettsStochastics_,lrs,mettsStruct_),
 	      prevDirection_(ProgramGlobals::INFINITE),
 	      systemPrev_(),
-	      environPrev_()
+	      environPrev_(),
+	      timesWithoutAdvancement_(0)
 	{
 		this->common().init(&mettsStruct_,mettsStruct_.timeSteps()+1);
 		if (!wft.isEnabled()) throw PsimagLite::RuntimeError(" TargetingMetts "
@@ -393,8 +394,6 @@ private:
 
 	void advanceCounterAndComputeStage(const VectorSizeType& block)
 	{
-		static SizeType timesWithoutAdvancement = 0;
-
 		if (this->common().noStageIs(COLLAPSE))
 			this->common().setAllStagesTo(WFT_NOADVANCE);
 
@@ -402,13 +401,13 @@ private:
 			if (!allSitesCollapsed()) {
 				if (sitesCollapsed_.size()>2*model_.geometry().numberOfSites())
 					throw PsimagLite::RuntimeError("advanceCounterAndComputeStage\n");
-				printAdvancement(timesWithoutAdvancement);
+				printAdvancement(timesWithoutAdvancement_);
 				return;
 			}
 
 			sitesCollapsed_.clear();
 			this->common().setAllStagesTo(WFT_NOADVANCE);
-			timesWithoutAdvancement = 0;
+			timesWithoutAdvancement_ = 0;
 			this->common().setTime(0);
 			PsimagLite::OstringStream msg;
 			SizeType n1 = mettsStruct_.timeSteps();
@@ -418,13 +417,13 @@ private:
 			for (SizeType i=0;i<n1;i++)
 				this->common().targetVectors(i) = this->common().targetVectors()[n1];
 			this->common().timeHasAdvanced();
-			printAdvancement(timesWithoutAdvancement);
+			printAdvancement(timesWithoutAdvancement_);
 			return;
 		}
 
-		if (timesWithoutAdvancement < mettsStruct_.advanceEach()) {
-			timesWithoutAdvancement++;
-			printAdvancement(timesWithoutAdvancement);
+		if (timesWithoutAdvancement_ < mettsStruct_.advanceEach()) {
+			timesWithoutAdvancement_++;
+			printAdvancement(timesWithoutAdvancement_);
 			return;
 		}
 
@@ -433,15 +432,15 @@ private:
 			this->common().setAllStagesTo(WFT_ADVANCE);
 			RealType tmp = this->common().currentTime() + mettsStruct_.tau();
 			this->common().setTime(tmp);
-			timesWithoutAdvancement = 0;
-			printAdvancement(timesWithoutAdvancement);
+			timesWithoutAdvancement_ = 0;
+			printAdvancement(timesWithoutAdvancement_);
 			return;
 		}
 
 		if (this->common().noStageIs(COLLAPSE) &&
 		    this->common().currentTime() >= mettsStruct_.beta &&
 		    block[0]!=block.size()) {
-			printAdvancement(timesWithoutAdvancement);
+			printAdvancement(timesWithoutAdvancement_);
 			return;
 		}
 
@@ -451,8 +450,8 @@ private:
 			sitesCollapsed_.clear();
 			SizeType n1 = mettsStruct_.timeSteps();
 			this->common().targetVectors(n1).resize(0);
-			timesWithoutAdvancement = 0;
-			printAdvancement(timesWithoutAdvancement);
+			timesWithoutAdvancement_ = 0;
+			printAdvancement(timesWithoutAdvancement_);
 			return;
 		}
 	}
@@ -886,6 +885,7 @@ private:
 	SizeType prevDirection_;
 	MettsPrev systemPrev_;
 	MettsPrev environPrev_;
+	SizeType timesWithoutAdvancement_;
 	std::pair<TargetVectorType,TargetVectorType> pureVectors_;
 	VectorSizeType sitesCollapsed_;
 };     //class TargetingMetts
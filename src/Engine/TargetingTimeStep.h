@@ -137,7 +137,10 @@ public:
 	      times_(tstStruct_.timeSteps()),
 	      weight_(tstStruct_.timeSteps()),
 	      tvEnergy_(times_.size(),0.0),
-	      gsWeight_(tstStruct_.gsWeight())
+	      gsWeight_(tstStruct_.gsWeight()),
+	      stepError_(0.0),
+	      truncationError_(0.0),
+	      tauUnclipped_(tstStruct_.tau())
 	{
 		this->common().init(&tstStruct_,tstStruct_.timeSteps());
 		if (!wft.isEnabled())
@@ -146,6 +149,15 @@ public:
 			throw PsimagLite::RuntimeError("TST needs at least one TSPSite\n");
 
 		RealType tau =tstStruct_.tau();
+		if (tstStruct_.algorithm() == TargetParamsType::TDVP) {
+			if (times_.size() != 1)
+				throw PsimagLite::RuntimeError("TST: TDVP needs TSPTimeSteps=1\n");
+			times_[0] = tau;
+			weight_[0] = 1.0 - gsWeight_;
+			this->common().initTimeVectors(times_,ioIn);
+			return;
+		}
+
 		RealType sum = 0;
 		SizeType n = times_.size();
 
@@ -208,6 +220,13 @@ public:
 		printNormsAndWeights();
 	}
 
+	// reported with each change of tau, but does not drive it
+	void truncationError(RealType e)
+	{
+		if (tstStruct_.errorTolerance() <= 0) return;
+		if (e > truncationError_) truncationError_ = e;
+	}
+
 	bool end() const
 	{
 		return (tstStruct_.maxTime() != 0 &&
@@ -217,6 +236,19 @@ public:
 	void load(const PsimagLite::String& f)
 	{
 		this->common().template load<TimeSerializerType>(f);
+
+		// an adaptive run restarts with the tau it had reached
+		if (tstStruct_.errorTolerance() <= 0) return;
+		PsimagLite::IoSimple::In io(f);
+		if (io.count("TSTTau=") == 0) return;
+		io.rewind();
+		RealType tau = 0;
+		io.readline(tau,"TSTTau=",PsimagLite::IoSimple::In::LAST_INSTANCE);
+		io.rewind();
+		io.readline(tauUnclipped_,
+		            "TSTTauUnclipped=",
+		            PsimagLite::IoSimple::In::LAST_INSTANCE);
+		setTau(tau);
 	}
 
 	void print(InputSimpleOutType& ioOut) const
@@ -253,6 +285,13 @@ public:
 			msg2<<"TargetVectorEnergy"<<i<<"="<<tvEnergy_[i];
 			io.printline(msg2);
 		}
+
+		if (tstStruct_.errorTolerance() <= 0) return;
+		PsimagLite::OstringStream msg3;
+		msg3.precision(16);
+		msg3<<"TSTTau="<<tstStruct_.tau()<<"\n";
+		msg3<<"TSTTauUnclipped="<<tauUnclipped_;
+		io.printline(msg3);
 	}
 
 private:
@@ -264,8 +303,13 @@ private:
 	{
 		if (direction == ProgramGlobals::INFINITE) return;
 		VectorWithOffsetType phiNew;
+		RealType timeBefore = this->common().currentTime();
 		this->common().getPhi(phiNew,Eg,direction,block1[0],loopNumber);
 
+		bool adaptive = (tstStruct_.errorTolerance() > 0);
+		if (adaptive && this->common().currentTime() > timeBefore)
+			adaptTau();
+
 		PairType startEnd(0,times_.size());
 		bool allOperatorsApplied = (this->common().noStageIs(DISABLED) &&
 		                            this->common().noStageIs(OPERATOR));
@@ -277,6 +321,11 @@ private:
 		                               allOperatorsApplied,
 		                               block1);
 
+		if (adaptive && allOperatorsApplied) {
+			RealType e = this->common().timeVectorsErrorEstimate();
+			if (e > stepError_) stepError_ = e;
+		}
+
 		cocoon(direction,block1); // in-situ
 
 		printEnergies(); // in-situ
@@ -295,6 +344,63 @@ private:
 		printNormsAndWeights();
 	}
 
+	// Called once per time step, right after the time has advanced by the
+	// old tau, so that the next window of time vectors uses the new one.
+	// The step just taken cannot be redone, so a large error only shrinks
+	// the steps that follow. Only the time-step error drives tau; a step
+	// shortened to land on the output grid does not shrink the next one.
+	void adaptTau()
+	{
+		const RealType tol = tstStruct_.errorTolerance();
+		const RealType tau = tstStruct_.tau();
+		const RealType maxGrowth = 2.0;
+		const RealType maxShrink = 0.5;
+
+		RealType factor = maxGrowth;
+		if (stepError_ > 0) {
+			factor = 0.9*pow(tol/stepError_,0.2);
+			if (factor > maxGrowth) factor = maxGrowth;
+			if (factor < maxShrink) factor = maxShrink;
+		}
+
+		RealType newTau = tauUnclipped_*factor;
+		if (newTau < tstStruct_.tauMin()) newTau = tstStruct_.tauMin();
+		if (newTau > tstStruct_.tauMax()) newTau = tstStruct_.tauMax();
+		tauUnclipped_ = newTau;
+
+		// land exactly on the output grid and on TSPMaxTime
+		RealType t = this->common().currentTime();
+		RealType interval = tstStruct_.outputInterval();
+		if (interval > 0) {
+			RealType next = (floor(t/interval + 1e-6) + 1.0)*interval;
+			if (t + newTau > next - 1e-6*interval) newTau = next - t;
+		}
+
+		RealType maxTime = tstStruct_.maxTime();
+		if (maxTime > t && t + newTau > maxTime) newTau = maxTime - t;
+
+		PsimagLite::OstringStream msg;
+		msg<<"time="<<t<<" stepError="<<stepError_;
+		msg<<" truncationError="<<truncationError_;
+		msg<<" tau="<<tau<<" newTau="<<newTau;
+		progress_.printline(msg,std::cout);
+
+		stepError_ = 0.0;
+		truncationError_ = 0.0;
+		if (newTau == tau) return;
+
+		setTau(newTau);
+	}
+
+	void setTau(RealType tau)
+	{
+		tstStruct_.tau(tau);
+		SizeType n = times_.size();
+		if (n < 2) return;
+		for (SizeType i = 0; i < n; ++i)
+			times_[i] = i*tau/(n-1);
+	}
+
 	void printNormsAndWeights() const
 	{
 		if (this->common().allStages(DISABLED)) return;
@@ -388,6 +494,9 @@ private:
 	VectorRealType weight_;
 	mutable VectorRealType tvEnergy_;
 	RealType gsWeight_;
+	RealType stepError_;
+	RealType truncationError_;
+	RealType tauUnclipped_;
 };     //class TargetingTimeStep
 
 template<typename LanczosSolverType, typename VectorWithOffsetType>
@@ -0,0 +1,627 @@
+/*
+Copyright (c) 2009-2018, UT-Battelle, LLC
+All rights reserved
+
+[DMRG++, Version 3.0]
+[by G.A., Oak Ridge National Laboratory]
+
+UT Battelle Open Source Software License 11242008
+
+OPEN SOURCE LICENSE
+
+Subject to the conditions of this License, each
+contributor to this software hereby grants, free of
+charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), a
+perpetual, worldwide, non-exclusive, no-charge,
+royalty-free, irrevocable copyright license to use, copy,
+modify, merge, publish, distribute, and/or sublicense
+copies of the Software.
+
+1. Redistributions of Software must retain the above
+copyright and license notices, this list of conditions,
+and the following disclaimer.  Changes or modifications
+to, or derivative works of, the Software should be noted
+with comments and the contributor and organization's
+name.
+
+2. Neither the names of UT-Battelle, LLC or the
+Department of Energy nor the names of the Software
+contributors may be used to endorse or promote products
+derived from this software without specific prior written
+permission of UT-Battelle.
+
+3. The software and the end-user documentation included
+with the redistribution, with or without modification,
+must include the following acknowledgment:
+
+"This product includes software produced by UT-Battelle,
+LLC under Contract No. DE-AC05-00OR22725  with the
+Department of Energy."
+
+*********************************************************
+DISCLAIMER
+
+THE SOFTWARE IS SUPPLIED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER, CONTRIBUTORS, UNITED STATES GOVERNMENT,
+OR THE UNITED STATES DEPARTMENT OF ENERGY BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+NEITHER THE UNITED STATES GOVERNMENT, NOR THE UNITED
+STATES DEPARTMENT OF ENERGY, NOR THE COPYRIGHT OWNER, NOR
+ANY OF THEIR EMPLOYEES, REPRESENTS THAT THE USE OF ANY
+INFORMATION, DATA, APPARATUS, PRODUCT, OR PROCESS
+DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
+
+*********************************************************
+*/
+/** \ingroup DMRG */
+/*@{*/
+
+/*! \file ThreadPool.h
+ *
+ *  A persistent pool of worker threads for the engine's hot loops
+ *
+ *  PsimagLite::Parallelizer creates and joins its threads on every
+ *  loopCreate. ParallelizerPool has the same interface, but submits the
+ *  tasks to workers that are created once and then sleep between
+ *  batches. Each thread first takes tasks from its own queue, a
+ *  contiguous range balanced by the weights if given, and then steals
+ *  from the back of the queue of another thread.
+ *
+ *  ThreadScratch gives a helper per-thread buffers that outlive it, so
+ *  that they are allocated once and not on every run.
+ *
+ */
+#ifndef DMRG_THREAD_POOL_H
+#define DMRG_THREAD_POOL_H
+
+#include "Vector.h"
+#include "Concurrency.h"
+#include "Parallelizer.h"
+#include <cassert>
+#include <cstdlib>
+#ifdef USE_PTHREADS
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+namespace Dmrg {
+
+class ThreadPool {
+
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+
+	class BatchBase {
+
+	public:
+
+		virtual ~BatchBase() {}
+
+		virtual void doTask(SizeType taskNumber, SizeType threadNum) = 0;
+	};
+
+	template<typename HelperType>
+	class Batch : public BatchBase {
+
+	public:
+
+		Batch(HelperType& helper) : helper_(helper) {}
+
+		void doTask(SizeType taskNumber, SizeType threadNum)
+		{
+			helper_.doTask(taskNumber, threadNum);
+		}
+
+	private:
+
+		HelperType& helper_;
+	};
+
+#ifdef USE_PTHREADS
+	// Tasks [front, back) not yet taken; the owner pops at the front,
+	// thieves at the back
+	struct Queue {
+		SizeType front;
+		SizeType back;
+		pthread_mutex_t mutex;
+	};
+
+	struct WorkerArgs {
+		ThreadPool* pool;
+		SizeType threadNum;
+		SizeType generation;
+	};
+#endif
+
+public:
+
+	static ThreadPool& instance()
+	{
+		static ThreadPool pool;
+		return pool;
+	}
+
+	~ThreadPool()
+	{
+#ifdef USE_PTHREADS
+		stopWorkers();
+		pthread_cond_destroy(&batchDone_);
+		pthread_cond_destroy(&workAvailable_);
+		pthread_mutex_destroy(&mutex_);
+#endif
+	}
+
+	// pin worker i to core i, after the cores of the ranks of this node
+	// that come before this one; takes effect when the workers are next created
+	void pinThreads(bool flag) { pin_ = flag; }
+
+	// Runs helper.doTask(i, thread) for i in [0, helper.tasks()) on
+	// nthreads threads, the calling one included. A batch submitted
+	// while another one runs (from a task, or from another thread)
+	// runs serially on the calling thread
+	template<typename HelperType>
+	void run(HelperType& helper, SizeType nthreads, const VectorSizeType* weights = 0)
+	{
+		Batch<HelperType> batch(helper);
+		SizeType total = helper.tasks();
+#ifdef USE_PTHREADS
+		if (nthreads > total) nthreads = total;
+		if (nthreads > 1 && acquire()) {
+			runInPool(batch, total, nthreads, weights);
+			release();
+			return;
+		}
+#endif
+		for (SizeType i = 0; i < total; ++i)
+			batch.doTask(i, 0);
+	}
+
+	// One more than the largest threadNum given to doTask; helpers
+	// size their per-thread storage with it, per run or with a
+	// ThreadScratch, since a run that falls back to serial uses
+	// threadNum 0 alongside other runs
+	static SizeType maxThreads()
+	{
+		return PsimagLite::Concurrency::storageSize(PsimagLite::Concurrency::npthreads);
+	}
+
+private:
+
+	ThreadPool()
+	    : pin_(false),
+	      busy_(false),
+	      batch_(0),
+	      total_(0),
+	      nthreads_(0),
+	      generation_(0),
+	      pending_(0),
+	      shutdown_(false)
+	{
+#ifdef USE_PTHREADS
+		pthread_mutex_init(&mutex_, 0);
+		pthread_cond_init(&workAvailable_, 0);
+		pthread_cond_init(&batchDone_, 0);
+#endif
+	}
+
+	ThreadPool(const ThreadPool&);
+
+	ThreadPool& operator=(const ThreadPool&);
+
+#ifdef USE_PTHREADS
+
+	bool acquire()
+	{
+		pthread_mutex_lock(&mutex_);
+		bool wasBusy = busy_;
+		busy_ = true;
+		pthread_mutex_unlock(&mutex_);
+		return !wasBusy;
+	}
+
+	void release()
+	{
+		pthread_mutex_lock(&mutex_);
+		busy_ = false;
+		pthread_mutex_unlock(&mutex_);
+	}
+
+	void runInPool(BatchBase& batch,
+	               SizeType total,
+	               SizeType nthreads,
+	               const VectorSizeType* weights)
+	{
+		// workers are nthreads - 1; the calling thread is thread 0
+		if (workers_.size() + 1 < nthreads) {
+			stopWorkers();
+			startWorkers(nthreads - 1);
+		}
+
+		fillQueues(total, nthreads, weights);
+
+		pthread_mutex_lock(&mutex_);
+		batch_ = &batch;
+		total_ = total;
+		nthreads_ = nthreads;
+		pending_ = workers_.size();
+		++generation_;
+		pthread_cond_broadcast(&workAvailable_);
+		pthread_mutex_unlock(&mutex_);
+
+		work(0);
+
+		pthread_mutex_lock(&mutex_);
+		while (pending_ > 0)
+			pthread_cond_wait(&batchDone_, &mutex_);
+		batch_ = 0;
+		pthread_mutex_unlock(&mutex_);
+	}
+
+	// Contiguous ranges of about equal weight, one per thread
+	void fillQueues(SizeType total, SizeType nthreads, const VectorSizeType* weights)
+	{
+		assert(queues_.size() >= nthreads);
+		assert(!weights || weights->size() == total);
+		long unsigned int sum = 0;
+		if (weights) {
+			for (SizeType i = 0; i < total; ++i)
+				sum += (*weights)[i];
+		}
+
+		SizeType task = 0;
+		long unsigned int acc = 0;
+		for (SizeType t = 0; t < nthreads; ++t) {
+			queues_[t].front = task;
+			if (t + 1 == nthreads) {
+				task = total;
+			} else if (!weights || sum == 0) {
+				task = ((t + 1)*total)/nthreads;
+			} else {
+				long unsigned int target = ((t + 1)*sum)/nthreads;
+				while (task < total && acc + (*weights)[task] <= target)
+					acc += (*weights)[task++];
+			}
+
+			queues_[t].back = task;
+		}
+	}
+
+	void work(SizeType threadNum)
+	{
+		SizeType nthreads = nthreads_;
+		SizeType task = 0;
+		while (popFront(threadNum, task))
+			batch_->doTask(task, threadNum);
+
+		for (SizeType k = 1; k < nthreads; ++k) {
+			SizeType victim = (threadNum + k) % nthreads;
+			while (popBack(victim, task))
+				batch_->doTask(task, threadNum);
+		}
+	}
+
+	bool popFront(SizeType q, SizeType& task)
+	{
+		Queue& queue = queues_[q];
+		pthread_mutex_lock(&queue.mutex);
+		bool found = (queue.front < queue.back);
+		if (found) task = queue.front++;
+		pthread_mutex_unlock(&queue.mutex);
+		return found;
+	}
+
+	bool popBack(SizeType q, SizeType& task)
+	{
+		Queue& queue = queues_[q];
+		pthread_mutex_lock(&queue.mutex);
+		bool found = (queue.front < queue.back);
+		if (found) task = --queue.back;
+		pthread_mutex_unlock(&queue.mutex);
+		return found;
+	}
+
+	static void* workerMain(void* p)
+	{
+		WorkerArgs* args = static_cast<WorkerArgs*>(p);
+		args->pool->workerLoop(args->threadNum, args->generation);
+		return 0;
+	}
+
+	// seen is the generation when this worker was created, so that a
+	// batch submitted before the worker first runs is not missed
+	void workerLoop(SizeType threadNum, SizeType seen)
+	{
+		while (true) {
+			pthread_mutex_lock(&mutex_);
+			while (generation_ == seen && !shutdown_)
+				pthread_cond_wait(&workAvailable_, &mutex_);
+			if (shutdown_) {
+				pthread_mutex_unlock(&mutex_);
+				return;
+			}
+
+			seen = generation_;
+			bool active = (threadNum < nthreads_);
+			pthread_mutex_unlock(&mutex_);
+
+			if (active) work(threadNum);
+
+			pthread_mutex_lock(&mutex_);
+			if (--pending_ == 0) pthread_cond_signal(&batchDone_);
+			pthread_mutex_unlock(&mutex_);
+		}
+	}
+
+	void startWorkers(SizeType n)
+	{
+		queues_.resize(n + 1);
+		for (SizeType t = 0; t < queues_.size(); ++t)
+			pthread_mutex_init(&queues_[t].mutex, 0);
+
+		pthread_mutex_lock(&mutex_);
+		shutdown_ = false;
+		SizeType generation = generation_;
+		pthread_mutex_unlock(&mutex_);
+
+		args_.resize(n);
+		workers_.resize(n);
+		SizeType firstCore = localRank()*maxThreads();
+		for (SizeType i = 0; i < n; ++i) {
+			args_[i].pool = this;
+			args_[i].threadNum = i + 1;
+			args_[i].generation = generation;
+			pthread_create(&workers_[i], 0, workerMain, &args_[i]);
+			if (pin_) pinToCore(workers_[i], firstCore + i + 1);
+		}
+
+		if (pin_) pinToCore(pthread_self(), firstCore);
+	}
+
+	void stopWorkers()
+	{
+		pthread_mutex_lock(&mutex_);
+		shutdown_ = true;
+		pthread_cond_broadcast(&workAvailable_);
+		pthread_mutex_unlock(&mutex_);
+
+		for (SizeType i = 0; i < workers_.size(); ++i)
+			pthread_join(workers_[i], 0);
+
+		for (SizeType t = 0; t < queues_.size(); ++t)
+			pthread_mutex_destroy(&queues_[t].mutex);
+
+		workers_.clear();
+		args_.clear();
+		queues_.clear();
+	}
+
+	static void pinToCore(pthread_t thread, SizeType core)
+	{
+#ifdef __linux__
+		long cores = sysconf(_SC_NPROCESSORS_ONLN);
+		if (cores > 0) core %= cores;
+		cpu_set_t cpuset;
+		CPU_ZERO(&cpuset);
+		CPU_SET(core, &cpuset);
+		pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpuset);
+#endif
+	}
+
+	// Rank of this process among those of its node, as set by the
+	// MPI launcher or by Slurm; zero without MPI
+	static SizeType localRank()
+	{
+		if (!PsimagLite::Concurrency::hasMpi()) return 0;
+		const char* names[] = {"OMPI_COMM_WORLD_LOCAL_RANK",
+		                       "MV2_COMM_WORLD_LOCAL_RANK",
+		                       "MPI_LOCALRANKID",
+		                       "PMI_LOCAL_RANK",
+		                       "SLURM_LOCALID"};
+		for (SizeType i = 0; i < sizeof(names)/sizeof(names[0]); ++i) {
+			const char* value = getenv(names[i]);
+			if (value) return atoi(value);
+		}
+
+		return 0;
+	}
+
+	pthread_mutex_t mutex_;
+	pthread_cond_t workAvailable_;
+	pthread_cond_t batchDone_;
+	PsimagLite::Vector<pthread_t>::Type workers_;
+	PsimagLite::Vector<WorkerArgs>::Type args_;
+	PsimagLite::Vector<Queue>::Type queues_;
+#endif
+
+	bool pin_;
+	bool busy_;
+	BatchBase* batch_;
+	SizeType total_;
+	SizeType nthreads_;
+	SizeType generation_;
+	SizeType pending_;
+	bool shutdown_;
+}; // class ThreadPool
+
+/* Drop-in for PsimagLite::Parallelizer that runs on the ThreadPool.
+   With MPI it falls back to PsimagLite::Parallelizer, which also
+   splits the tasks among ranks */
+template<typename HelperType>
+class ParallelizerPool {
+
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+	typedef PsimagLite::Parallelizer<HelperType> ParallelizerType;
+
+public:
+
+	ParallelizerPool(SizeType nthreads, PsimagLite::MPI::CommType comm)
+	    : nthreads_(nthreads), comm_(comm)
+	{}
+
+	void loopCreate(HelperType& helper)
+	{
+		if (PsimagLite::Concurrency::hasMpi()) {
+			ParallelizerType parallelizer(nthreads_, comm_);
+			parallelizer.loopCreate(helper);
+			return;
+		}
+
+		ThreadPool::instance().run(helper, nthreads_);
+	}
+
+	void loopCreate(HelperType& helper, const VectorSizeType& weights)
+	{
+		if (PsimagLite::Concurrency::hasMpi()) {
+			ParallelizerType parallelizer(nthreads_, comm_);
+			parallelizer.loopCreate(helper, weights);
+			return;
+		}
+
+		ThreadPool::instance().run(helper, nthreads_, &weights);
+	}
+
+private:
+
+	SizeType nthreads_;
+	PsimagLite::MPI::CommType comm_;
+}; // class ParallelizerPool
+
+/* Like ParallelizerPool, but the tasks are split among the threads of
+   this process only, also with MPI. For loops whose results are not
+   gathered or reduced across ranks */
+template<typename HelperType>
+class ParallelizerThreads {
+
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+
+public:
+
+	explicit ParallelizerThreads(SizeType nthreads)
+	    : nthreads_(nthreads)
+	{}
+
+	void loopCreate(HelperType& helper)
+	{
+		ThreadPool::instance().run(helper, nthreads_);
+	}
+
+	void loopCreate(HelperType& helper, const VectorSizeType& weights)
+	{
+		ThreadPool::instance().run(helper, nthreads_, &weights);
+	}
+
+private:
+
+	SizeType nthreads_;
+}; // class ParallelizerThreads
+
+/* Buffers of type T, one per threadNum, for a helper to keep its
+   per-thread partial results in. They are taken from the pool when the
+   helper is built and given back when it is destroyed, keeping their
+   memory for the next helper. Each helper has its own, so a run that
+   falls back to serial, on threadNum 0, never shares them with
+   another run */
+template<typename T>
+class ThreadScratch {
+
+	typedef typename PsimagLite::Vector<T>::Type VectorType;
+	typedef typename PsimagLite::Vector<VectorType*>::Type VectorVectorType;
+
+	// buffers not taken; freed at exit
+	struct FreeList {
+
+		~FreeList()
+		{
+			for (SizeType i = 0; i < buffers.size(); ++i)
+				delete buffers[i];
+		}
+
+		VectorVectorType buffers;
+	};
+
+public:
+
+	ThreadScratch() : buffers_(take())
+	{
+		if (buffers_->size() < ThreadPool::maxThreads())
+			buffers_->resize(ThreadPool::maxThreads());
+	}
+
+	~ThreadScratch() { give(buffers_); }
+
+	SizeType size() const { return buffers_->size(); }
+
+	T& operator[](SizeType threadNum)
+	{
+		assert(threadNum < buffers_->size());
+		return (*buffers_)[threadNum];
+	}
+
+	const T& operator[](SizeType threadNum) const
+	{
+		assert(threadNum < buffers_->size());
+		return (*buffers_)[threadNum];
+	}
+
+private:
+
+	ThreadScratch(const ThreadScratch&);
+
+	ThreadScratch& operator=(const ThreadScratch&);
+
+	static VectorType* take()
+	{
+		lock(true);
+		VectorVectorType& free = freeList().buffers;
+		VectorType* buffers = 0;
+		if (free.size() > 0) {
+			buffers = free.back();
+			free.pop_back();
+		}
+
+		lock(false);
+		return (buffers) ? buffers : new VectorType();
+	}
+
+	static void give(VectorType* buffers)
+	{
+		lock(true);
+		freeList().buffers.push_back(buffers);
+		lock(false);
+	}
+
+	static FreeList& freeList()
+	{
+		static FreeList free;
+		return free;
+	}
+
+	static void lock(bool flag)
+	{
+#ifdef USE_PTHREADS
+		static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+		if (flag) pthread_mutex_lock(&mutex);
+		else pthread_mutex_unlock(&mutex);
+#endif
+	}
+
+	VectorType* buffers_;
+}; // class ThreadScratch
+} // namespace Dmrg
+/*@}*/
+#endif // DMRG_THREAD_POOL_H
+
@@ -107,6 +107,10 @@ public:
 	virtual ~TimeVectorsBase() {}
 
 	virtual void timeHasAdvanced() {}
+
+	// Estimate of the relative error of the last time vector computed by
+	// calcTimeVectors, zero if the algorithm does not provide one
+	virtual RealType errorEstimate() const { return 0.0; }
 }; //class TimeVectorsBase
 } // namespace Dmrg
 /*@}*/
@@ -147,7 +147,8 @@ public:
 	      lrs_(lrs),
 	      E0_(E0),
 	      ioIn_(ioIn),
-	      timeHasAdvanced_(true)
+	      timeHasAdvanced_(true),
+	      errorEstimate_(0.0)
 	{}
 
 	virtual void calcTimeVectors(const PairType& startEnd,
@@ -165,6 +166,7 @@ public:
 
 		assert(0 < targetVectors_.size());
 		targetVectors_[0] = phi;
+		errorEstimate_ = 0.0;
 
 		if (times_.size() == 1 && fabs(times_[0])<1e-10) return;
 
@@ -191,6 +193,8 @@ public:
 		timeHasAdvanced_ = true;
 	}
 
+	RealType errorEstimate() const { return errorEstimate_; }
+
 private:
 
 	//! Do not normalize states here, it leads to wrong results (!)
@@ -254,10 +258,29 @@ private:
 		r.resize(n2);
 		calcR(r,T,V,phi,Eg,eigs,timeIndex,steps,i0);
 		psimag::BLAS::GEMV('N',n2,n2,zone,&(T(0,0)),n2,&(r[0]),1,zzero,&(tmp[0]),1);
+		if (timeIndex + 1 == times_.size())
+			updateErrorEstimate(tmp);
 		r.resize(n);
 		psimag::BLAS::GEMV('N',n,n2,zone,&(V(0,0)),n,&(tmp[0]),1,zzero,&(r[0]),1);
 	}
 
+	// The weight of the last Lanczos vector in exp(-iHt)|phi> measures
+	// how well the Krylov space resolves the evolution up to times_.back()
+	void updateErrorEstimate(const TargetVectorType& tmp)
+	{
+		SizeType n2 = tmp.size();
+		if (n2 == 0) return;
+		RealType sum = 0.0;
+		for (SizeType k = 0; k < n2; ++k) {
+			RealType a = std::abs(tmp[k]);
+			sum += a*a;
+		}
+
+		if (sum < 1e-20) return;
+		RealType e = std::abs(tmp[n2-1])/sqrt(sum);
+		if (e > errorEstimate_) errorEstimate_ = e;
+	}
+
 	void calcR(TargetVectorType& r,
 	           const MatrixComplexOrRealType& T,
 	           const MatrixComplexOrRealType& V,
@@ -320,6 +343,7 @@ private:
 	const RealType& E0_;
 	InputValidatorType& ioIn_;
 	bool timeHasAdvanced_;
+	RealType errorEstimate_;
 }; //class TimeVectorsKrylov
 } // namespace Dmrg
 /*@}*/
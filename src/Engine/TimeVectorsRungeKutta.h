@@ -140,7 +140,8 @@ public:
 		  model_(model),
 		  wft_(wft),
 		  lrs_(lrs),
-		  E0_(E0)
+		  E0_(E0),
+		  errorEstimate_(0.0)
 	{}
 
 	virtual void calcTimeVectors(const PairType& startEnd,
@@ -160,6 +161,7 @@ public:
 
 		// set non-zero sectors
 		for (SizeType i=0;i<times_.size();i++) targetVectors_[i] = phi;
+		errorEstimate_ = 0.0;
 
 		for (SizeType ii=0;ii<phi.sectors();ii++) {
 			SizeType i = phi.sector(ii);
@@ -167,6 +169,8 @@ public:
 		}
 	}
 
+	RealType errorEstimate() const { return errorEstimate_; }
+
 private:
 
 	class FunctionForRungeKutta {
@@ -231,6 +235,42 @@ private:
 		for (SizeType i=0;i<startEnd.second;i++) {
 			targetVectors_[i].setDataInSector(result[i],i0);
 		}
+
+		if (tstStruct_.errorTolerance() > 0)
+			updateErrorEstimate(f,epsForRK,result);
+	}
+
+	// Step doubling: redo the last two steps as a single one of size 2*eps;
+	// for a fourth order method the error of the fine solution is about
+	// |y_{2eps} - y_{eps}|/15
+	void updateErrorEstimate(const FunctionForRungeKutta& f,
+	                         RealType epsForRK,
+	                         const typename PsimagLite::Vector<TargetVectorType>::Type& result)
+	{
+		SizeType n = result.size();
+		if (n < 3) return;
+
+		PsimagLite::RungeKutta<RealType,FunctionForRungeKutta,TargetVectorType>
+		        rungeKutta2(f,2.0*epsForRK);
+
+		typename PsimagLite::Vector<TargetVectorType>::Type result2;
+		rungeKutta2.solve(result2,0.0,2,result[n-3]);
+		assert(result2.size() == 2);
+
+		const TargetVectorType& fine = result[n-1];
+		const TargetVectorType& coarse = result2[1];
+		RealType diff = 0.0;
+		RealType sum = 0.0;
+		for (SizeType i = 0; i < fine.size(); ++i) {
+			RealType a = std::abs(fine[i] - coarse[i]);
+			RealType b = std::abs(fine[i]);
+			diff += a*a;
+			sum += b*b;
+		}
+
+		if (sum < 1e-20) return;
+		RealType e = sqrt(diff/sum)/15.0;
+		if (e > errorEstimate_) errorEstimate_ = e;
 	}
 
 	PsimagLite::ProgressIndicator progress_;
@@ -242,6 +282,7 @@ private:
 	const WaveFunctionTransfType& wft_;
 	const LeftRightSuperType& lrs_;
 	RealType E0_;
+	RealType errorEstimate_;
 }; //class TimeVectorsRungeKutta
 } // namespace Dmrg
 /*@}*/
@@ -78,11 +78,16 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #ifndef TIME_VECTORS_SUZUKI_TROTTER
 #define TIME_VECTORS_SUZUKI_TROTTER
 #include <iostream>
+#include <algorithm>
 #include "TimeVectorsBase.h"
 #include "VectorWithOffsets.h"
 #include "MatrixOrIdentity.h"
 #include "Sort.h"
 #include "Utils.h"
+#include "Map.h"
+#include "BLAS.h"
+#include "Concurrency.h"
+#include "ThreadPool.h"
 
 namespace Dmrg {
 
@@ -123,6 +128,61 @@ class TimeVectorsSuzukiTrotter : public  TimeVectorsBase<
 	VectorVectorWithOffsetType;
 	typedef typename ModelType::HilbertBasisType HilbertBasisType;
 	typedef typename ModelType::HilbertBasisType::value_type HilbertStateType;
+	typedef typename PsimagLite::Vector<TargetVectorType>::Type VectorVectorType;
+
+	class MyLoop {
+
+	public:
+
+		MyLoop(const TimeVectorsSuzukiTrotter& tv,
+		       const VectorWithOffsetType& phi,
+		       bool expandSystem,
+		       SizeType hilbertSize,
+		       const MatrixComplexOrRealType& gate,
+		       const SparseMatrixType& transform,
+		       const SparseMatrixType& transformT,
+		       VectorVectorType& results)
+		    : tv_(tv),
+		      phi_(phi),
+		      expandSystem_(expandSystem),
+		      hilbertSize_(hilbertSize),
+		      gate_(gate),
+		      transform_(transform),
+		      transformT_(transformT),
+		      results_(results)
+		{
+			results_.resize(phi_.sectors());
+		}
+
+		SizeType tasks() const { return phi_.sectors(); }
+
+		void doTask(SizeType taskNumber, SizeType)
+		{
+			SizeType i0 = phi_.sector(taskNumber);
+			TargetVectorType& result = results_[taskNumber];
+			result.resize(phi_.effectiveSize(i0));
+			std::fill(result.begin(),result.end(),0.0);
+			tv_.timeVectorSector(result,
+			                     phi_,
+			                     i0,
+			                     expandSystem_,
+			                     hilbertSize_,
+			                     gate_,
+			                     transform_,
+			                     transformT_);
+		}
+
+	private:
+
+		const TimeVectorsSuzukiTrotter& tv_;
+		const VectorWithOffsetType& phi_;
+		bool expandSystem_;
+		SizeType hilbertSize_;
+		const MatrixComplexOrRealType& gate_;
+		const SparseMatrixType& transform_;
+		const SparseMatrixType& transformT_;
+		VectorVectorType& results_;
+	}; // class MyLoop
 
 public:
 
@@ -291,7 +351,7 @@ private:
 	}
 
 	void calcTargetVector(VectorWithOffsetType& target,
-	                      RealType Eg,
+	                      RealType,
 	                      const VectorWithOffsetType& phi,
 	                      SizeType systemOrEnviron,
 	                      const RealType& time,
@@ -300,44 +360,6 @@ private:
 	                      const SparseMatrixType& E,
 	                      const SparseMatrixType& ET)
 	{
-		for (SizeType ii=0;ii<phi.sectors();ii++) {
-			SizeType i0 = phi.sector(ii);
-			SizeType total = phi.effectiveSize(i0);
-			TargetVectorType result(total,0.0);
-			calcTimeVectorsSuzukiTrotter(result,
-			                             Eg,
-			                             phi,
-			                             systemOrEnviron,
-			                             i0,
-			                             time,
-			                             S,
-			                             ST,
-			                             E,
-			                             ET);
-			//NOTE: targetVectors_[0] = exp(iHt) |phi>
-			target.setDataInSector(result,i0);
-		}
-	}
-
-	void calcTimeVectorsSuzukiTrotter(TargetVectorType& result,
-	                                  RealType,
-	                                  const VectorWithOffsetType& phi,
-	                                  SizeType systemOrEnviron,
-	                                  SizeType i0,
-	                                  const RealType& time,
-	                                  const SparseMatrixType& transformS,
-	                                  const SparseMatrixType& transformST,
-	                                  const SparseMatrixType& transformE,
-	                                  const SparseMatrixType& transformET) const
-	{
-		SizeType offset = phi.offset(i0);
-		TargetVectorType phi0(result.size());
-		phi.extract(phi0,i0);
-
-		// NOTE: result =  exp(iHt) |phi0>
-		SizeType ns = lrs_.left().size();
-		PackIndicesType packSuper(ns);
-
 		VectorSizeType block;
 		calcBlock(block);
 
@@ -346,163 +368,162 @@ private:
 
 		VectorSizeType iperm;
 		suzukiTrotterPerm(iperm,block);
-		for (SizeType i=0;i<phi0.size();i++) {
-			SizeType xp=0,yp=0;
-			packSuper.unpack(xp,yp,lrs_.super().permutation(i+offset));
-			if (systemOrEnviron==ProgramGlobals::EXPAND_SYSTEM) {
-				timeVectorSystem(result,
-				                 phi0,
-				                 xp,
-				                 yp,
-				                 packSuper,
-				                 block,
-				                 m,
-				                 i,
-				                 offset,
-				                 transformE,
-				                 transformET,
-				                 iperm);
-			} else {
-				timeVectorEnviron(result,
-				                  phi0,
-				                  xp,
-				                  yp,
-				                  packSuper,
-				                  block,
-				                  m,
-				                  i,
-				                  offset,
-				                  transformS,
-				                  transformST,
-				                  iperm);
+
+		MatrixComplexOrRealType gate(iperm.size(),iperm.size());
+		setGate(gate,m,iperm);
+
+		bool expandSystem = (systemOrEnviron==ProgramGlobals::EXPAND_SYSTEM);
+		VectorVectorType results;
+		MyLoop helper(*this,
+		              phi,
+		              expandSystem,
+		              model_.hilbertSize(block[0]),
+		              gate,
+		              (expandSystem) ? E : S,
+		              (expandSystem) ? ET : ST,
+		              results);
+		// results are not gathered, so split the sectors among threads only
+		typedef ParallelizerThreads<MyLoop> ParallelizerType;
+		ParallelizerType threadObject(PsimagLite::Concurrency::npthreads);
+		threadObject.loopCreate(helper);
+
+		//NOTE: targetVectors_[0] = exp(iHt) |phi>
+		for (SizeType ii=0;ii<phi.sectors();ii++)
+			target.setDataInSector(results[ii],phi.sector(ii));
+	}
+
+	// gate(x2+y1*h,x2p+y1p*h) = m(iperm[x2+y1*h],iperm[x2p+y1p*h])
+	void setGate(MatrixComplexOrRealType& gate,
+	             const MatrixComplexOrRealType& m,
+	             const VectorSizeType& iperm) const
+	{
+		SizeType h2 = iperm.size();
+		for (SizeType b=0;b<h2;b++) {
+			for (SizeType a=0;a<h2;a++) {
+				ComplexOrRealType tmp = m(iperm[a],iperm[b]);
+				gate(a,b) = (PsimagLite::norm(tmp)<1e-12) ? 0.0 : tmp;
 			}
 		}
 	}
 
-	void timeVectorSystem(TargetVectorType& result,
-	                      const TargetVectorType& phi0,
-	                      SizeType xp,
-	                      SizeType yp,
-	                      const PackIndicesType& packSuper,
-	                      const BlockType& block,
-	                      const MatrixComplexOrRealType& m,
-	                      SizeType i,
-	                      SizeType offset,
+	// NOTE: result =  exp(iHt) |phi0> for sector i0
+	// The vector is first expanded with transformT on the side that is
+	// not growing, and stored as a (h*h) x (x1,y2) matrix, with one column
+	// per pair of indices not touched by the gate.
+	// Then the gate is applied to all columns with one GEMM, and the
+	// result is contracted back with transform
+	void timeVectorSector(TargetVectorType& result,
+	                      const VectorWithOffsetType& phi,
+	                      SizeType i0,
+	                      bool expandSystem,
+	                      SizeType hilbertSize,
+	                      const MatrixComplexOrRealType& gate,
 	                      const SparseMatrixType& transform,
-	                      const SparseMatrixType& transformT,
-	                      const VectorSizeType& iperm) const
+	                      const SparseMatrixType& transformT) const
 	{
-		const LeftRightSuperType& oldLrs = lrs_;
-		SizeType hilbertSize = model_.hilbertSize(block[0]);
+		SizeType offset = phi.offset(i0);
+		TargetVectorType phi0(result.size());
+		phi.extract(phi0,i0);
+
 		SizeType ns = lrs_.left().size();
-		SizeType nx = ns/hilbertSize;
+		PackIndicesType packSuper(ns);
+		SizeType nsFull = (expandSystem) ? ns : lrs_.left().permutationInverse().size();
+		SizeType nx = nsFull/hilbertSize;
 		PackIndicesType packLeft(nx);
 		PackIndicesType packRight(hilbertSize);
+		SizeType h2 = hilbertSize*hilbertSize;
 
 		if (!twoSiteDmrg_) {
-			assert(transform.cols()==lrs_.right().size());
-			assert(transform.rows()==oldLrs.right().permutationInverse().size());
+			const BasisWithOperatorsType& basis = (expandSystem) ? lrs_.right() :
+			                                                       lrs_.left();
+			assert(transform.cols()==basis.size());
+			assert(transform.rows()==basis.permutationInverse().size());
 		}
 
 		MatrixOrIdentityType transformT1(!twoSiteDmrg_,transformT);
 		MatrixOrIdentityType transform1(!twoSiteDmrg_,transform);
-		for (SizeType k=transformT1.getRowPtr(yp);k<transformT1.getRowPtr(yp+1);k++) {
-			SizeType x1=0,x2p=0;
-			packLeft.unpack(x1,x2p,lrs_.left().permutation(xp));
-			int yfull = transformT1.getColOrExit(k);
-			if (yfull<0) yfull = yp;
-			SizeType y1p=0,y2=0;
-			packRight.unpack(y1p,y2,oldLrs.right().permutation(yfull));
-			for (SizeType x2=0;x2<hilbertSize;x2++) {
-				for (SizeType y1=0;y1<hilbertSize;y1++) {
-					SizeType yfull2 = packRight.pack(y1,
-					                                 y2,
-					                                 oldLrs.right().permutationInverse());
-					for (SizeType k2=transform1.getRowPtr(yfull2);
-					     k2<transform1.getRowPtr(yfull2+1);
-					     k2++) {
-						int y = transform1.getColOrExit(k2);
-						if (y<0) y = yfull2;
-						SizeType x = packLeft.pack(x1,
-						                           x2,
-						                           lrs_.left().permutationInverse());
-						SizeType j = packSuper.pack(x,
-						                            y,
-						                            lrs_.super().permutationInverse());
-						ComplexOrRealType tmp = m(iperm[x2+y1*hilbertSize],
-						        iperm[x2p+y1p*hilbertSize]);
-						if (PsimagLite::norm(tmp)<1e-12) continue;
-						if (j<offset || j >= offset+phi0.size())
-							throw PsimagLite::RuntimeError("j out of bounds\n");
-						result[j-offset] += tmp*phi0[i]*transformT1.getValue(k)*
-						        transform1.getValue(k2);
-					}
-				}
-			}
-		}
-	}
 
-	void timeVectorEnviron(TargetVectorType& result,
-	                       const TargetVectorType& phi0,
-	                       SizeType xp,
-	                       SizeType yp,
-	                       const PackIndicesType& packSuper,
-	                       const BlockType& block,
-	                       const MatrixComplexOrRealType& m,
-	                       SizeType i,
-	                       SizeType offset,
-	                       const SparseMatrixType& transform,
-	                       const SparseMatrixType& transformT,
-	                       const VectorSizeType& iperm) const
-	{
-		const LeftRightSuperType& oldLrs = lrs_;
-		SizeType hilbertSize = model_.hilbertSize(block[0]);
-		SizeType ns = oldLrs.left().permutationInverse().size();
-		SizeType nx = ns/hilbertSize;
-		PackIndicesType packLeft(nx);
-		PackIndicesType packRight(hilbertSize);
+		PsimagLite::Map<SizeType,SizeType>::Type columnOf;
+		VectorSizeType x1s;
+		VectorSizeType y2s;
+		TargetVectorType phi1;
 
-		if (!twoSiteDmrg_) {
-			assert(transform.cols()==lrs_.left().size());
-			assert(transform.rows()==oldLrs.left().permutationInverse().size());
-		}
+		for (SizeType i=0;i<phi0.size();i++) {
+			if (phi0[i]==static_cast<ComplexOrRealType>(0.0)) continue;
+			SizeType xp=0,yp=0;
+			packSuper.unpack(xp,yp,lrs_.super().permutation(i+offset));
+			SizeType row = (expandSystem) ? yp : xp;
+			for (SizeType k=transformT1.getRowPtr(row);k<transformT1.getRowPtr(row+1);k++) {
+				int full = transformT1.getColOrExit(k);
+				if (full<0) full = row;
+				SizeType x1=0,x2p=0,y1p=0,y2=0;
+				packLeft.unpack(x1,x2p,lrs_.left().permutation((expandSystem) ? xp : full));
+				packRight.unpack(y1p,y2,lrs_.right().permutation((expandSystem) ? full : yp));
+				assert(x2p<hilbertSize && y1p<hilbertSize);
+
+				SizeType key = x1 + y2*nx;
+				PsimagLite::Map<SizeType,SizeType>::Type::const_iterator it =
+				        columnOf.find(key);
+				SizeType c = 0;
+				if (it == columnOf.end()) {
+					c = x1s.size();
+					columnOf[key] = c;
+					x1s.push_back(x1);
+					y2s.push_back(y2);
+					phi1.resize(phi1.size() + h2,0.0);
+				} else {
+					c = it->second;
+				}
 
-		MatrixOrIdentityType transformT1(!twoSiteDmrg_,transformT);
-		MatrixOrIdentityType transform1(!twoSiteDmrg_,transform);
+				phi1[x2p + y1p*hilbertSize + c*h2] += phi0[i]*transformT1.getValue(k);
+			}
+		}
 
-		for (SizeType k=transformT1.getRowPtr(xp);k<transformT1.getRowPtr(xp+1);k++) {
-			int xfull = transformT1.getColOrExit(k);
-			if (xfull<0) xfull = xp;
-			SizeType x1=0,x2p=0;
-			packLeft.unpack(x1,x2p,oldLrs.left().permutation(xfull));
-			assert(x2p<hilbertSize);
-			SizeType y1p=0,y2=0;
-			packRight.unpack(y1p,y2,lrs_.right().permutation(yp));
-			for (SizeType x2=0;x2<hilbertSize;x2++) {
-				for (SizeType y1=0;y1<hilbertSize;y1++) {
-					SizeType xfull2 = packLeft.pack(x1,
-					                                x2,
-					                                oldLrs.left().permutationInverse());
-					for (SizeType k2=transform1.getRowPtr(xfull2);
-					     k2<transform1.getRowPtr(xfull2+1);
+		SizeType cols = x1s.size();
+		if (cols==0) return;
+
+		TargetVectorType phi2(phi1.size());
+		ComplexOrRealType one = 1.0;
+		ComplexOrRealType zero = 0.0;
+		psimag::BLAS::GEMM('N',
+		                   'N',
+		                   h2,
+		                   cols,
+		                   h2,
+		                   one,
+		                   &(gate(0,0)),
+		                   h2,
+		                   &(phi1[0]),
+		                   h2,
+		                   zero,
+		                   &(phi2[0]),
+		                   h2);
+
+		for (SizeType c=0;c<cols;c++) {
+			for (SizeType y1=0;y1<hilbertSize;y1++) {
+				for (SizeType x2=0;x2<hilbertSize;x2++) {
+					ComplexOrRealType val = phi2[x2 + y1*hilbertSize + c*h2];
+					if (val==static_cast<ComplexOrRealType>(0.0)) continue;
+					SizeType xOrFull = packLeft.pack(x1s[c],
+					                                 x2,
+					                                 lrs_.left().permutationInverse());
+					SizeType yOrFull = packRight.pack(y1,
+					                                  y2s[c],
+					                                  lrs_.right().permutationInverse());
+					SizeType row = (expandSystem) ? yOrFull : xOrFull;
+					for (SizeType k2=transform1.getRowPtr(row);
+					     k2<transform1.getRowPtr(row+1);
 					     k2++) {
-						int x = transform1.getColOrExit(k2);
-						if (x<0) x = xfull2;
-						SizeType y = packRight.pack(y1,
-						                            y2,
-						                            lrs_.right().permutationInverse());
+						int z = transform1.getColOrExit(k2);
+						if (z<0) z = row;
+						SizeType x = (expandSystem) ? xOrFull : z;
+						SizeType y = (expandSystem) ? z : yOrFull;
 						SizeType j = packSuper.pack(x,
 						                            y,
 						                            lrs_.super().permutationInverse());
-
-						ComplexOrRealType tmp = m(iperm[x2+y1*hilbertSize],
-						        iperm[x2p+y1p*hilbertSize]);
-						if (PsimagLite::norm(tmp)<1e-12) continue;
-						if (j < offset || j >= offset+phi0.size())
-							throw PsimagLite::RuntimeError("j out of bounds (environ)\n");
-
-						result[j-offset] += tmp*phi0[i]*transformT1.getValue(k)*
-						        transform1.getValue(k2);
+						if (j<offset || j >= offset+phi0.size())
+							throw PsimagLite::RuntimeError("j out of bounds\n");
+						result[j-offset] += val*transform1.getValue(k2);
 					}
 				}
 			}
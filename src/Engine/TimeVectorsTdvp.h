@@ -0,0 +1,509 @@
+/*
+Copyright (c) 2009-2018, UT-Battelle, LLC
+All rights reserved
+
+[DMRG++, Version 3.0]
+[by G.A., Oak Ridge National Laboratory]
+
+UT Battelle Open Source Software License 11242008
+
+OPEN SOURCE LICENSE
+
+Subject to the conditions of this License, each
+contributor to this software hereby grants, free of
+charge, to any person obtaining a copy of this software
+and associated documentation files (the "Software"), a
+perpetual, worldwide, non-exclusive, no-charge,
+royalty-free, irrevocable copyright license to use, copy,
+modify, merge, publish, distribute, and/or sublicense
+copies of the Software.
+
+1. Redistributions of Software must retain the above
+copyright and license notices, this list of conditions,
+and the following disclaimer.  Changes or modifications
+to, or derivative works of, the Software should be noted
+with comments and the contributor and organization's
+name.
+
+2. Neither the names of UT-Battelle, LLC or the
+Department of Energy nor the names of the Software
+contributors may be used to endorse or promote products
+derived from this software without specific prior written
+permission of UT-Battelle.
+
+3. The software and the end-user documentation included
+with the redistribution, with or without modification,
+must include the following acknowledgment:
+
+"This product includes software produced by UT-Battelle,
+LLC under Contract No. DE-AC05-00OR22725  with the
+Department of Energy."
+
+*********************************************************
+DISCLAIMER
+
+THE SOFTWARE IS SUPPLIED BY THE COPYRIGHT HOLDERS AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+COPYRIGHT OWNER, CONTRIBUTORS, UNITED STATES GOVERNMENT,
+OR THE UNITED STATES DEPARTMENT OF ENERGY BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+DAMAGE.
+
+NEITHER THE UNITED STATES GOVERNMENT, NOR THE UNITED
+STATES DEPARTMENT OF ENERGY, NOR THE COPYRIGHT OWNER, NOR
+ANY OF THEIR EMPLOYEES, REPRESENTS THAT THE USE OF ANY
+INFORMATION, DATA, APPARATUS, PRODUCT, OR PROCESS
+DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
+
+*********************************************************
+*/
+/** \ingroup DMRG */
+/*@{*/
+
+/*! \file TimeVectorsTdvp.h
+ *
+ *  Time evolution of a single target vector with the two-site
+ *  time-dependent variational principle (projector splitting),
+ *  see Haegeman et al., PRB 94, 165116 (2016).
+ *
+ *  At each finite step the superblock state is evolved forward
+ *  with exp(-iH tau) in the Krylov space of the superblock
+ *  Hamiltonian. Before that, the bond (one-site) part of the step
+ *  that truncated the previous superblock is undone with exp(+iPHP tau),
+ *  where P projects onto the states reachable by the last wft.
+ *  A half sweep therefore evolves the state by tau.
+ *  The state evolves only in the steps that the clock of
+ *  ApplyOperatorExpression counts, that is, once the left corner has
+ *  been seen, so that the time it reports is that of the state.
+ */
+
+#ifndef TIME_VECTORS_TDVP
+#define TIME_VECTORS_TDVP
+#include <iostream>
+#include <vector>
+#include "TimeVectorsBase.h"
+#include "ProgramGlobals.h"
+#include "TypeToString.h"
+
+namespace Dmrg {
+
+template<typename TargetParamsType,
+         typename ModelType,
+         typename WaveFunctionTransfType,
+         typename LanczosSolverType,
+         typename VectorWithOffsetType>
+class TimeVectorsTdvp : public  TimeVectorsBase<
+        TargetParamsType,
+        ModelType,
+        WaveFunctionTransfType,
+        LanczosSolverType,
+        VectorWithOffsetType> {
+
+	typedef TimeVectorsBase<TargetParamsType,
+	ModelType,
+	WaveFunctionTransfType,
+	LanczosSolverType,
+	VectorWithOffsetType> BaseType;
+	typedef typename BaseType::PairType PairType;
+	typedef typename TargetParamsType::RealType RealType;
+	typedef typename PsimagLite::Vector<RealType>::Type VectorRealType;
+	typedef typename ModelType::ModelHelperType ModelHelperType;
+	typedef typename ModelHelperType::LeftRightSuperType LeftRightSuperType;
+	typedef typename LeftRightSuperType::BasisWithOperatorsType
+	BasisWithOperatorsType;
+	typedef typename BasisWithOperatorsType::SparseMatrixType SparseMatrixType;
+	typedef typename SparseMatrixType::value_type ComplexOrRealType;
+	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixComplexOrRealType;
+	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type TargetVectorType;
+	typedef typename PsimagLite::Vector<TargetVectorType>::Type VectorTargetVectorType;
+	typedef typename LanczosSolverType::LanczosMatrixType LanczosMatrixType;
+	typedef typename LanczosSolverType::ParametersSolverType ParametersSolverType;
+	typedef typename ModelType::InputValidatorType InputValidatorType;
+	typedef typename PsimagLite::Vector<VectorWithOffsetType>::Type
+	VectorVectorWithOffsetType;
+	typedef PsimagLite::Vector<SizeType>::Type VectorSizeType;
+
+	// Projector onto the span of the last wft: the superblock index of
+	// each state is split, exactly as ParallelWftOne does, into a spectator
+	// index and the row of the transformation that the wft expanded
+	class BondProjector {
+
+	public:
+
+		BondProjector(const LeftRightSuperType& lrs,
+		              const WaveFunctionTransfType& wft,
+		              SizeType direction,
+		              SizeType offset,
+		              SizeType total,
+		              SizeType volumeOfNk)
+		    : isValid_(false),
+		      nSpectator_(0),
+		      spectator_(total),
+		      row_(total)
+		{
+			if (!wft.isEnabled() || volumeOfNk == 0) return;
+
+			const LeftRightSuperType& lrsOld = wft.lrs();
+			SizeType nLeft = lrs.left().permutationInverse().size();
+			SizeType nRight = lrs.right().permutationInverse().size();
+
+			if (direction == ProgramGlobals::EXPAND_SYSTEM) {
+				wft.transform(ProgramGlobals::ENVIRON).toSparse(w_);
+				SizeType nRightOld = lrsOld.right().permutationInverse().size();
+				if (w_.rows() != nRightOld || nRightOld != nRight*volumeOfNk) return;
+				if (nLeft%volumeOfNk != 0) return;
+				nSpectator_ = nLeft/volumeOfNk;
+				for (SizeType t = 0; t < total; ++t) {
+					SizeType perm = lrs.super().permutation(t + offset);
+					SizeType alpha = perm%nLeft;
+					SizeType jp = perm/nLeft;
+					SizeType lp = lrs.left().permutation(alpha);
+					SizeType ip = lp%nSpectator_;
+					SizeType kp = lp/nSpectator_;
+					spectator_[t] = ip;
+					row_[t] = lrsOld.right().permutationInverse(kp + jp*volumeOfNk);
+				}
+			} else if (direction == ProgramGlobals::EXPAND_ENVIRON) {
+				wft.transform(ProgramGlobals::SYSTEM).toSparse(w_);
+				SizeType nLeftOld = lrsOld.left().permutationInverse().size();
+				if (w_.rows() != nLeftOld || nLeftOld != nLeft*volumeOfNk) return;
+				if (nRight%volumeOfNk != 0) return;
+				nSpectator_ = nRight/volumeOfNk;
+				for (SizeType t = 0; t < total; ++t) {
+					SizeType perm = lrs.super().permutation(t + offset);
+					SizeType ip = perm%nLeft;
+					SizeType beta = perm/nLeft;
+					SizeType rp = lrs.right().permutation(beta);
+					SizeType kp = rp%volumeOfNk;
+					SizeType jp = rp/volumeOfNk;
+					spectator_[t] = jp;
+					row_[t] = lrsOld.left().permutationInverse(ip + kp*nLeft);
+				}
+			} else {
+				return;
+			}
+
+			isValid_ = true;
+		}
+
+		// v <-- W W^\dagger v
+		void project(TargetVectorType& v) const
+		{
+			assert(isValid_);
+			assert(v.size() == row_.size());
+			MatrixComplexOrRealType bond(nSpectator_,w_.cols());
+			for (SizeType t = 0; t < v.size(); ++t) {
+				SizeType s = spectator_[t];
+				SizeType r = row_[t];
+				for (int k = w_.getRowPtr(r); k < w_.getRowPtr(r+1); ++k)
+					bond(s,w_.getCol(k)) += PsimagLite::conj(w_.getValue(k))*v[t];
+			}
+
+			for (SizeType t = 0; t < v.size(); ++t) {
+				SizeType s = spectator_[t];
+				SizeType r = row_[t];
+				ComplexOrRealType sum = 0.0;
+				for (int k = w_.getRowPtr(r); k < w_.getRowPtr(r+1); ++k)
+					sum += w_.getValue(k)*bond(s,w_.getCol(k));
+				v[t] = sum;
+			}
+		}
+
+		// The bond step only makes sense if v came out of the wft
+		bool contains(const TargetVectorType& v) const
+		{
+			if (!isValid_) return false;
+			TargetVectorType pv = v;
+			project(pv);
+			RealType diff = 0.0;
+			RealType sum = 0.0;
+			for (SizeType t = 0; t < v.size(); ++t) {
+				RealType a = std::abs(pv[t] - v[t]);
+				RealType b = std::abs(v[t]);
+				diff += a*a;
+				sum += b*b;
+			}
+
+			return (sum > 0 && diff <= 1e-12*sum);
+		}
+
+	private:
+
+		bool isValid_;
+		SizeType nSpectator_;
+		VectorSizeType spectator_;
+		VectorSizeType row_;
+		SparseMatrixType w_;
+	}; // class BondProjector
+
+	// PHP for the backward bond evolution
+	class ProjectedMatrix {
+
+	public:
+
+		ProjectedMatrix(const LanczosMatrixType& h, const BondProjector& projector)
+		    : h_(h), projector_(projector)
+		{}
+
+		void matrixVectorProduct(TargetVectorType& x, const TargetVectorType& y) const
+		{
+			TargetVectorType tmp = y;
+			projector_.project(tmp);
+			h_.matrixVectorProduct(x,tmp);
+			projector_.project(x);
+		}
+
+	private:
+
+		const LanczosMatrixType& h_;
+		const BondProjector& projector_;
+	}; // class ProjectedMatrix
+
+public:
+
+	TimeVectorsTdvp(const RealType& currentTime,
+	                const TargetParamsType& tstStruct,
+	                const VectorRealType& times,
+	                VectorVectorWithOffsetType& targetVectors,
+	                const ModelType& model,
+	                const WaveFunctionTransfType& wft,
+	                const LeftRightSuperType& lrs,
+	                const RealType& E0,
+	                InputValidatorType& ioIn,
+	                const bool& clockRunning)
+	    : progress_("TimeVectorsTdvp"),
+	      currentTime_(currentTime),
+	      tstStruct_(tstStruct),
+	      times_(times),
+	      targetVectors_(targetVectors),
+	      model_(model),
+	      wft_(wft),
+	      lrs_(lrs),
+	      E0_(E0),
+	      ioIn_(ioIn),
+	      params_(ioIn,"Tridiag"),
+	      clockRunning_(clockRunning),
+	      clockWasRunning_(false),
+	      errorEstimate_(0.0)
+	{
+		// time advances once per half sweep, and so does the state
+		SizeType sitesPerBlock = model_.params().sitesPerBlock;
+		SizeType sites = model_.geometry().numberOfSites();
+		SizeType halfSweep = (sites > 2*sitesPerBlock) ?
+		            (sites - 2*sitesPerBlock)/sitesPerBlock : 0;
+		if (tstStruct_.advanceEach() != halfSweep) {
+			PsimagLite::String str("TimeVectorsTdvp: TSPAdvanceEach must be ");
+			str += ttos(halfSweep) + ", the number of finite steps in a half sweep\n";
+			throw PsimagLite::RuntimeError(str);
+		}
+	}
+
+	virtual void calcTimeVectors(const PairType&,
+	                             RealType,
+	                             const VectorWithOffsetType& phi,
+	                             SizeType systemOrEnviron,
+	                             bool allOperatorsApplied,
+	                             const PsimagLite::Vector<SizeType>::Type& block)
+	{
+		assert(0 < targetVectors_.size());
+		targetVectors_[0] = phi;
+		errorEstimate_ = 0.0;
+
+		// the clock starts counting with the step after the one that
+		// first sees the left corner, which this call follows
+		bool clockCounts = clockWasRunning_;
+		clockWasRunning_ = clockRunning_;
+		if (!clockCounts) return;
+
+		RealType tau = tstStruct_.tau();
+		if (!allOperatorsApplied || tau == 0) return;
+		if (norm(phi) < 1e-10) return;
+
+		assert(block.size() > 0);
+		SizeType volumeOfNk = model_.hilbertSize(block[0]);
+		SizeType bondSteps = 0;
+		for (SizeType ii = 0; ii < phi.sectors(); ++ii) {
+			SizeType i0 = phi.sector(ii);
+			TargetVectorType r;
+			bondSteps += evolveSector(r,phi,i0,systemOrEnviron,volumeOfNk,tau);
+			targetVectors_[0].setDataInSector(r,i0);
+		}
+
+		PsimagLite::OstringStream msg;
+		msg<<"using TDVP, tau="<<tau<<" sectors="<<phi.sectors();
+		msg<<" with bond step="<<bondSteps<<" error estimate="<<errorEstimate_;
+		progress_.printline(msg,std::cout);
+	}
+
+	RealType errorEstimate() const { return errorEstimate_; }
+
+private:
+
+	SizeType evolveSector(TargetVectorType& r,
+	                      const VectorWithOffsetType& phi,
+	                      SizeType i0,
+	                      SizeType systemOrEnviron,
+	                      SizeType volumeOfNk,
+	                      RealType tau)
+	{
+		SizeType total = phi.effectiveSize(i0);
+		TargetVectorType phi0(total);
+		phi.extract(phi0,i0);
+
+		SizeType p = lrs_.super().findPartitionNumber(phi.offset(i0));
+		ModelHelperType modelHelper(p,lrs_,currentTime_,0);
+		LanczosMatrixType lanczosHelper(&model_,&modelHelper);
+
+		SizeType bondSteps = 0;
+		BondProjector projector(lrs_,
+		                        wft_,
+		                        systemOrEnviron,
+		                        phi.offset(i0),
+		                        total,
+		                        volumeOfNk);
+		if (projector.contains(phi0)) {
+			ProjectedMatrix bondMatrix(lanczosHelper,projector);
+			krylovExp(r,phi0,bondMatrix,-tau);
+			phi0.swap(r);
+			bondSteps = 1;
+		}
+
+		RealType e = krylovExp(r,phi0,lanczosHelper,tau);
+		if (e > errorEstimate_) errorEstimate_ = e;
+		return bondSteps;
+	}
+
+	// r = exp(-i(H-E0)t) v computed in the Krylov space of v, which
+	// grows until the weight of its last vector in r, returned as an
+	// error estimate, is below the tolerance
+	template<typename SomeMatrixType>
+	RealType krylovExp(TargetVectorType& r,
+	                   const TargetVectorType& v,
+	                   const SomeMatrixType& h,
+	                   RealType t) const
+	{
+		SizeType n = v.size();
+		r.resize(n);
+		std::fill(r.begin(),r.end(),0.0);
+		RealType normV = vectorNorm(v);
+		if (normV < 1e-12) return 0.0;
+
+		SizeType maxSteps = std::min(params_.steps,n);
+		if (maxSteps == 0) maxSteps = 1;
+
+		VectorTargetVectorType krylov;
+		VectorRealType a;
+		VectorRealType b;
+		krylov.push_back(v);
+		for (SizeType i = 0; i < n; ++i) krylov[0][i] /= normV;
+
+		TargetVectorType w(n);
+		TargetVectorType c;
+		RealType error = 0.0;
+		for (SizeType j = 0; j < maxSteps; ++j) {
+			std::fill(w.begin(),w.end(),0.0);
+			h.matrixVectorProduct(w,krylov[j]);
+			a.push_back(PsimagLite::real(dot(krylov[j],w)));
+
+			// full reorthogonalization, the Krylov spaces here are small
+			for (SizeType k = 0; k <= j; ++k) {
+				ComplexOrRealType ck = dot(krylov[k],w);
+				for (SizeType i = 0; i < n; ++i) w[i] -= ck*krylov[k][i];
+			}
+
+			error = krylovCoefficients(c,a,b,normV,t);
+			RealType bj = vectorNorm(w);
+			if (j + 1 == maxSteps || bj < params_.tolerance) break;
+			if (j > 0 && error < params_.tolerance) break;
+			b.push_back(bj);
+			krylov.push_back(w);
+			for (SizeType i = 0; i < n; ++i) krylov[j+1][i] /= bj;
+		}
+
+		for (SizeType j = 0; j < c.size(); ++j)
+			for (SizeType i = 0; i < n; ++i)
+				r[i] += c[j]*krylov[j][i];
+
+		return error;
+	}
+
+	// c = normV exp(-i(T-E0)t) e_0, with T the tridiagonal matrix of a and b;
+	// returns the weight of the last component of c
+	RealType krylovCoefficients(TargetVectorType& c,
+	                            const VectorRealType& a,
+	                            const VectorRealType& b,
+	                            RealType normV,
+	                            RealType t) const
+	{
+		SizeType m = a.size();
+		MatrixComplexOrRealType T(m,m);
+		for (SizeType j = 0; j < m; ++j) {
+			T(j,j) = a[j];
+			if (j + 1 == m) continue;
+			T(j,j+1) = T(j+1,j) = b[j];
+		}
+
+		VectorRealType eigs(m);
+		PsimagLite::diag(T,eigs,'V');
+
+		RealType timeDirection = tstStruct_.timeDirection();
+		c.resize(m);
+		std::fill(c.begin(),c.end(),0.0);
+		for (SizeType k = 0; k < m; ++k) {
+			ComplexOrRealType phase = 0.0;
+			PsimagLite::expComplexOrReal(phase,-(eigs[k]-E0_)*t*timeDirection);
+			ComplexOrRealType f = phase*PsimagLite::conj(T(0,k))*normV;
+			for (SizeType j = 0; j < m; ++j) c[j] += T(j,k)*f;
+		}
+
+		RealType sum = vectorNorm(c);
+		return (sum > 0) ? std::abs(c[m-1])/sum : 0.0;
+	}
+
+	static ComplexOrRealType dot(const TargetVectorType& x, const TargetVectorType& y)
+	{
+		ComplexOrRealType sum = 0.0;
+		for (SizeType i = 0; i < x.size(); ++i)
+			sum += PsimagLite::conj(x[i])*y[i];
+		return sum;
+	}
+
+	static RealType vectorNorm(const TargetVectorType& x)
+	{
+		RealType sum = 0.0;
+		for (SizeType i = 0; i < x.size(); ++i) {
+			RealType a = std::abs(x[i]);
+			sum += a*a;
+		}
+
+		return sqrt(sum);
+	}
+
+	PsimagLite::ProgressIndicator progress_;
+	const RealType& currentTime_;
+	const TargetParamsType& tstStruct_;
+	const VectorRealType& times_;
+	VectorVectorWithOffsetType& targetVectors_;
+	const ModelType& model_;
+	const WaveFunctionTransfType& wft_;
+	const LeftRightSuperType& lrs_;
+	const RealType& E0_;
+	InputValidatorType& ioIn_;
+	ParametersSolverType params_;
+	const bool& clockRunning_;
+	bool clockWasRunning_;
+	RealType errorEstimate_;
+}; //class TimeVectorsTdvp
+} // namespace Dmrg
+/*@}*/
+#endif
@@ -116,7 +116,7 @@ public:
 	typedef typename CorrelationsSkeletonType::SparseMatrixType SparseMatrixType;
 	typedef typename ObserverHelperType::MatrixType MatrixType;
 	typedef Parallel2PointCorrelations<ThisType> Parallel2PointCorrelationsType;
-	typedef typename Parallel2PointCorrelationsType::PairType PairType;
+	typedef typename Parallel2PointCorrelationsType::VectorSizeType VectorSizeType;
 
 	TwoPointCorrelations(ObserverHelperType& helper,
 	                     CorrelationsSkeletonType& skeleton,
@@ -134,21 +134,22 @@ public:
 		SizeType rows = w.n_row();
 		SizeType cols = w.n_col();
 
-		typename PsimagLite::Vector<PairType>::Type pairs;
+		// row i computes the entries j=i,...,cols-1; its cost goes with
+		// their number, so rows are split by it and not by count
+		VectorSizeType rowsV(rows);
+		VectorSizeType weights(rows,1);
 		for (SizeType i=0;i<rows;i++) {
-			for (SizeType j=i;j<cols;j++) {
-				if (i>j) continue;
-				pairs.push_back(PairType(i,j));
-			}
+			rowsV[i] = i;
+			if (i < cols) weights[i] = cols - i;
 		}
 
 		typedef PsimagLite::Parallelizer<Parallel2PointCorrelationsType> ParallelizerType;
 		ParallelizerType threaded2Points(PsimagLite::Concurrency::npthreads,
 		                                 PsimagLite::MPI::COMM_WORLD);
 
-		Parallel2PointCorrelationsType helper2Points(w,*this,pairs,O1,O2,fermionicSign);
+		Parallel2PointCorrelationsType helper2Points(w,*this,rowsV,O1,O2,fermionicSign);
 
-		threaded2Points.loopCreate(helper2Points);
+		threaded2Points.loopCreate(helper2Points,weights);
 	}
 
 	// Return the vector: O1 * O2 |psi>
@@ -174,6 +175,54 @@ public:
 		return c;
 	}
 
+	// Row i of the matrix above, for j=i,...,w.n_col()-1
+	// O1 is grown once and then extended site by site as j increases,
+	// instead of being regrown from site i for each j
+	void calcCorrelationRow(PsimagLite::Matrix<FieldType>& w,
+	                        SizeType i,
+	                        const SparseMatrixType& O1,
+	                        const SparseMatrixType& O2,
+	                        int fermionicSign,
+	                        SizeType threadId)
+	{
+		SizeType cols = w.n_col();
+		if (i>=cols) return;
+
+		w(i,i) = calcDiagonalCorrelation(i,O1,O2,fermionicSign,threadId);
+
+		SparseMatrixType O1g,O2m;
+		skeleton_.createWithModification(O1g,O1,'n');
+		skeleton_.createWithModification(O2m,O2,'n');
+
+		int nt=i-1;
+		if (nt<0) nt=0;
+		SizeType grown = nt;
+		SizeType last = skeleton_.numberOfSites(threadId)-1;
+
+		for (SizeType j=i+1;j<cols;j++) {
+			if (j==last) {
+				if (i==j-1) {
+					w(i,j) = calcCorrelation_(i,j,O1,O2,fermionicSign,threadId);
+					continue;
+				}
+
+				skeleton_.growDirectlyFrom(O1g,i,fermionicSign,grown,j-2,true,threadId);
+				grown = j-2;
+				helper_.setPointer(threadId,j-2);
+				w(i,j) = skeleton_.bracketRightCorner(O1g,O2m,fermionicSign,threadId);
+				continue;
+			}
+
+			SizeType ns = j-1;
+			skeleton_.growDirectlyFrom(O1g,i,fermionicSign,grown,ns,true,threadId);
+			grown = ns;
+
+			SparseMatrixType O2g;
+			skeleton_.dmrgMultiply(O2g,O1g,O2m,fermionicSign,ns,threadId);
+			w(i,j) = skeleton_.bracket(O2g,fermionicSign,threadId);
+		}
+	}
+
 private:
 
 	SparseMatrixType add(const SparseMatrixType& O1,const SparseMatrixType& O2)
@@ -82,6 +82,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #define VECTOR_WITH_OFFSET_H
 #include "Vector.h"
 #include "ProgressIndicator.h"
+#include "BinaryStore.h"
 
 namespace Dmrg {
 template<typename ComplexOrRealType>
@@ -98,13 +99,23 @@ public:
 	static const ComplexOrRealType zero_;
 
 	VectorWithOffset()
-	    : progress_("VectorWithOffset"), size_(0), offset_(0), mAndq_(PairSizeType(0,0))
+	    : progress_("VectorWithOffset"),
+	      size_(0),
+	      view_(0),
+	      viewSize_(0),
+	      offset_(0),
+	      mAndq_(PairSizeType(0,0))
 	{}
 
 	template<typename SomeBasisType>
 	VectorWithOffset(const VectorSizeType& weights,
 	                 const SomeBasisType& someBasis)
-	    : progress_("VectorWithOffset"),size_(someBasis.size())
+	    : progress_("VectorWithOffset"),
+	      size_(someBasis.size()),
+	      view_(0),
+	      viewSize_(0),
+	      offset_(0),
+	      mAndq_(PairSizeType(0,0))
 	{
 		bool found = false;
 		for (SizeType i=0;i<weights.size();i++) {
@@ -129,6 +140,7 @@ public:
 	{
 		size_ = x;
 		data_.clear();
+		view_ = 0;
 		offset_=0;
 		mAndq_ = PairSizeType(0,0);
 	}
@@ -149,6 +161,7 @@ public:
 				}
 
 				data_ = v[i];
+				view_ = 0;
 				offset_ = someBasis.partition(i);
 				SizeType qn = someBasis.pseudoEffectiveNumber(offset_);
 				mAndq_ = PairSizeType(i, qn);
@@ -163,6 +176,7 @@ public:
 	void fromFull(const VectorType& v,const SomeBasisType& someBasis)
 	{
 		size_ = someBasis.size();
+		view_ = 0;
 		try {
 			SizeType m = findPartition(v,someBasis);
 			offset_ = someBasis.partition(m);
@@ -187,24 +201,25 @@ public:
 
 	SizeType offset(SizeType) const { return offset_; }
 
-	SizeType effectiveSize(SizeType) const { return data_.size(); }
+	SizeType effectiveSize(SizeType) const { return dataSize(); }
 
 	void setDataInSector(const VectorType& v,SizeType)
 	{
 		data_=v;
+		view_ = 0;
 	}
 
 	void extract(VectorType& v, SizeType = 0) const
 	{
-		v=data_;
+		v = dataVector(v);
 	}
 
 	template<typename SparseVectorType>
 	void toSparse(SparseVectorType& sv) const
 	{
 		sv.resize(size_);
-		for (SizeType i=0;i<data_.size();i++)
-			sv[i+offset_] = data_[i];
+		for (SizeType i=0;i<dataSize();i++)
+			sv[i+offset_] = at(i);
 	}
 
 	template<typename IoOutputter>
@@ -221,7 +236,8 @@ public:
 		io.printline(s);
 		s="#qn="+ttos(mAndq_.second);
 		io.printline(s);
-		io.printVector(data_,"#data");
+		VectorType buffer;
+		BinaryStore::printVector(io,dataVector(buffer),"#data");
 	}
 
 	template<typename IoInputter>
@@ -245,7 +261,7 @@ public:
 		if (y < 0)
 			throw PsimagLite::RuntimeError("VectorWithOffset::load(...): qn<0\n");
 		mAndq_ = PairSizeType(x, y);
-		io.read(data_,"#data");
+		view_ = BinaryStore::view(io,data_,viewSize_,"#data");
 	}
 
 	template<typename IoInputter>
@@ -278,6 +294,7 @@ public:
 		SizeType total = someBasis.partition(m+1) - offset_;
 		VectorType tmpV(total,0);
 		data_ = tmpV;
+		view_ = 0;
 
 		PsimagLite::OstringStream msg;
 		msg<<"populateFromQns succeeded";
@@ -288,7 +305,7 @@ public:
 
 	SizeType size() const { return size_; }
 
-	SizeType effectiveSize() const { return data_.size(); }
+	SizeType effectiveSize() const { return dataSize(); }
 
 	SizeType offset() const { return offset_; }
 
@@ -296,6 +313,8 @@ public:
 	{
 		if (size_ == 0 && offset_ == 0 && mAndq_.first == 0 && mAndq_.second == 0) {
 			data_ = v.data_;
+			view_ = v.view_;
+			viewSize_ = v.viewSize_;
 			size_ = v.size_;
 			offset_ = v.offset_;
 			mAndq_ = v.mAndq_;
@@ -305,19 +324,27 @@ public:
 		if (size_ != v.size_ || offset_ != v.offset_ || mAndq_ != v.mAndq_)
 			throw PsimagLite::RuntimeError("VectorWithOffset::operator+=\n");
 
-		data_ += v.data_;
+		own();
+		if (v.view_) {
+			assert(data_.size() == v.viewSize_);
+			for (SizeType i = 0; i < data_.size(); ++i)
+				data_[i] += v.view_[i];
+		} else {
+			data_ += v.data_;
+		}
 
 		return *this;
 	}
 
 	const ComplexOrRealType& slowAccess(SizeType i) const
 	{
-		assert(i>=offset_ && i<(offset_+data_.size()));
-		return data_[i-offset_];
+		assert(i>=offset_ && i<(offset_+dataSize()));
+		return at(i-offset_);
 	}
 
 	ComplexOrRealType& slowAccess(SizeType i)
 	{
+		own();
 		assert(i >= offset_);
 		assert(i-offset_ < data_.size());
 		return data_[i-offset_];
@@ -325,43 +352,74 @@ public:
 
 	const ComplexOrRealType& fastAccess(SizeType,SizeType j) const
 	{
-		assert(j<data_.size());
-		return data_[j];
+		assert(j<dataSize());
+		return at(j);
 	}
 
 	ComplexOrRealType& fastAccess(SizeType,SizeType j)
 	{
+		own();
 		assert(j<data_.size());
 		return data_[j];
 	}
 
 	int index2Sector(SizeType i) const
 	{
-		return ((i < offset_) || (i >= (offset_+data_.size()))) ? (-1) : (0);
+		return ((i < offset_) || (i >= (offset_+dataSize()))) ? (-1) : (0);
 	}
 
 	friend ComplexOrRealType operator*(const VectorWithOffset& v1,
 	                                   const VectorWithOffset& v2)
 	{
 		if (v1.mAndq_ != v2.mAndq_) return 0.0;
-		return (v1.data_ * v2.data_);
+		VectorType buffer1;
+		VectorType buffer2;
+		return (v1.dataVector(buffer1) * v2.dataVector(buffer2));
 	}
 
 	friend VectorWithOffset<ComplexOrRealType> operator*(const ComplexOrRealType& value,
 	                                                     const VectorWithOffset& v)
 	{
 		VectorWithOffset w = v;
+		w.own();
 		w.data_ *= value;
 		return w;
 	}
 
 	friend RealType norm(const VectorWithOffset& v)
 	{
-		return PsimagLite::norm(v.data_);
+		VectorType buffer;
+		return PsimagLite::norm(v.dataVector(buffer));
 	}
 
 private:
 
+	// After load, the data may be a read-only view of the binary companion
+	// (see BinaryStore::view) instead of data_; it is copied into data_
+	// only when written to
+
+	SizeType dataSize() const { return (view_) ? viewSize_ : data_.size(); }
+
+	const ComplexOrRealType& at(SizeType i) const
+	{
+		return (view_) ? view_[i] : data_[i];
+	}
+
+	// data_, or a copy of the view in buffer
+	const VectorType& dataVector(VectorType& buffer) const
+	{
+		if (!view_) return data_;
+		buffer.assign(view_, view_ + viewSize_);
+		return buffer;
+	}
+
+	void own()
+	{
+		if (!view_) return;
+		data_.assign(view_, view_ + viewSize_);
+		view_ = 0;
+	}
+
 	template<typename SomeBasisType>
 	SizeType findPartitionWithThisQn(SizeType qn,
 	                                 const SomeBasisType& someBasis) const
@@ -416,6 +474,8 @@ private:
 	PsimagLite::ProgressIndicator progress_;
 	SizeType size_;
 	VectorType data_;
+	const ComplexOrRealType* view_;
+	SizeType viewSize_;
 	SizeType offset_;
 	PairSizeType mAndq_; // partition
 }; // class VectorWithOffset
@@ -84,6 +84,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "ProgressIndicator.h"
 #include <cassert>
 #include "ProgramGlobals.h"
+#include "BinaryStore.h"
 
 // FIXME: a more generic solution is needed instead of tying
 // the non-zero structure to basis
@@ -100,6 +101,7 @@ public:
 	typedef typename PsimagLite::Real<ComplexOrRealType>::Type RealType;
 	typedef std::pair<SizeType,SizeType> PairSizeType;
 	typedef typename PsimagLite::Vector<ComplexOrRealType>::Type VectorType;
+	typedef std::pair<const ComplexOrRealType*, SizeType> ViewType;
 
 	VectorWithOffsets()
 	    : progress_("VectorWithOffsets"),size_(0),index2Sector_(0)
@@ -133,6 +135,7 @@ public:
 		size_ = x;
 		index2Sector_.resize(x);
 		data_.clear();
+		views_.clear();
 		offsets_.clear();
 		nzMsAndQns_.clear();
 	}
@@ -144,6 +147,7 @@ public:
 		size_ = someBasis.size();
 		nzMsAndQns_.clear();
 		data_.clear();
+		views_.clear();
 		data_.resize(v.size());
 		offsets_.resize(v.size()+1);
 		for (SizeType i=0;i<v.size();i++) {
@@ -166,6 +170,7 @@ public:
 		size_ = someBasis.size();
 		nzMsAndQns_.clear();
 		data_.clear();
+		views_.clear();
 		data_.resize(np);
 		offsets_.resize(np+1);
 		for (SizeType i=0;i<np;i++) {
@@ -192,6 +197,7 @@ public:
 		size_ = someBasis.size();
 		nzMsAndQns_.clear();
 		data_.clear();
+		views_.clear();
 		data_.resize(np);
 		offsets_.resize(np+1);
 		for (SizeType i=0;i<np;i++) {
@@ -218,6 +224,7 @@ public:
 
 	void collapseSectors()
 	{
+		own();
 		SizeType np = data_.size();
 		if (np != nzMsAndQns_.size()) {
 			PsimagLite::String str("VectorWithOffsets: collapseSectors cannot be called");
@@ -246,6 +253,7 @@ public:
 		if (i0 >= data_.size())
 			err("VectorWithOffsets: setDataInSector\n");
 
+		own();
 		data_[i0] = v;
 	}
 
@@ -274,6 +282,7 @@ public:
 		assert(offsets_[offsets_.size()-1]==size_);
 
 		data_.clear();
+		views_.clear();
 		data_.resize(someBasis.partition()-1);
 
 		nzMsAndQns_.clear();
@@ -296,7 +305,7 @@ public:
 		if (i >= data_.size())
 			err("VectorWithOffsets: extract\n");
 
-		v=data_[i];
+		v = sectorVector(v, i);
 	}
 
 	SizeType size() const { return size_; }
@@ -306,7 +315,7 @@ public:
 		if (i >= data_.size())
 			err("VectorWithOffsets: effectiveSize\n");
 
-		return data_[i].size();
+		return sectorSize(i);
 	}
 
 	SizeType offset(SizeType i) const
@@ -319,12 +328,13 @@ public:
 	const ComplexOrRealType& fastAccess(SizeType i,SizeType j) const
 	{
 		assert(i < data_.size());
-		assert(j < data_[i].size());
-		return data_[i][j];
+		assert(j < sectorSize(i));
+		return at(i, j);
 	}
 
 	ComplexOrRealType& fastAccess(SizeType i,SizeType j)
 	{
+		own();
 		assert(i < data_.size());
 		assert(j < data_[i].size());
 		return data_[i][j];
@@ -335,11 +345,12 @@ public:
 		assert(i<index2Sector_.size());
 		int j = index2Sector_[i];
 		if (j<0) return zero_;
-		return data_[j][i-offsets_[j]];
+		return at(j, i-offsets_[j]);
 	}
 
 	ComplexOrRealType& slowAccess(SizeType i)
 	{
+		own();
 		int j = index2Sector_[i];
 		if (j<0) {
 			PsimagLite::String msg("VectorWithOffsets");
@@ -359,8 +370,8 @@ public:
 		for (SizeType jj=0;jj<nzMsAndQns_.size();jj++) {
 			SizeType j =  nzMsAndQns_[jj].first;
 			assert(j < data_.size());
-			for (SizeType i=0;i<data_[j].size();i++)
-				sv[i+offsets_[j]] = data_[j][i];
+			for (SizeType i=0;i<sectorSize(j);i++)
+				sv[i+offsets_[j]] = at(j, i);
 		}
 	}
 
@@ -374,6 +385,7 @@ public:
 		s = "#nonzero="+ttos(nzMsAndQns_.size());
 		io.printline(s);
 
+		VectorType buffer;
 		for (SizeType jj=0;jj<nzMsAndQns_.size();jj++) {
 			SizeType j =  nzMsAndQns_[jj].first;
 			s="#sector="+ttos(j);
@@ -385,7 +397,7 @@ public:
 			io.printline(s);
 
 			s = "data" + ttos(jj);
-			io.printVector(data_[j], s);
+			BinaryStore::printVector(io, sectorVector(buffer, j), s);
 			j = nzMsAndQns_[jj].second;
 		}
 	}
@@ -403,6 +415,8 @@ public:
 		io.read(offsets_,"#offsets");
 		data_.clear();
 		data_.resize(offsets_.size());
+		views_.clear();
+		views_.resize(offsets_.size(), ViewType(0, 0));
 		io.readline(x,"#nonzero=");
 		if (x<0)
 			err(msg + ":load(...): nonzerosectors<0\n");
@@ -421,7 +435,7 @@ public:
 			nzMsAndQns_[jj] = PairSizeType(x, y);
 
 			PsimagLite::String s = "data" + ttos(jj);
-			io.read(data_[x], s);
+			views_[x].first = BinaryStore::view(io, data_[x], views_[x].second, s);
 		}
 
 		setIndex2Sector();
@@ -447,6 +461,8 @@ public:
 
 		data_.clear();
 		data_.resize(offsets_.size());
+		views_.clear();
+		views_.resize(offsets_.size(), ViewType(0, 0));
 
 		io.readline(x,"#nonzero=");
 		if (x < 0)
@@ -468,7 +484,7 @@ public:
 				err(msg + ":loadOneSector(...): sector too big\n");
 
 			PsimagLite::String s = "data" + ttos(jj);
-			io.read(data_[x], s);
+			views_[x].first = BinaryStore::view(io, data_[x], views_[x].second, s);
 		}
 
 		setIndex2Sector();
@@ -479,16 +495,25 @@ public:
 		if (nzMsAndQns_.size()==0) {
 			size_ = v.size_;
 			data_ = v.data_;
+			views_ = v.views_;
 			offsets_ = v.offsets_;
 			nzMsAndQns_ = v.nzMsAndQns_;
 			setIndex2Sector();
 			return *this;
 		}
 
+		own();
 		for (SizeType ii=0;ii<nzMsAndQns_.size();ii++) {
 			SizeType i = nzMsAndQns_[ii].first;
 			assert(i < data_.size());
-			data_[i] += v.data_[i];
+			if (!v.isView(i)) {
+				data_[i] += v.data_[i];
+				continue;
+			}
+
+			assert(data_[i].size() == v.sectorSize(i));
+			for (SizeType k = 0; k < data_[i].size(); ++k)
+				data_[i][k] += v.views_[i].first[k];
 		}
 
 		setIndex2Sector();
@@ -504,10 +529,11 @@ public:
 	friend RealType norm(const VectorWithOffsets& v)
 	{
 		RealType sum=0;
+		VectorType buffer;
 		for (SizeType ii=0;ii<v.nzMsAndQns_.size();ii++) {
 			SizeType i = v.nzMsAndQns_[ii].first;
 			assert(i < v.data_.size());
-			RealType tmp = PsimagLite::norm(v.data_[i]);
+			RealType tmp = PsimagLite::norm(v.sectorVector(buffer, i));
 			sum += tmp*tmp;
 		}
 
@@ -526,6 +552,7 @@ public:
 		std::cerr<<s<<" norm= "<<norma<<"\n";
 		assert(fabs(norma)>eps);
 
+		v.own();
 		for (SizeType i=0;i<v.data_.size();i++)
 			for (SizeType j=0;j<v.data_[i].size();j++)
 				v.data_[i][j] /= norma;
@@ -552,6 +579,7 @@ public:
 	                                   const VectorWithOffsets& v)
 	{
 		VectorWithOffsets w = v;
+		w.own();
 
 		for (SizeType ii = 0; ii < w.nzMsAndQns_.size(); ++ii) {
 			SizeType i = w.nzMsAndQns_[ii].first;
@@ -570,10 +598,10 @@ public:
 			err(s.c_str());
 
 		for (SizeType ii=0;ii<v1.nzMsAndQns_.size();ii++) {
-			SizeType i = v1.nzMsAndQns_[ii];
+			SizeType i = v1.nzMsAndQns_[ii].first;
 			if (i >= v1.data_.size() || i >= v2.data_.size())
 				err(s.c_str());
-			if (v1.data_[i].size()!=v2.data_[i].size())
+			if (v1.sectorSize(i) != v2.sectorSize(i))
 				err(s.c_str());
 		}
 
@@ -584,6 +612,43 @@ public:
 
 private:
 
+	// After load, sector i may be a read-only view of the binary companion
+	// (see BinaryStore::view) in views_[i] instead of data_[i]; all views
+	// are copied into data_ the first time the vector is written to
+
+	bool isView(SizeType i) const
+	{
+		return (i < views_.size() && views_[i].first != 0);
+	}
+
+	SizeType sectorSize(SizeType i) const
+	{
+		return isView(i) ? views_[i].second : data_[i].size();
+	}
+
+	const ComplexOrRealType& at(SizeType i, SizeType j) const
+	{
+		return isView(i) ? views_[i].first[j] : data_[i][j];
+	}
+
+	// data_[i], or a copy of its view in buffer
+	const VectorType& sectorVector(VectorType& buffer, SizeType i) const
+	{
+		if (!isView(i)) return data_[i];
+		buffer.assign(views_[i].first, views_[i].first + views_[i].second);
+		return buffer;
+	}
+
+	void own()
+	{
+		for (SizeType i = 0; i < views_.size(); ++i) {
+			if (!views_[i].first) continue;
+			data_[i].assign(views_[i].first, views_[i].first + views_[i].second);
+		}
+
+		views_.clear();
+	}
+
 	void setIndex2Sector()
 	{
 		if (index2Sector_.size()!=size_)
@@ -663,6 +728,7 @@ private:
 	SizeType size_;
 	typename PsimagLite::Vector<int>::Type index2Sector_;
 	typename PsimagLite::Vector<VectorType>::Type data_;
+	typename PsimagLite::Vector<ViewType>::Type views_;
 	typename PsimagLite::Vector<SizeType>::Type offsets_;
 	typename PsimagLite::Vector<PairSizeType>::Type nzMsAndQns_;
 }; // class VectorWithOffset
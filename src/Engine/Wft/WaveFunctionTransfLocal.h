@@ -87,6 +87,7 @@ DISCLOSED WOULD NOT INFRINGE PRIVATELY OWNED RIGHTS.
 #include "MatrixOrIdentity.h"
 #include "ParallelWftOne.h"
 #include "Parallelizer.h"
+#include "ThreadPool.h"
 #include "MatrixVectorKron/InitKronWft.h"
 #include "MatrixVectorKron/KronMatrix.h"
 #include "WftAccelBlocks.h"
@@ -197,7 +198,7 @@ private:
 			return transformVectorParallelPatched(psiDest, psiSrc, lrs, ii, nk, dir);
 
 		SizeType i0 = psiDest.sector(ii);
-		typedef PsimagLite::Parallelizer<ParallelWftType> ParallelizerType;
+		typedef ParallelizerPool<ParallelWftType> ParallelizerType;
 		ParallelizerType threadedWft(PsimagLite::Concurrency::npthreads,
 		                             PsimagLite::MPI::COMM_WORLD);
 
@@ -261,7 +262,7 @@ private:
 		        lrs.left().block().size() > 1)
 			return wftAccelBlocks_.environFromInfinite(psiDest, i0, psiSrc, iOld, lrs, nk);
 
-		typedef PsimagLite::Parallelizer<WftSparseTwoSiteType> ParallelizerType;
+		typedef ParallelizerPool<WftSparseTwoSiteType> ParallelizerType;
 
 		SparseMatrixType ws;
 		dmrgWaveStruct_.ws.toSparse(ws);
@@ -308,7 +309,7 @@ private:
 	                                  const LeftRightSuperType& lrs,
 	                                  const VectorSizeType& nk) const
 	{
-		typedef PsimagLite::Parallelizer<WftSparseTwoSiteType> ParallelizerType;
+		typedef ParallelizerPool<WftSparseTwoSiteType> ParallelizerType;
 
 		PsimagLite::OstringStream msg;
 		msg<<" Destination sectors "<<psiDest.sectors();
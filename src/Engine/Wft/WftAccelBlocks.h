@@ -3,6 +3,8 @@
 #include "Matrix.h"
 #include "BLAS.h"
 #include "ProgramGlobals.h"
+#include "ThreadPool.h"
+#include "Arena.h"
 
 namespace Dmrg {
 
@@ -19,126 +21,158 @@ class WftAccelBlocks {
 	typedef typename DmrgWaveStructType::BasisWithOperatorsType BasisWithOperatorsType;
 	typedef typename BasisWithOperatorsType::SparseMatrixType SparseMatrixType;
 	typedef PsimagLite::Matrix<ComplexOrRealType> MatrixType;
+	typedef Arena<ComplexOrRealType> ArenaType;
 	typedef typename PsimagLite::Vector<MatrixType>::Type VectorMatrixType;
 	typedef typename WaveFunctionTransfBaseType::PackIndicesType PackIndicesType;
+	typedef typename DmrgWaveStructType::BlockDiagonalMatrixType BlockDiagonalMatrixType;
 
+	// One task per local state kp and per pair of symmetry blocks (a of ws,
+	// b of we) that psi connects; blocks of psi that are zero are never
+	// touched and each task writes its own (a, b) tile of result[kp]
 	class ParallelWftInBlocks {
 
 	public:
 
 		ParallelWftInBlocks(VectorMatrixType& result,
 		                    const VectorMatrixType& psi,
-		                    const MatrixType& ws,
-		                    const MatrixType& we,
-		                    SizeType volumeOfNk,
+		                    const BlockDiagonalMatrixType& ws,
+		                    const BlockDiagonalMatrixType& we,
+		                    const VectorSizeType& tasks,
 		                    SizeType sysOrEnv)
 		    : result_(result),
 		      psi_(psi),
 		      ws_(ws),
 		      we_(we),
-		      volumeOfNk_(volumeOfNk),
+		      tasks_(tasks),
 		      sysOrEnv_(sysOrEnv)
-		{}
+		{
+			assert(tasks_.size()%3 == 0);
+		}
+
+		SizeType tasks() const { return tasks_.size()/3; }
 
-		SizeType tasks() const { return volumeOfNk_; }
+		VectorSizeType weights() const
+		{
+			SizeType n = tasks();
+			VectorSizeType w(n);
+			for (SizeType i = 0; i < n; ++i) {
+				const MatrixType& wsa = ws_(tasks_[3*i + 1]);
+				const MatrixType& web = we_(tasks_[3*i + 2]);
+				w[i] = wsa.rows()*wsa.cols()*(web.rows() + web.cols());
+			}
+
+			return w;
+		}
 
-		void doTask(SizeType kp, SizeType)
+		void doTask(SizeType taskNumber, SizeType)
 		{
+			SizeType kp = tasks_[3*taskNumber];
+			SizeType a = tasks_[3*taskNumber + 1];
+			SizeType b = tasks_[3*taskNumber + 2];
+
 			if (sysOrEnv_ == ProgramGlobals::SYSTEM)
-				return doTaskSystem(kp);
+				return doTaskSystem(kp, a, b);
 
-			doTaskEnviron(kp);
+			doTaskEnviron(kp, a, b);
 		}
 
 	private:
 
-		void doTaskEnviron(SizeType kp)
+		// result[kp](ip, jp) = sum ws(ip, i2p) psi[kp](i2p, jp2) we(jp2, jp)
+		void doTaskEnviron(SizeType kp, SizeType a, SizeType b)
 		{
-			SizeType ipsize = ws_.rows();
-			SizeType i2psize = ws_.cols();
-			SizeType jp2size = we_.rows();
-			SizeType jpsize = we_.cols();
-			MatrixType tmp(i2psize, jpsize);
-
-			result_[kp].resize(ipsize, jpsize);
-			result_[kp].setTo(0.0);
-			tmp.setTo(0.0);
+			const MatrixType& wsa = ws_(a);
+			const MatrixType& web = we_(b);
+			SizeType ipOffset = ws_.offsetsRows(a);
+			SizeType i2pOffset = ws_.offsetsCols(a);
+			SizeType jp2Offset = we_.offsetsRows(b);
+			SizeType jpOffset = we_.offsetsCols(b);
+			const MatrixType& psi = psi_[kp];
+			MatrixType& result = result_[kp];
+
+			// tmp is wsa.cols() x web.cols(), fully overwritten by the first GEMM
+			typename ArenaType::Buffer tmpBuffer(wsa.cols()*web.cols());
+			typename ArenaType::VectorType& tmp = tmpBuffer();
 
 			psimag::BLAS::GEMM('N',
 			                   'N',
-			                   i2psize,
-			                   jpsize,
-			                   jp2size,
+			                   wsa.cols(),
+			                   web.cols(),
+			                   web.rows(),
 			                   1.0,
-			                   &((psi_[kp])(0,0)),
-			                   i2psize,
-			                   &(we_(0,0)),
-			                   jp2size,
+			                   &(psi(i2pOffset, jp2Offset)),
+			                   psi.rows(),
+			                   &(web(0,0)),
+			                   web.rows(),
 			                   0.0,
-			                   &(tmp(0,0)),
-			                   i2psize);
+			                   &(tmp[0]),
+			                   wsa.cols());
 
 			psimag::BLAS::GEMM('N',
 			                   'N',
-			                   ipsize,
-			                   jpsize,
-			                   i2psize,
+			                   wsa.rows(),
+			                   web.cols(),
+			                   wsa.cols(),
 			                   1.0,
-			                   &(ws_(0,0)),
-			                   ipsize,
-			                   &(tmp(0,0)),
-			                   i2psize,
+			                   &(wsa(0,0)),
+			                   wsa.rows(),
+			                   &(tmp[0]),
+			                   wsa.cols(),
 			                   0.0,
-			                   &((result_[kp])(0,0)),
-			                   ipsize);
+			                   &(result(ipOffset, jpOffset)),
+			                   result.rows());
 		}
 
-		void doTaskSystem(SizeType kp)
+		// result[kp](is, jen) = sum ws(ip, is)^* psi[kp](ip, jpr) we(jen, jpr)^*
+		void doTaskSystem(SizeType kp, SizeType a, SizeType b)
 		{
-			SizeType ipSize = ws_.rows();
-			SizeType isSize = ws_.cols();
-			SizeType jenSize = we_.rows();
-			SizeType jprSize = we_.cols();
-			MatrixType tmp(ipSize, jenSize);
-
-			result_[kp].resize(isSize, jenSize);
-			result_[kp].setTo(0.0);
-			tmp.setTo(0.0);
+			const MatrixType& wsa = ws_(a);
+			const MatrixType& web = we_(b);
+			SizeType ipOffset = ws_.offsetsRows(a);
+			SizeType isOffset = ws_.offsetsCols(a);
+			SizeType jenOffset = we_.offsetsRows(b);
+			SizeType jprOffset = we_.offsetsCols(b);
+			const MatrixType& psi = psi_[kp];
+			MatrixType& result = result_[kp];
+
+			// tmp is wsa.rows() x web.rows(), fully overwritten by the first GEMM
+			typename ArenaType::Buffer tmpBuffer(wsa.rows()*web.rows());
+			typename ArenaType::VectorType& tmp = tmpBuffer();
 
 			psimag::BLAS::GEMM('N',
 			                   'C',
-			                   ipSize,
-			                   jenSize,
-			                   jprSize,
+			                   wsa.rows(),
+			                   web.rows(),
+			                   web.cols(),
 			                   1.0,
-			                   &((psi_[kp])(0,0)),
-			                   ipSize,
-			                   &(we_(0,0)),
-			                   jenSize,
+			                   &(psi(ipOffset, jprOffset)),
+			                   psi.rows(),
+			                   &(web(0,0)),
+			                   web.rows(),
 			                   0.0,
-			                   &(tmp(0,0)),
-			                   ipSize);
+			                   &(tmp[0]),
+			                   wsa.rows());
 
 			psimag::BLAS::GEMM('C',
 			                   'N',
-			                   isSize,
-			                   jenSize,
-			                   ipSize,
+			                   wsa.cols(),
+			                   web.rows(),
+			                   wsa.rows(),
 			                   1.0,
-			                   &(ws_(0,0)),
-			                   ipSize,
-			                   &(tmp(0,0)),
-			                   ipSize,
+			                   &(wsa(0,0)),
+			                   wsa.rows(),
+			                   &(tmp[0]),
+			                   wsa.rows(),
 			                   0.0,
-			                   &((result_[kp])(0,0)),
-			                   isSize);
+			                   &(result(isOffset, jenOffset)),
+			                   result.rows());
 		}
 
 		VectorMatrixType& result_;
 		const VectorMatrixType& psi_;
-		const MatrixType& ws_;
-		const MatrixType& we_;
-		SizeType volumeOfNk_;
+		const BlockDiagonalMatrixType& ws_;
+		const BlockDiagonalMatrixType& we_;
+		const VectorSizeType& tasks_;
 		SizeType sysOrEnv_;
 	};
 
@@ -160,32 +194,36 @@ public:
 			err("Bounce!?\n");
 
 		SizeType volumeOfNk = DmrgWaveStructType::volumeOf(nk);
-		MatrixType ws;
-		dmrgWaveStruct_.ws.toDense(ws);
-
-		MatrixType we;
-		dmrgWaveStruct_.we.toDense(we);
+		const BlockDiagonalMatrixType& ws = dmrgWaveStruct_.ws;
+		const BlockDiagonalMatrixType& we = dmrgWaveStruct_.we;
 
 		SizeType i2psize = ws.cols();
 		SizeType jp2size = we.rows();
 
 		VectorMatrixType psi(volumeOfNk);
+		VectorMatrixType result(volumeOfNk);
 		for (SizeType kp = 0; kp < volumeOfNk; ++kp) {
 			psi[kp].resize(i2psize, jp2size);
 			psi[kp].setTo(0.0);
+			result[kp].resize(ws.rows(), we.cols());
+			result[kp].setTo(0.0);
 		}
 
-		environPreparePsi(psi, psiSrc, i0src, volumeOfNk);
-
-		VectorMatrixType result(volumeOfNk);
+		VectorSizeType blockOfCol;
+		blockIndices(blockOfCol, ws, false);
+		VectorSizeType blockOfRow;
+		blockIndices(blockOfRow, we, true);
+		VectorSizeType tasks;
+		environPreparePsi(psi, tasks, psiSrc, i0src, volumeOfNk, blockOfCol, blockOfRow);
 
-		SizeType threads = std::min(volumeOfNk, PsimagLite::Concurrency::npthreads);
-		typedef PsimagLite::Parallelizer<ParallelWftInBlocks> ParallelizerType;
-		ParallelizerType threadedWft(threads, PsimagLite::MPI::COMM_WORLD);
+		SizeType threads = std::min(tasks.size()/3, PsimagLite::Concurrency::npthreads);
+		if (threads == 0) threads = 1;
+		typedef ParallelizerThreads<ParallelWftInBlocks> ParallelizerType;
+		ParallelizerType threadedWft(threads);
 
-		ParallelWftInBlocks helperWft(result, psi, ws, we, volumeOfNk, ProgramGlobals::ENVIRON);
+		ParallelWftInBlocks helperWft(result, psi, ws, we, tasks, ProgramGlobals::ENVIRON);
 
-		threadedWft.loopCreate(helperWft);
+		threadedWft.loopCreate(helperWft, helperWft.weights());
 
 		environCopyOut(psiDest, i0, result, lrs, volumeOfNk);
 	}
@@ -201,32 +239,36 @@ public:
 			err("Bounce!?\n");
 
 		SizeType volumeOfNk = DmrgWaveStructType::volumeOf(nk);
-		MatrixType ws;
-		dmrgWaveStruct_.ws.toDense(ws);
-
-		MatrixType we;
-		dmrgWaveStruct_.we.toDense(we);
+		const BlockDiagonalMatrixType& ws = dmrgWaveStruct_.ws;
+		const BlockDiagonalMatrixType& we = dmrgWaveStruct_.we;
 
 		SizeType ipSize = ws.rows();
 		SizeType jprSize = we.cols();
 
 		VectorMatrixType psi(volumeOfNk);
+		VectorMatrixType result(volumeOfNk);
 		for (SizeType kp = 0; kp < volumeOfNk; ++kp) {
 			psi[kp].resize(ipSize, jprSize);
 			psi[kp].setTo(0.0);
+			result[kp].resize(ws.cols(), we.rows());
+			result[kp].setTo(0.0);
 		}
 
-		systemPreparePsi(psi, psiSrc, i0src, volumeOfNk);
-
-		VectorMatrixType result(volumeOfNk);
+		VectorSizeType blockOfRow;
+		blockIndices(blockOfRow, ws, true);
+		VectorSizeType blockOfCol;
+		blockIndices(blockOfCol, we, false);
+		VectorSizeType tasks;
+		systemPreparePsi(psi, tasks, psiSrc, i0src, volumeOfNk, blockOfRow, blockOfCol);
 
-		SizeType threads = std::min(volumeOfNk, PsimagLite::Concurrency::npthreads);
-		typedef PsimagLite::Parallelizer<ParallelWftInBlocks> ParallelizerType;
-		ParallelizerType threadedWft(threads, PsimagLite::MPI::COMM_WORLD);
+		SizeType threads = std::min(tasks.size()/3, PsimagLite::Concurrency::npthreads);
+		if (threads == 0) threads = 1;
+		typedef ParallelizerThreads<ParallelWftInBlocks> ParallelizerType;
+		ParallelizerType threadedWft(threads);
 
-		ParallelWftInBlocks helperWft(result, psi, ws, we, volumeOfNk, ProgramGlobals::SYSTEM);
+		ParallelWftInBlocks helperWft(result, psi, ws, we, tasks, ProgramGlobals::SYSTEM);
 
-		threadedWft.loopCreate(helperWft);
+		threadedWft.loopCreate(helperWft, helperWft.weights());
 
 		systemCopyOut(psiDest, i0, result, lrs, volumeOfNk);
 	}
@@ -234,14 +276,20 @@ public:
 private:
 
 	void environPreparePsi(VectorMatrixType& psi,
+	                       VectorSizeType& tasks,
 	                       const VectorWithOffsetType& psiSrc,
 	                       SizeType i0src,
-	                       SizeType volumeOfNk) const
+	                       SizeType volumeOfNk,
+	                       const VectorSizeType& blockOfI2p,
+	                       const VectorSizeType& blockOfJp2) const
 	{
 		SizeType total = psiSrc.effectiveSize(i0src);
 		SizeType offset = psiSrc.offset(i0src);
 		PackIndicesType packSuper(dmrgWaveStruct_.lrs.left().size());
 		PackIndicesType packLeft(dmrgWaveStruct_.lrs.left().size()/volumeOfNk);
+		SizeType blocksA = dmrgWaveStruct_.ws.blocks();
+		SizeType blocksB = dmrgWaveStruct_.we.blocks();
+		VectorSizeType seen(volumeOfNk*blocksA*blocksB, 0);
 
 		for (SizeType x = 0; x < total; ++x) {
 			SizeType alpha = 0;
@@ -251,6 +299,7 @@ private:
 			SizeType kp = 0;
 			packLeft.unpack(ip2, kp, dmrgWaveStruct_.lrs.left().permutation(alpha));
 			psi[kp](ip2, jp2) += psiSrc.fastAccess(i0src, x);
+			markTask(tasks, seen, kp, blockOfI2p[ip2], blockOfJp2[jp2], blocksA, blocksB);
 		}
 	}
 
@@ -279,14 +328,20 @@ private:
 	}
 
 	void systemPreparePsi(VectorMatrixType& psi,
+	                      VectorSizeType& tasks,
 	                      const VectorWithOffsetType& psiSrc,
 	                      SizeType i0src,
-	                      SizeType volumeOfNk) const
+	                      SizeType volumeOfNk,
+	                      const VectorSizeType& blockOfIp,
+	                      const VectorSizeType& blockOfJpr) const
 	{
 		SizeType total = psiSrc.effectiveSize(i0src);
 		SizeType offset = psiSrc.offset(i0src);
 		PackIndicesType packSuper(dmrgWaveStruct_.lrs.left().size());
 		PackIndicesType packRight(volumeOfNk);
+		SizeType blocksA = dmrgWaveStruct_.ws.blocks();
+		SizeType blocksB = dmrgWaveStruct_.we.blocks();
+		VectorSizeType seen(volumeOfNk*blocksA*blocksB, 0);
 
 		for (SizeType y = 0; y < total; ++y) {
 			SizeType ip = 0;
@@ -296,6 +351,7 @@ private:
 			SizeType jpr = 0;
 			packRight.unpack(jpl, jpr, dmrgWaveStruct_.lrs.right().permutation(jp));
 			psi[jpl](ip, jpr) = psiSrc.fastAccess(i0src, y);
+			markTask(tasks, seen, jpl, blockOfIp[ip], blockOfJpr[jpr], blocksA, blocksB);
 		}
 	}
 
@@ -323,6 +379,43 @@ private:
 		}
 	}
 
+	// blockOf[i] is the block of m that row (or column) i belongs to,
+	// or m.blocks() if no block holds it (it then only meets zeros)
+	static void blockIndices(VectorSizeType& blockOf,
+	                         const BlockDiagonalMatrixType& m,
+	                         bool rows)
+	{
+		SizeType n = (rows) ? m.rows() : m.cols();
+		SizeType blocks = m.blocks();
+		blockOf.resize(n);
+		std::fill(blockOf.begin(), blockOf.end(), blocks);
+		for (SizeType k = 0; k < blocks; ++k) {
+			if (m(k).rows() == 0 || m(k).cols() == 0) continue;
+			SizeType start = (rows) ? m.offsetsRows(k) : m.offsetsCols(k);
+			SizeType size = (rows) ? m(k).rows() : m(k).cols();
+			for (SizeType i = start; i < start + size && i < n; ++i)
+				blockOf[i] = k;
+		}
+	}
+
+	static void markTask(VectorSizeType& tasks,
+	                     VectorSizeType& seen,
+	                     SizeType kp,
+	                     SizeType a,
+	                     SizeType b,
+	                     SizeType blocksA,
+	                     SizeType blocksB)
+	{
+		if (a >= blocksA || b >= blocksB) return;
+		SizeType index = a + b*blocksA + kp*blocksA*blocksB;
+		assert(index < seen.size());
+		if (seen[index]) return;
+		seen[index] = 1;
+		tasks.push_back(kp);
+		tasks.push_back(a);
+		tasks.push_back(b);
+	}
+
 	const DmrgWaveStructType& dmrgWaveStruct_;
 	const WftOptionsType& wftOptions_;
 };
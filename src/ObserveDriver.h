@@ -51,6 +51,7 @@ typedef ParametersDmrgSolver<RealType,InputNgType::Readable> ParametersDmrgSolve
 template<typename VectorWithOffsetType,
          typename ModelType>
 bool observeOneFullSweep(IoInputType& io,
+                         const SerializerIndex& index,
                          const ModelType& model,
                          const PsimagLite::String& list,
                          bool hasTimeEvolution,
@@ -7,6 +7,7 @@ namespace Dmrg {
 template<typename VectorWithOffsetType,
          typename ModelType>
 bool observeOneFullSweep(IoInputType& io,
+                         const SerializerIndex& index,
                          const ModelType& model,
                          const PsimagLite::String& list,
                          bool hasTimeEvolution,
@@ -23,6 +24,7 @@ bool observeOneFullSweep(IoInputType& io,
 	SizeType cols = n;
 	SizeType nf = n - 2;
 	SizeType trail = 0;
+	SizeType cacheSize = 0;
 
 	PsimagLite::Vector<PsimagLite::String>::Type vecOptions;
 	PsimagLite::split(vecOptions, list, ",");
@@ -49,6 +51,13 @@ bool observeOneFullSweep(IoInputType& io,
 			hasTrail = true;
 		}
 
+		label = "%cache=";
+		labelIndex = item.find(label);
+		if (labelIndex == 0) {
+			cacheSize = atoi(item.substr(label.length()).c_str());
+			std::cerr<<"observe: Found "<<label<<" = "<<cacheSize<<"\n";
+		}
+
 		label = "%rows=";
 		labelIndex = item.find(label);
 		if (labelIndex == 0) {
@@ -68,12 +77,14 @@ bool observeOneFullSweep(IoInputType& io,
 		trail = n - 2 - nf;
 
 	ObservableLibraryType observerLib(io,
+	                                  index,
 	                                  n,
 	                                  hasTimeEvolution,
 	                                  model,
 	                                  nf,
 	                                  trail,
-	                                  verbose);
+	                                  verbose,
+	                                  cacheSize);
 
 	for (SizeType i = 0; i < vecOptions.size(); ++i) {
 		PsimagLite::String item = vecOptions[i];
@@ -30,18 +30,21 @@ InputNgType::Readable,
 Geometry1Type> ModelBase6Type;
 
 template bool observeOneFullSweep<VectorWithOffset2Type,ModelBase5Type>(IoInputType& io,
+const SerializerIndex& index,
 const ModelBase5Type& model,
 const PsimagLite::String& list,
 bool hasTimeEvolution,
 SizeType orbitals);
 
 template bool observeOneFullSweep<VectorWithOffset4Type,ModelBase5Type>(IoInputType& io,
+const SerializerIndex& index,
 const ModelBase5Type& model,
 const PsimagLite::String& list,
 bool hasTimeEvolution,
 SizeType orbitals);
 
 template bool observeOneFullSweep<VectorWithOffset4Type,ModelBase6Type>(IoInputType& io,
+const SerializerIndex& index,
 const ModelBase6Type& model,
 const PsimagLite::String& list,
 bool hasTimeEvolution,
@@ -5,6 +5,9 @@
 #include "RegisterSignals.h"
 #include "ArchiveFiles.h"
 #include "DmrgDriver.h"
+#include "Cloner.h"
+#include "LineChangerLinear.h"
+#include "ThreadPool.h"
 
 typedef PsimagLite::Vector<PsimagLite::String>::Type VectorStringType;
 typedef  PsimagLite::CrsMatrix<std::complex<RealType> > MySparseMatrixComplex;
@@ -111,9 +114,6 @@ void mainLoop1(GeometryType& geometry,
 		                                              opOptions,
 		                                              targeting);
 	} else if (dmrgSolverParams.options.find("MatrixVectorKron")!=PsimagLite::String::npos) {
-		if (ModelHelperType::isSu2())
-			throw PsimagLite::RuntimeError("MatrixVectorKron does not support SU(2)\n");
-
 		mainLoop2<MatrixVectorKron<ModelBaseType> >(geometry,
 		                                            dmrgSolverParams,
 		                                            io,
@@ -182,6 +182,146 @@ void mainLoop0(InputNgType::Readable& io,
 	                                                                        targeting);
 }
 
+void runOneInput(const PsimagLite::String& filename,
+                 InputCheck& inputCheck,
+                 const PsimagLite::String& sOptions,
+                 const PsimagLite::String& insitu,
+                 const OperatorOptions& options,
+                 bool keepFiles)
+{
+	typedef PsimagLite::Concurrency ConcurrencyType;
+
+	InputNgType::Writeable ioWriteable(filename,inputCheck);
+	InputNgType::Readable io(ioWriteable);
+
+	ParametersDmrgSolverType dmrgSolverParams(io, sOptions, false);
+
+	ArchiveFilesType af(dmrgSolverParams,filename,options.enabled,options.label);
+
+	if (insitu!="") dmrgSolverParams.insitu = insitu;
+	if (dmrgSolverParams.options.find("minimizeDisk") != PsimagLite::String::npos)
+		dmrgSolverParams.options += ",noSaveWft,noSaveStacks,noSaveData";
+
+	bool setAffinities = (dmrgSolverParams.options.find("setAffinities")
+	                      != PsimagLite::String::npos);
+	ConcurrencyType::setOptions(dmrgSolverParams.nthreads, setAffinities);
+	Dmrg::ThreadPool::instance().pinThreads(setAffinities);
+
+	PsimagLite::String targeting = inputCheck.getTargeting(dmrgSolverParams.options);
+
+	if (targeting != "CorrectionTargetting" &&
+	        targeting != "GroundStateTargetting" &&
+	        dmrgSolverParams.options.find("wftInBlocks") != PsimagLite::String::npos)
+		err("wftInBlocks only for GroundStateTargetting or CorrectionTargetting\n");
+
+	bool isComplex = (dmrgSolverParams.options.find("useComplex") != PsimagLite::String::npos);
+	if (targeting=="TimeStepTargetting") isComplex = true;
+	if (isComplex) {
+		mainLoop0<MySparseMatrixComplex, CvectorSizeType>(io,dmrgSolverParams,targeting,options);
+	} else {
+		mainLoop0<MySparseMatrixReal, CvectorSizeType>(io,dmrgSolverParams,targeting,options);
+	}
+
+	if (options.enabled) return;
+
+	af.deletePackedFiles();
+	if (!keepFiles)
+		ArchiveFilesType::staticDelete();
+}
+
+/* In-process parameter scan, see PSIDOC DmrgDriver below.
+   Point i runs a copy of the input where Label= is begin + i*step and
+   OutputFile= gets the suffix Scan<i>. All points run in this process */
+class ParameterScan {
+
+	typedef LineChangerLinear<RealType> LineChangerType;
+	typedef Cloner<LineChangerType> ClonerType;
+
+public:
+
+	ParameterScan()
+	    : begin_(0.0),step_(0.0),points_(0),index_(0),total_(1)
+	{}
+
+	bool enabled() const { return (points_ > 0); }
+
+	// Label=,begin,step,points
+	void set(PsimagLite::String spec)
+	{
+		VectorStringType tokens;
+		PsimagLite::split(tokens, spec, ",");
+		if (tokens.size() != 4)
+			err("-S expects Label=,begin,step,points\n");
+
+		label_ = tokens[0];
+		begin_ = atof(tokens[1].c_str());
+		step_ = atof(tokens[2].c_str());
+		points_ = atoi(tokens[3].c_str());
+	}
+
+	// index/total
+	void setJob(PsimagLite::String job)
+	{
+		VectorStringType tokens;
+		PsimagLite::split(tokens, job, "/");
+		if (tokens.size() != 2)
+			err("-j expects index/total\n");
+
+		index_ = atoi(tokens[0].c_str());
+		total_ = atoi(tokens[1].c_str());
+		if (total_ == 0 || index_ >= total_)
+			err("-j expects index/total with index < total\n");
+	}
+
+	void operator()(const PsimagLite::String& filename,
+	                InputCheck& inputCheck,
+	                const PsimagLite::String& sOptions,
+	                const PsimagLite::String& insitu,
+	                const OperatorOptions& options,
+	                bool keepFiles) const
+	{
+		PsimagLite::String outputFile;
+		{
+			InputNgType::Writeable ioWriteable(filename,inputCheck);
+			InputNgType::Readable io(ioWriteable);
+			io.readline(outputFile,"OutputFile=");
+		}
+
+		PsimagLite::String root = filename;
+		size_t dot = root.rfind(".inp");
+		if (dot != PsimagLite::String::npos) root = root.substr(0,dot);
+		root += "Scan";
+
+		ClonerType cloner(filename,root,".inp");
+		LineChangerType lcl1(label_,step_,begin_,"","");
+		cloner.push(lcl1);
+		LineChangerType lcl2("OutputFile=",1.0,0.0,outputFile + "Scan","");
+		cloner.push(lcl2);
+
+		// Files unpacked for a restart, for example from the -g run,
+		// are unpacked by the first point and kept until the scan ends
+		for (SizeType i = index_; i < points_; i += total_) {
+			PsimagLite::String pointFile = cloner.createInputFile(i);
+			std::cout<<"ParameterScan: point "<<i<<" "<<label_;
+			std::cout<<(begin_ + i*step_)<<" input "<<pointFile<<"\n";
+			runOneInput(pointFile,inputCheck,sOptions,insitu,options,true);
+			if (!keepFiles) unlink(pointFile.c_str());
+		}
+
+		if (!keepFiles && !options.enabled)
+			ArchiveFilesType::staticDelete();
+	}
+
+private:
+
+	PsimagLite::String label_;
+	RealType begin_;
+	RealType step_;
+	SizeType points_;
+	SizeType index_;
+	SizeType total_;
+};
+
 int main(int argc, char *argv[])
 {
 	PsimagLite::PsiApp application("DMRG++",&argc,&argv,1);
@@ -192,8 +332,12 @@ int main(int argc, char *argv[])
 	OperatorOptions options;
 	PsimagLite::String strUsage(application.name());
 	if (utils::basename(argv[0]) == "operator") options.enabled = true;
-	strUsage += " -f filename [-k] [-p precision] [-o solverOptions] [-V] [whatToMeasure]";
+	strUsage += " -f filename [-k] [-p precision] [-o solverOptions] [-V]";
+	strUsage += " [-S Label=,begin,step,points [-g groundStateInput] [-j index/total]]";
+	strUsage += " [whatToMeasure]";
 	PsimagLite::String sOptions("");
+	PsimagLite::String groundStateFile("");
+	ParameterScan scan;
 	int precision = 6;
 	bool keepFiles = false;
 	bool versionOnly = false;
@@ -219,6 +363,24 @@ to the main dmrg driver are the following.
 	  In other cases, string is the name of the file to redirect std::cout to.
 	 \item[-k] [Optional] Keep untar files
 	 \item[-V] [Optional] Print version and exit
+	 \item[-S] [Optional, String] Parameter scan, Label=,begin,step,points.
+	 Point $i$ runs in this process a copy of the input, written to
+	 inputScan$i$.inp, where the line Label= has the value begin$+i\,$step,
+	 and OutputFile= has the suffix Scan$i$. The input is read once;
+	 each point is then parsed and built anew, because Label= may change
+	 the model or the geometry. Point inputs are deleted after their
+	 run unless -k is given. This replaces scripts
+	 that clone the input and start one dmrg per point.
+	 \item[-g] [Optional, String] Only with -S. Input run once before the
+	 scan, for example the ground state. Scan inputs with
+	 SolverOptions=restart and CheckpointFilename= set to its
+	 OutputFile= then start from it instead of redoing it. Its files are
+	 unpacked once for the whole scan, and with SolverOptions=binaryData
+	 the saved vectors are mapped once and shared by all points.
+	 \item[-j] [Optional, String] Only with -S, index/total. Run only the
+	 points $i$ with $i$ modulo total equal to index. Each process runs
+	 its points one after the other, so that several dmrg processes,
+	 started separately, share a scan.
 	  \end{itemize}
 	 */
 	/* PSIDOC OperatorDriver
@@ -256,7 +418,7 @@ to the main dmrg driver are the following.
 	\begin{verbatim}./operator -l c -t -f input.inp\end{verbatim}
 	\end{itemize}
 	 */
-	while ((opt = getopt(argc, argv,"f:s:l:d:p:e:o:tkV")) != -1) {
+	while ((opt = getopt(argc, argv,"f:s:l:d:p:e:o:S:g:j:tkV")) != -1) {
 		switch (opt) {
 		case 'f':
 			filename = optarg;
@@ -288,6 +450,15 @@ to the main dmrg driver are the following.
 		case 'o':
 			sOptions += optarg;
 			break;
+		case 'S':
+			scan.set(optarg);
+			break;
+		case 'g':
+			groundStateFile = optarg;
+			break;
+		case 'j':
+			scan.setJob(optarg);
+			break;
 		case 'V':
 			versionOnly = true;
 			options.label = "-";
@@ -304,6 +475,13 @@ to the main dmrg driver are the following.
 		return 1;
 	}
 
+	// the ground state of -g is the starting point of a scan only
+	if (groundStateFile != "" && !scan.enabled()) {
+		std::cerr<<argv[0]<<": -g needs -S\n";
+		inputCheck.usageMain(strUsage);
+		return 1;
+	}
+
 	PsimagLite::String insitu = (optind < argc) ? argv[optind] : "";
 
 	if (!options.enabled && options.label != "-") {
@@ -343,42 +521,16 @@ to the main dmrg driver are the following.
 
 	if (versionOnly) return 0;
 
-	InputNgType::Writeable ioWriteable(filename,inputCheck);
-	InputNgType::Readable io(ioWriteable);
-
-	ParametersDmrgSolverType dmrgSolverParams(io, sOptions, false);
-
-	ArchiveFilesType af(dmrgSolverParams,filename,options.enabled,options.label);
-
-	if (insitu!="") dmrgSolverParams.insitu = insitu;
-	if (dmrgSolverParams.options.find("minimizeDisk") != PsimagLite::String::npos)
-		dmrgSolverParams.options += ",noSaveWft,noSaveStacks,noSaveData";
-
-	bool setAffinities = (dmrgSolverParams.options.find("setAffinities")
-	                      != PsimagLite::String::npos);
-	ConcurrencyType::setOptions(dmrgSolverParams.nthreads, setAffinities);
-
 	registerSignals();
 
-	PsimagLite::String targeting = inputCheck.getTargeting(dmrgSolverParams.options);
-
-	if (targeting != "CorrectionTargetting" &&
-	        targeting != "GroundStateTargetting" &&
-	        dmrgSolverParams.options.find("wftInBlocks") != PsimagLite::String::npos)
-		err("wftInBlocks only for GroundStateTargetting or CorrectionTargetting\n");
+	if (groundStateFile != "")
+		runOneInput(groundStateFile,inputCheck,sOptions,insitu,options,keepFiles);
 
-	bool isComplex = (dmrgSolverParams.options.find("useComplex") != PsimagLite::String::npos);
-	if (targeting=="TimeStepTargetting") isComplex = true;
-	if (isComplex) {
-		mainLoop0<MySparseMatrixComplex, CvectorSizeType>(io,dmrgSolverParams,targeting,options);
-	} else {
-		mainLoop0<MySparseMatrixReal, CvectorSizeType>(io,dmrgSolverParams,targeting,options);
+	if (!scan.enabled()) {
+		runOneInput(filename,inputCheck,sOptions,insitu,options,keepFiles);
+		return 0;
 	}
 
-	if (options.enabled) return 0;
-
-	af.deletePackedFiles();
-	if (!keepFiles)
-		ArchiveFilesType::staticDelete();
+	scan(filename,inputCheck,sOptions,insitu,options,keepFiles);
 }
 
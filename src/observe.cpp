@@ -28,13 +28,15 @@ void mainLoop(GeometryType& geometry,
 	const PsimagLite::String& datafile = params.filename;
 	ArchiveFiles<ParametersDmrgSolverType>::unpackIfNeeded(datafile);
 	IoInputType dataIo(datafile);
+	// scanned once, and shared by the sweeps below
+	SerializerIndex index(datafile);
 	bool hasTimeEvolution = (targetting != "GroundStateTargetting" &&
 	        targetting != "CorrectionTargetting");
 
 	while (moreData) {
 		try {
 			moreData = !observeOneFullSweep<VectorWithOffsetType,ModelBaseType>
-			        (dataIo,model,list,hasTimeEvolution,orbitals);
+			        (dataIo,index,model,list,hasTimeEvolution,orbitals);
 		} catch (std::exception& e) {
 			std::cerr<<"CAUGHT: "<<e.what();
 			std::cerr<<"There's no more data\n";